@@ -0,0 +1,16 @@
+#include <LEDBakedPlayer.h>
+#include "YardOfficeShow.h"
+
+//show recorded from the Yard_Office lights with
+//Tools/HostSimulator/build/bake --layout yard_office --seed 1 --minutes 60 --name yardOfficeShow > YardOfficeShow.h
+LEDBakedPlayer * player;
+
+void setup() {
+  // put your setup code here, to run once:
+  player = new LEDBakedPlayer(yardOfficeShowChannels, YARDOFFICESHOW_CHANNEL_COUNT, YARDOFFICESHOW_FRAME_MS);
+}
+
+void loop() {
+  // put your main code here, to run repeatedly:
+  player->execute();
+}
@@ -0,0 +1,78 @@
+/*
+  Baked show generated by Tools/HostSimulator/bake
+  layout yard_office, seed 1, 180000 frames of 20 ms, 576 bytes
+*/
+#ifndef YARDOFFICESHOW_H
+#define YARDOFFICESHOW_H
+
+#include <LEDBakedPlayer.h>
+
+#define YARDOFFICESHOW_FRAME_MS 20
+#define YARDOFFICESHOW_CHANNEL_COUNT 6
+
+const unsigned char yardOfficeShowStream0[] PROGMEM = {
+  0xC0, 0x00, 0xC0, 0xFF, 0xBF, 0xFF, 0xBF, 0xFF, 0xBF, 0xFF, 0xBF, 0xFF, 0xBF, 0xFF, 0xBF, 0xFF,
+  0xBF, 0xFF, 0xBF, 0xFF, 0xBF, 0xFF, 0xBF, 0xFF, 0xBF, 0x1D
+};
+
+const unsigned char yardOfficeShowStream1[] PROGMEM = {
+  0xC0, 0x00, 0xC0, 0xFF, 0xBF, 0xFF, 0xBF, 0xFF, 0xBF, 0xFF, 0xBF, 0xFF, 0xBF, 0xFF, 0xBF, 0xFF,
+  0xBF, 0xFF, 0xBF, 0xFF, 0xBF, 0xFF, 0xBF, 0xFF, 0xBF, 0x1D
+};
+
+const unsigned char yardOfficeShowStream2[] PROGMEM = {
+  0xC0, 0x00, 0xC0, 0xFF, 0xBF, 0xFF, 0xBF, 0xFF, 0xBF, 0xFF, 0xBF, 0xFF, 0xBF, 0xFF, 0xBF, 0xFF,
+  0xBF, 0xFF, 0xBF, 0xFF, 0xBF, 0xFF, 0xBF, 0xFF, 0xBF, 0x1D
+};
+
+const unsigned char yardOfficeShowStream3[] PROGMEM = {
+  0xC0, 0x00, 0xC0, 0xFF, 0x00, 0xC0, 0x00, 0x13, 0xC0, 0xFF, 0xC0, 0x00, 0x26, 0xC0, 0x51, 0xDF,
+  0xDE, 0xDF, 0xC0, 0xFF, 0xBF, 0xFF, 0x94, 0xA3, 0xC0, 0xDB, 0xC0, 0x75, 0xC0, 0x0F, 0xD1, 0xBF,
+  0xFF, 0xAF, 0x9E, 0xC0, 0xFF, 0x01, 0xC0, 0x00, 0x2D, 0xC0, 0xFF, 0xC0, 0x00, 0x31, 0xC0, 0xFF,
+  0xBF, 0xFF, 0x9E, 0xBF, 0xC0, 0xB2, 0xC0, 0x4C, 0xC0, 0x00, 0xBB, 0x8F, 0xC0, 0xFF, 0x01, 0xC0,
+  0x00, 0x29, 0xC0, 0xFF, 0xC0, 0x00, 0x2B, 0xC0, 0xFF, 0xC0, 0x00, 0x20, 0xC0, 0xFF, 0xBD, 0xD9,
+  0xC0, 0x9E, 0xC0, 0x38, 0xC0, 0x00, 0xBF, 0xFF, 0x96, 0x5C, 0xC0, 0xFF, 0x03, 0xC0, 0x00, 0x2F,
+  0xC0, 0xFF, 0xBF, 0xFF, 0xB2, 0xCB, 0xC0, 0xB2, 0xC0, 0x4C, 0xC0, 0x00, 0xBF, 0xFF, 0x98, 0x18
+};
+
+const unsigned char yardOfficeShowStream4[] PROGMEM = {
+  0xC0, 0x00, 0xC0, 0xFF, 0x02, 0xC0, 0x00, 0x26, 0xC0, 0xFF, 0xC0, 0x00, 0x08, 0xC0, 0xFF, 0xC0,
+  0x00, 0x0E, 0xC0, 0x3C, 0xE1, 0xE2, 0xE2, 0xE3, 0xE3, 0xE3, 0xE3, 0xE4, 0xE4, 0xE4, 0xE4, 0xE3,
+  0xE3, 0xE3, 0xE3, 0xE2, 0xE1, 0xE1, 0x01, 0xDF, 0xDF, 0xDE, 0xDE, 0xDD, 0xDD, 0xDC, 0xDC, 0xDD,
+  0xDC, 0xDC, 0xDC, 0xDD, 0xDD, 0xDD, 0xDE, 0xDE, 0xDF, 0x01, 0xC0, 0xFF, 0xBF, 0xFF, 0x8D, 0xA0,
+  0xC0, 0xB2, 0xC0, 0x4C, 0xC0, 0x00, 0xBF, 0xFF, 0x9E, 0x2F, 0xC0, 0xFF, 0x01, 0xC0, 0x00, 0x1C,
+  0xC0, 0xFF, 0xC0, 0x00, 0x16, 0xC0, 0xFF, 0xC0, 0x00, 0x1F, 0xC0, 0xFF, 0xC0, 0x00, 0x2B, 0xC0,
+  0x3C, 0x01, 0xC0, 0xFF, 0xBF, 0xFF, 0xA6, 0xC7, 0xD0, 0xC0, 0x89, 0xC0, 0x23, 0xC0, 0x00, 0xBC,
+  0x88, 0xC0, 0xFF, 0xC0, 0x00, 0x58, 0xC0, 0x4E, 0xDE, 0xDF, 0xDE, 0xDE, 0xDE, 0xDF, 0xDE, 0xDF,
+  0xDF, 0xDF, 0xDF, 0xDF, 0xDF, 0x05, 0xE1, 0xE1, 0x00, 0xE2, 0xE1, 0xE1, 0xE1, 0xE2, 0xE2, 0xE2,
+  0xE1, 0xE2, 0xE2, 0xE2, 0xE2, 0xE2, 0xE2, 0xE3, 0xE2, 0xE2, 0xE1, 0xE2, 0xE2, 0xE2, 0xC0, 0xFF,
+  0xBF, 0xFF, 0xA0, 0x21, 0xC0, 0xB2, 0xC0, 0x4C, 0xC0, 0x00, 0xBF, 0xFF, 0x90, 0x59, 0xC0, 0xFF,
+  0x00, 0xC0, 0x00, 0x0D, 0xC0, 0xFF, 0xC0, 0x00, 0x0F, 0xC0, 0xFF, 0xC0, 0x00, 0x0A, 0xC0, 0x43,
+  0xDE, 0xDE, 0xDF, 0xDE, 0x03, 0xE2, 0xE1, 0xE2, 0xE2, 0xE3, 0xE3, 0xE3, 0xE3, 0xE4, 0xE3, 0xE3,
+  0xE4, 0xE3, 0xE3, 0xE2, 0xE3, 0xE2, 0xE1, 0xE1, 0xE1, 0x02, 0xDF, 0xDE, 0xDE, 0xDE, 0xDD, 0xDD,
+  0xDD, 0xDD, 0xDD, 0xDC, 0xDD, 0xDD, 0xDD, 0xDD, 0xC0, 0xFF, 0xBF, 0xFF, 0xAD, 0x50, 0xC0, 0x9E,
+  0xC0, 0x38, 0xC0, 0x00, 0xBF, 0xFF, 0x90, 0x3B
+};
+
+const unsigned char yardOfficeShowStream5[] PROGMEM = {
+  0xC0, 0x00, 0x87, 0xAC, 0xC0, 0xFF, 0x01, 0xC0, 0x00, 0x25, 0xC0, 0xFF, 0xC0, 0x00, 0x1D, 0xC0,
+  0xFF, 0xBF, 0xFF, 0x86, 0x1C, 0xC0, 0xBC, 0xC0, 0x56, 0xC0, 0x00, 0xBF, 0xFF, 0xAC, 0x00, 0xC0,
+  0xFF, 0x00, 0xC0, 0x00, 0x21, 0xC0, 0x3D, 0x01, 0xDF, 0x08, 0xE1, 0x00, 0xE1, 0x00, 0xE1, 0xE1,
+  0xE1, 0x00, 0xE1, 0xE1, 0xE1, 0xE1, 0xC0, 0xFF, 0xBF, 0xFF, 0x8A, 0xEA, 0xC0, 0xB7, 0xC0, 0x51,
+  0xC0, 0x00, 0xBF, 0xFF, 0x91, 0x4D, 0xC0, 0xFF, 0x03, 0xC0, 0x00, 0x14, 0xC0, 0x63, 0xE1, 0xE1,
+  0xE1, 0x00, 0xE1, 0xE1, 0xE1, 0x00, 0xE1, 0xE1, 0x00, 0xE1, 0x01, 0xE1, 0x01, 0xC0, 0xFF, 0xBF,
+  0xFF, 0x99, 0xF9, 0xD5, 0xC0, 0x8E, 0xC0, 0x28, 0xC0, 0x00, 0xBF, 0xFF, 0x9D, 0x32, 0xC0, 0xFF,
+  0x02, 0xC0, 0x00, 0x24, 0xC0, 0xFF, 0xC0, 0x00, 0x10, 0xC0, 0xFF, 0xA2, 0x13, 0xD5, 0xC0, 0x8E,
+  0xC0, 0x28, 0xC0, 0x00, 0xBF, 0xFF, 0xBF, 0xFF, 0x8E, 0xD5
+};
+
+const LEDBakedChannel yardOfficeShowChannels[YARDOFFICESHOW_CHANNEL_COUNT] PROGMEM = {
+  {3, yardOfficeShowStream0, sizeof(yardOfficeShowStream0)},
+  {5, yardOfficeShowStream1, sizeof(yardOfficeShowStream1)},
+  {6, yardOfficeShowStream2, sizeof(yardOfficeShowStream2)},
+  {9, yardOfficeShowStream3, sizeof(yardOfficeShowStream3)},
+  {10, yardOfficeShowStream4, sizeof(yardOfficeShowStream4)},
+  {11, yardOfficeShowStream5, sizeof(yardOfficeShowStream5)}
+};
+
+#endif
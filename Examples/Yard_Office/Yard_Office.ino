@@ -1,4 +1,5 @@
-#include <LEDLightingCycle.h>
+#include <LEDLayout.h>
+#include <LEDVoltageMonitor.h>
 
 //define PWM capable pins
 #define PWM_PIN0 3
@@ -9,9 +10,6 @@
 #define PWM_PIN5 11
 #define PWM_PIN6 LED_BUILTIN //13 on micro
 
-//define number of LEDs
-#define LED_COUNT 6
-
 //define voltage sensing pins
 #define VREF 5.0
 #define V5_SENSE_PIN A5
@@ -31,28 +29,42 @@
 #define VIN_LOW_VOLTAGE 6.5
 #define VIN_HIGH_VOLTAGE 8.0
 
-//LED setup
+//layout in flash, pins, time ranges and the order of chained lights are checked by the compiler
+constexpr LEDLightDefinition yardOffice[] PROGMEM = {
+  //outside lights
+  LEDLayout::staticLight(PWM_PIN0, 255),
+  LEDLayout::staticLight(PWM_PIN1, 255),
+  LEDLayout::staticLight(PWM_PIN2, 255),
+
+  //office lights, the back office follows the office on PWM_PIN4
+  LEDLayout::randomCycle(PWM_PIN3, 255, 5*60*1000ul, 10*60*1000ul, 5*60*1000ul, 10*60*1000ul,
+                         LEDLayout::fluorescentStart(500, 4000), LEDLayout::fade(50)),
+  LEDLayout::randomCycle(PWM_PIN4, 255, 5*60*1000ul, 10*60*1000ul, 5*60*1000ul, 10*60*1000ul,
+                         LEDLayout::fluorescentStart(1000, 4000), LEDLayout::fade(50)),
+  LEDLayout::chainedCycle(PWM_PIN5, 255, 4, 30*1000ul, 2*60*1000ul, 2*60*1000ul, 10*60*1000ul,
+                          LEDLayout::fluorescentStart(500, 2000), LEDLayout::fade(50))
+};
+LED_LAYOUT_CHECK(yardOffice);
+
+//define number of LEDs
+#define LED_COUNT LED_LAYOUT_SIZE(yardOffice)
+
+//LED setup, the lights are created in static RAM instead of the heap
 LEDStaticLighting * ledSetups[LED_COUNT];
+LED_LAYOUT_STORAGE(yardOffice) yardOfficeStorage;
+
+//voltage monitoring
+LEDVoltageMonitor * v5Monitor;
+LEDVoltageMonitor * vinMonitor;
 
 void setup() {
   // put your setup code here, to run once:
   randomSeed(analogRead(A0)*analogRead(A1)*analogRead(A2));
 
-  //outside lights
-  ledSetups[0] = new LEDStaticLighting(PWM_PIN0, 255);
-  ledSetups[1] = new LEDStaticLighting(PWM_PIN1, 255);
-  ledSetups[2] = new LEDStaticLighting(PWM_PIN2, 255);
-  
-  //office lights
-  ledSetups[3] = new LEDRandomLightingCycle(PWM_PIN3, 255, 5*60*1000ul, 10*60*1000ul, 5*60*1000ul, 10*60*1000ul, new LEDCyclicEffect(), new FluorescentStartEffect(500, 4000), new FadeEffect(50, FadeEffect::FADE_OUT));
-  ledSetups[4] = new LEDRandomLightingCycle(PWM_PIN4, 255, 5*60*1000ul, 10*60*1000ul, 5*60*1000ul, 10*60*1000ul, new LEDCyclicEffect(), new FluorescentStartEffect(1000, 4000), new FadeEffect(50, FadeEffect::FADE_OUT));
-  ledSetups[5] = new LEDChainedCycle(PWM_PIN5, 255, ledSetups[4], 30*1000ul, 2*60*1000ul, 2*60*1000ul, 10*60*1000ul, new LEDCyclicEffect(), new FluorescentStartEffect(500, 2000), new FadeEffect(50, FadeEffect::FADE_OUT) );
+  LEDLayout::create(yardOffice, ledSetups, yardOfficeStorage);
 
-  pinMode(V5_LOW_PIN, OUTPUT);
-  pinMode(V5_OK_PIN, OUTPUT);
-  pinMode(VIN_LOW_PIN, OUTPUT);
-  pinMode(VIN_OK_PIN, OUTPUT);
-  pinMode(VIN_HIGH_PIN, OUTPUT);
+  v5Monitor = new LEDVoltageMonitor(V5_SENSE_PIN, VREF, V5_SENSE_FACTOR, V5_LOW_VOLTAGE, V5_LOW_PIN, V5_OK_PIN);
+  vinMonitor = new LEDVoltageMonitor(VIN_SENSE_PIN, VREF, VIN_SENSE_FACTOR, VIN_LOW_VOLTAGE, VIN_LOW_PIN, VIN_OK_PIN, VIN_HIGH_VOLTAGE, VIN_HIGH_PIN);
   analogReference(EXTERNAL);
 }
 
@@ -63,32 +75,7 @@ void loop() {
     ledSetups[ledIndex]->execute();
   }
 
-  //read input voltages
-  const float voltageV5 = (analogRead(V5_SENSE_PIN) * V5_SENSE_FACTOR * VREF) / 1024.0;
-  const float voltageVin = (analogRead(VIN_SENSE_PIN) * VIN_SENSE_FACTOR * VREF ) / 1024.0;
-
-  if (voltageV5 < V5_LOW_VOLTAGE) { //V5 low
-    digitalWrite(V5_LOW_PIN, HIGH);
-    digitalWrite(V5_OK_PIN, LOW);
-  }
-  else { //V5 OK
-    digitalWrite(V5_LOW_PIN, LOW);
-    digitalWrite(V5_OK_PIN, HIGH);
-  }
-
-  if (voltageVin < VIN_LOW_VOLTAGE) { //Vin low
-    digitalWrite(VIN_LOW_PIN, HIGH);
-    digitalWrite(VIN_OK_PIN, LOW);
-    digitalWrite(VIN_HIGH_PIN, LOW);
-  }
-  else if (voltageVin > VIN_HIGH_VOLTAGE) { //Vin high
-    digitalWrite(VIN_LOW_PIN, LOW);
-    digitalWrite(VIN_OK_PIN, LOW);
-    digitalWrite(VIN_HIGH_PIN, HIGH);
-  }
-  else { //Vin OK
-    digitalWrite(VIN_LOW_PIN, LOW);
-    digitalWrite(VIN_OK_PIN, HIGH);
-    digitalWrite(VIN_HIGH_PIN, LOW);
-  }
+  //check input voltages without waiting for the ADC
+  v5Monitor->execute();
+  vinMonitor->execute();
 }
@@ -0,0 +1,104 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "LEDBakedPlayer.h"
+#include <Arduino.h>
+
+LEDBakedPlayer::LEDBakedPlayer(const LEDBakedChannel * const channels, unsigned char const channelCount, unsigned short const frameMs):
+  _channels(channels),
+  _channelCount(channelCount),
+  _frameMs(frameMs ? frameMs : 1),
+  _cursors(new ChannelCursor[channelCount]),
+  _frameStartMs(0)
+{
+  for (unsigned char channelIndex = 0; channelIndex < _channelCount; channelIndex++) {
+    pinMode(pgm_read_byte(&_channels[channelIndex].pin), OUTPUT);
+  }
+
+  restart();
+}
+
+void LEDBakedPlayer::restart() {
+  _frameStartMs = millis();
+
+  for (unsigned char channelIndex = 0; channelIndex < _channelCount; channelIndex++) {
+    ChannelCursor & cursor = _cursors[channelIndex];
+    cursor.next = (const unsigned char *)pgm_read_ptr(&_channels[channelIndex].stream);
+    cursor.value = 0;
+    readToken(channelIndex);
+    analogWrite(pgm_read_byte(&_channels[channelIndex].pin), cursor.value);
+  }
+}
+
+void LEDBakedPlayer::readToken(unsigned char const channelIndex) {
+  ChannelCursor & cursor = _cursors[channelIndex];
+  const LEDBakedChannel * const channel = &_channels[channelIndex];
+
+  const unsigned char * const stream = (const unsigned char *)pgm_read_ptr(&channel->stream);
+  if (cursor.next >= stream + pgm_read_word(&channel->length)) {
+    //loop the show, every stream starts with an absolute value
+    cursor.next = stream;
+  }
+
+  const unsigned char token = pgm_read_byte(cursor.next++);
+  if (token < LED_BAKED_LONG_HOLD) {
+    cursor.remainingFrames = token + 1;
+  }
+  else if (token < LED_BAKED_SET_VALUE) {
+    cursor.remainingFrames = (((token & 0x3F) << 8) | pgm_read_byte(cursor.next++)) + 1;
+  }
+  else {
+    if (token == LED_BAKED_SET_VALUE) {
+      cursor.value = pgm_read_byte(cursor.next++);
+    }
+    else {
+      cursor.value += token - LED_BAKED_DELTA_ZERO;
+    }
+    cursor.remainingFrames = 1;
+  }
+}
+
+void LEDBakedPlayer::execute() {
+  const unsigned long currentTimeMs = millis();
+  unsigned long elapsedMs = currentTimeMs - _frameStartMs;
+  if (elapsedMs < _frameMs) {
+    return;
+  }
+
+  //usually exactly one frame has elapsed, so counting is cheaper than dividing
+  unsigned short frames = 0;
+  while (elapsedMs >= _frameMs) {
+    elapsedMs -= _frameMs;
+    frames++;
+  }
+  _frameStartMs = currentTimeMs - elapsedMs;
+
+  for (unsigned char channelIndex = 0; channelIndex < _channelCount; channelIndex++) {
+    ChannelCursor & cursor = _cursors[channelIndex];
+    const unsigned char previousValue = cursor.value;
+
+    unsigned short remainingFrames = frames;
+    while (remainingFrames >= cursor.remainingFrames) {
+      remainingFrames -= cursor.remainingFrames;
+      readToken(channelIndex);
+    }
+    cursor.remainingFrames -= remainingFrames;
+
+    if (cursor.value != previousValue) {
+      analogWrite(pgm_read_byte(&_channels[channelIndex].pin), cursor.value);
+    }
+  }
+}
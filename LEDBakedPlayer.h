@@ -0,0 +1,119 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef LEDBAKEDPLAYER_H
+#define LEDBAKEDPLAYER_H
+
+/*
+  Token format of a baked channel stream, one token per byte plus an optional parameter byte:
+    0x00 - 0x7F  hold the current value for token + 1 frames
+    0x80 - 0xBF  hold the current value for ((token & 0x3F) << 8 | next byte) + 1 frames
+    0xC0         set the value to the next byte for one frame
+    0xC1 - 0xFF  change the value by token - 0xE0 for one frame
+  A stream starts with 0xC0 and is repeated from the start when its end is reached.
+*/
+
+///first token of a long hold
+#define LED_BAKED_LONG_HOLD 0x80
+///token setting an absolute value
+#define LED_BAKED_SET_VALUE 0xC0
+///delta token for a change of 0
+#define LED_BAKED_DELTA_ZERO 0xE0
+///largest change of a delta token
+#define LED_BAKED_MAX_DELTA 31
+///longest hold of a single short hold token
+#define LED_BAKED_MAX_SHORT_HOLD 0x80
+///longest hold of a single long hold token
+#define LED_BAKED_MAX_LONG_HOLD 0x4000
+
+/**
+  @brief One output of a baked show, declared with PROGMEM.
+*/
+struct LEDBakedChannel {
+  ///output pin
+  unsigned char pin;
+  ///token stream, declared with PROGMEM
+  const unsigned char * stream;
+  ///length of #stream in bytes
+  unsigned short length;
+};
+
+/**
+  @brief Plays back brightness timelines baked on the host into flash.
+
+  The timelines are recorded by Tools/HostSimulator/bake, which runs a lighting configuration with
+  a fixed seed and writes the output brightness of every frame as a header with one token stream per output.
+  The show looks identical every time it is played and needs neither random() nor any effect code on the board.
+
+  Each output only keeps a cursor into its stream in RAM. Every frame advances each cursor by one
+  frame, which mostly means decrementing a hold counter. Pins are only written when the value changes.
+*/
+class LEDBakedPlayer {
+  private:
+    /**
+      @brief Playback position of one output.
+    */
+    struct ChannelCursor {
+      ///next token in the stream
+      const unsigned char * next;
+      ///frames left of the current token including the current frame
+      unsigned short remainingFrames;
+      ///current output brightness
+      unsigned char value;
+    };
+
+    ///outputs, declared with PROGMEM
+    const LEDBakedChannel * const _channels;
+    ///number of outputs in #_channels
+    const unsigned char _channelCount;
+    ///duration of a frame in ms
+    const unsigned short _frameMs;
+    ///playback position of each output
+    ChannelCursor * const _cursors;
+    ///start time of the current frame in ms
+    unsigned long _frameStartMs;
+
+    /**
+      @brief reads the next token of an output
+
+      @param channelIndex index of the output
+    */
+    void readToken(unsigned char const channelIndex);
+
+  public:
+    /**
+      @brief creates a new LEDBakedPlayer instance and starts the show
+
+      @param channels outputs of the show, declared with PROGMEM
+      @param channelCount number of outputs in \p channels
+      @param frameMs duration of a frame the show was baked with in ms
+    */
+    LEDBakedPlayer(const LEDBakedChannel * const channels, unsigned char const channelCount, unsigned short const frameMs);
+
+    /**
+      @brief This method needs to be called in the loop() function of the sketch.
+
+      Advances all outputs by the frames elapsed since the last call.
+    */
+    void execute();
+
+    /**
+      @brief starts the show from the beginning
+    */
+    void restart();
+};
+
+#endif
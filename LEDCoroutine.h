@@ -0,0 +1,80 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef LEDCOROUTINE_H
+#define LEDCOROUTINE_H
+
+/**
+  @file
+  @brief Macros to write multi stage effects as sequential code.
+
+  The macros turn a function into a stackless coroutine, similar to protothreads. The function returns while it waits
+  and continues behind the wait on the next call. The only state kept between calls is an unsigned short resume state,
+  everything else the effect needs across waits has to be a member, since local variables are lost on return:
+  ```
+  unsigned short BlinkEffect::getBrightness16(unsigned char const maxBrightness) {
+    const unsigned long currentTimeMs = millis();
+
+    LED_COROUTINE_BEGIN(_resumeState);
+    while (true) {
+      _stageStartMs = currentTimeMs;
+      LED_COROUTINE_WAIT_WHILE(_resumeState, (currentTimeMs - _stageStartMs) < 500, (unsigned short)maxBrightness << 8);
+      _stageStartMs = currentTimeMs;
+      LED_COROUTINE_WAIT_WHILE(_resumeState, (currentTimeMs - _stageStartMs) < 500, 0);
+    }
+    LED_COROUTINE_END(_resumeState);
+    return 0;
+  }
+  ```
+  The resume state is the line number of the last wait, so there can only be one wait per line.
+  The body must not contain switch statements or declarations with initializers, since it is one big switch itself.
+*/
+
+///resume state of a coroutine that has not started yet
+#define LED_COROUTINE_START 0
+///resume state of a coroutine that has reached #LED_COROUTINE_END()
+#define LED_COROUTINE_FINISHED 0xFFFF
+
+//the cases of the resume switch deliberately fall through
+#if defined(__GNUC__) && (__GNUC__ >= 7)
+#define LED_COROUTINE_FALLTHROUGH __attribute__((fallthrough))
+#else
+#define LED_COROUTINE_FALLTHROUGH
+#endif
+
+///starts the body of the coroutine, continuing behind the last wait
+#define LED_COROUTINE_BEGIN(resumeState) switch (resumeState) { case LED_COROUTINE_START:
+
+/**
+  returns \p result as long as \p condition is true, the condition and the result are evaluated again on every call
+*/
+#define LED_COROUTINE_WAIT_WHILE(resumeState, condition, result) \
+  do { \
+    (resumeState) = __LINE__; \
+    LED_COROUTINE_FALLTHROUGH; \
+    case __LINE__: \
+    if (condition) { \
+      return (result); \
+    } \
+  } while (0)
+
+///ends the body of the coroutine, later calls skip the body and continue behind this macro
+#define LED_COROUTINE_END(resumeState) (resumeState) = LED_COROUTINE_FINISHED; LED_COROUTINE_FALLTHROUGH; case LED_COROUTINE_FINISHED: ; }
+
+///starts the coroutine from the beginning on the next call
+#define LED_COROUTINE_RESET(resumeState) (resumeState) = LED_COROUTINE_START
+
+#endif
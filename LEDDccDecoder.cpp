@@ -0,0 +1,208 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "LEDDccDecoder.h"
+#include "LEDLightingScheduler.h"
+#include <Arduino.h>
+
+//half bit durations in us, slightly wider than NMRA S-9.1 for interrupt latency and the 4us resolution of micros()
+#define DCC_ONE_MIN_US 44
+#define DCC_ONE_MAX_US 72
+#define DCC_ZERO_MIN_US 86
+#define DCC_ZERO_MAX_US 10000
+//minimum number of one bits before the start bit of a packet
+#define DCC_MIN_PREAMBLE_BITS 10
+//value of #_firstHalfBit when the next half bit starts a new bit
+#define DCC_NO_HALF_BIT 0xFF
+
+LEDDccDecoder * LEDDccDecoder::_instance = 0;
+
+LEDDccDecoder::LEDDccDecoder(unsigned char const dccPin, unsigned char const maxTriggerCount):
+  _dccPin(dccPin),
+  _triggers(new Trigger[maxTriggerCount]),
+  _maxTriggerCount(maxTriggerCount),
+  _triggerCount(0),
+  _lastEdgeUs(0),
+  _firstHalfBit(DCC_NO_HALF_BIT),
+  _state(DCC_PREAMBLE),
+  _preambleCount(0),
+  _bitCount(0),
+  _currentByte(0),
+  _checksum(0),
+  _receiveLength(0),
+  _packetLength(0),
+  _isPacketReady(false)
+{}
+
+bool LEDDccDecoder::addTrigger(unsigned short const address, unsigned char & trigger) {
+  if (_triggerCount >= _maxTriggerCount) {
+    return false;
+  }
+
+  _triggers[_triggerCount].address = address;
+  _triggers[_triggerCount].trigger = &trigger;
+  _triggerCount++;
+  return true;
+}
+
+void LEDDccDecoder::begin() {
+  _instance = this;
+  pinMode(_dccPin, INPUT);
+  attachInterrupt(digitalPinToInterrupt(_dccPin), handlePinInterrupt, CHANGE);
+  //edge interrupts only wake the board from idle mode
+  LEDLightingScheduler::setPowerDownBlocked(true);
+}
+
+void LEDDccDecoder::end() {
+  detachInterrupt(digitalPinToInterrupt(_dccPin));
+  _instance = 0;
+  LEDLightingScheduler::setPowerDownBlocked(false);
+}
+
+void LEDDccDecoder::handlePinInterrupt() {
+  if (_instance) {
+    _instance->addEdge(micros());
+  }
+}
+
+void LEDDccDecoder::resetPacket() {
+  _state = DCC_PREAMBLE;
+  _preambleCount = 0;
+}
+
+void LEDDccDecoder::addEdge(unsigned short const edgeTimeUs) {
+  const unsigned short halfBitUs = edgeTimeUs - _lastEdgeUs;
+  _lastEdgeUs = edgeTimeUs;
+
+  unsigned char halfBit;
+  if ((halfBitUs >= DCC_ONE_MIN_US) && (halfBitUs <= DCC_ONE_MAX_US)) {
+    halfBit = 1;
+  }
+  else if ((halfBitUs >= DCC_ZERO_MIN_US) && (halfBitUs <= DCC_ZERO_MAX_US)) {
+    halfBit = 0;
+  }
+  else {
+    //noise or no signal
+    _firstHalfBit = DCC_NO_HALF_BIT;
+    resetPacket();
+    return;
+  }
+
+  if (_firstHalfBit == DCC_NO_HALF_BIT) {
+    _firstHalfBit = halfBit;
+    return;
+  }
+
+  if (_firstHalfBit != halfBit) {
+    //the halves of a bit always match, so this half starts the next bit
+    _firstHalfBit = halfBit;
+    if (_state != DCC_PREAMBLE) {
+      resetPacket();
+    }
+    return;
+  }
+
+  _firstHalfBit = DCC_NO_HALF_BIT;
+  addBit(halfBit);
+}
+
+void LEDDccDecoder::addBit(unsigned char const bit) {
+  switch (_state) {
+    case DCC_PREAMBLE:
+      if (bit) {
+        if (_preambleCount < DCC_MIN_PREAMBLE_BITS) {
+          _preambleCount++;
+        }
+      }
+      else if (_preambleCount >= DCC_MIN_PREAMBLE_BITS) {
+        //start bit of the first byte
+        _state = DCC_DATA;
+        _bitCount = 0;
+        _checksum = 0;
+        _receiveLength = 0;
+      }
+      else {
+        _preambleCount = 0;
+      }
+      break;
+    case DCC_DATA:
+      _currentByte = (_currentByte << 1) | bit;
+      if (++_bitCount == 8) {
+        if (_receiveLength >= LED_DCC_MAX_PACKET_LENGTH) {
+          resetPacket();
+          break;
+        }
+        _receiveBuffer[_receiveLength++] = _currentByte;
+        _checksum ^= _currentByte;
+        _state = DCC_SEPARATOR;
+      }
+      break;
+    case DCC_SEPARATOR:
+      if (not bit) {
+        //start bit of the next byte
+        _state = DCC_DATA;
+        _bitCount = 0;
+        break;
+      }
+
+      //end of the packet, the end bit can be the first bit of the next preamble
+      resetPacket();
+      _preambleCount = 1;
+      if (_checksum || (_receiveLength < 3) || _isPacketReady) {
+        break;
+      }
+      for (unsigned char index = 0; index < _receiveLength; index++) {
+        _packet[index] = _receiveBuffer[index];
+      }
+      _packetLength = _receiveLength;
+      _isPacketReady = true;
+      if ((_receiveBuffer[0] & 0xC0) == 0x80) {
+        //accessory packet, end the sleep of the scheduler to react right away
+        LEDLightingScheduler::wakeUp();
+      }
+      break;
+  }
+}
+
+void LEDDccDecoder::execute() {
+  if (not _isPacketReady) {
+    return;
+  }
+
+  //the interrupt does not touch the packet until it is released
+  const unsigned char length = _packetLength;
+  const unsigned char addressByte = _packet[0];
+  const unsigned char commandByte = _packet[1];
+  _isPacketReady = false;
+
+  //basic accessory packet: 10AAAAAA 1aaaCDDR EEEEEEEE with aaa as inverted high address bits
+  if ((length != 3) || ((addressByte & 0xC0) != 0x80) || not (commandByte & 0x80) || not (commandByte & 0x08)) {
+    return;
+  }
+
+  const unsigned short decoderAddress = (addressByte & 0x3F) | ((~commandByte & 0x70) << 2);
+  if (not decoderAddress) {
+    return;
+  }
+  const unsigned short address = ((decoderAddress - 1) << 2) + ((commandByte >> 1) & 0x03) + 1;
+  const unsigned char value = commandByte & 0x01;
+
+  for (unsigned char triggerIndex = 0; triggerIndex < _triggerCount; triggerIndex++) {
+    if (_triggers[triggerIndex].address == address) {
+      *_triggers[triggerIndex].trigger = value;
+    }
+  }
+}
@@ -0,0 +1,178 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef LEDDCCDECODER_H
+#define LEDDCCDECODER_H
+
+///maximum length of a DCC packet in bytes including the error detection byte
+#define LED_DCC_MAX_PACKET_LENGTH 6
+
+/**
+  @brief Sets trigger variables from DCC accessory commands.
+
+  The DCC signal is connected to an interrupt capable pin through an optocoupler. The pin interrupt only measures
+  the time between two edges and assembles the bits into packets. Accessory packets are decoded in #execute(),
+  which sets the trigger variables mapped to the address of the command, so LEDTriggeredCycle can follow turnout
+  commands of the command station:
+  ```
+  unsigned char stationLights = 0;
+  LEDDccDecoder dccDecoder(2, 4);
+
+  void setup() {
+    ...
+    ledSetups[0] = new LEDTriggeredCycle(PWM_PIN0, 255, 0, 500, 0, 500, stationLights);
+    dccDecoder.addTrigger(100, stationLights);
+    dccDecoder.begin();
+  }
+
+  void loop() {
+    dccDecoder.execute();
+    ...
+  }
+  ```
+  The straight (green) command of an address sets its triggers to 1, the diverging (red) command sets them to 0.
+  Addresses are numbered like on most command stations, decoder address 1 has the addresses 1 to 4.
+
+  A changed trigger makes its LEDTriggeredCycle due, so a light run by an LEDLightingScheduler reacts on the
+  next pass after #execute().
+
+  Only one decoder can be active at a time. #addEdge() can be called directly to feed recorded or generated
+  edge times, e.g. to test a layout on a PC.
+*/
+class LEDDccDecoder {
+  private:
+    ///Decoder states of the bit stream
+    enum DecoderStates {
+      ///counting the one bits of the preamble
+      DCC_PREAMBLE,
+      ///reading the bits of a byte
+      DCC_DATA,
+      ///reading the bit after a byte, 0 if another byte follows and 1 at the end of the packet
+      DCC_SEPARATOR
+    };
+
+    ///Trigger variable mapped to an address
+    struct Trigger {
+      ///accessory address
+      unsigned short address;
+      ///trigger variable set by commands to the address
+      unsigned char * trigger;
+    };
+
+    ///pin the DCC signal is connected to
+    const unsigned char _dccPin;
+    ///mapped trigger variables
+    Trigger * const _triggers;
+    ///maximum number of entries in #_triggers
+    const unsigned char _maxTriggerCount;
+    ///number of entries in #_triggers
+    unsigned char _triggerCount;
+
+    ///time of the previous edge in us
+    unsigned short _lastEdgeUs;
+    ///value of the first half of the current bit, or a value above 1 if the next half starts a bit
+    unsigned char _firstHalfBit;
+    ///one of #DecoderStates
+    unsigned char _state;
+    ///number of one bits in the current preamble
+    unsigned char _preambleCount;
+    ///number of bits received of the current byte
+    unsigned char _bitCount;
+    ///bits received of the current byte
+    unsigned char _currentByte;
+    ///XOR of all received bytes, 0 for a valid packet
+    unsigned char _checksum;
+    ///bytes of the packet being received
+    unsigned char _receiveBuffer[LED_DCC_MAX_PACKET_LENGTH];
+    ///number of bytes in #_receiveBuffer
+    unsigned char _receiveLength;
+
+    ///last complete packet, only written by the interrupt while #_isPacketReady is false
+    volatile unsigned char _packet[LED_DCC_MAX_PACKET_LENGTH];
+    ///number of bytes in #_packet
+    volatile unsigned char _packetLength;
+    ///true while #_packet waits for #execute()
+    volatile bool _isPacketReady;
+
+    ///decoder receiving the pin interrupts
+    static LEDDccDecoder * _instance;
+
+    /**
+      @brief adds a complete bit to the packet
+    */
+    void addBit(unsigned char const bit);
+
+    /**
+      @brief starts searching for the next preamble
+    */
+    void resetPacket();
+
+    /**
+      @brief forwards a pin interrupt to #_instance
+    */
+    static void handlePinInterrupt();
+
+  public:
+    /**
+      @brief creates a new LEDDccDecoder instance
+
+      @param dccPin pin the DCC signal is connected to, it has to support interrupts
+      @param maxTriggerCount maximum number of trigger variables added with #addTrigger()
+    */
+    LEDDccDecoder(unsigned char const dccPin, unsigned char const maxTriggerCount);
+
+    /**
+      @brief maps a trigger variable to an accessory address
+
+      Several trigger variables can be mapped to the same address.
+
+      @param address accessory address from 1 to 2044
+      @param trigger trigger variable, e.g. of an LEDTriggeredCycle
+      @return false if \p maxTriggerCount triggers have already been added
+    */
+    bool addTrigger(unsigned short const address, unsigned char & trigger);
+
+    /**
+      @brief starts decoding by attaching the pin interrupt
+
+      Edge interrupts can not wake an AVR board from power down, so LEDLightingScheduler::sleepUntilNextUpdate()
+      only uses the idle mode until #end() is called.
+    */
+    void begin();
+
+    /**
+      @brief stops decoding
+    */
+    void end();
+
+    /**
+      @brief This method needs to be called in the loop() function of the sketch.
+
+      Decodes the last received packet and sets the triggers if it is an accessory command.
+    */
+    void execute();
+
+    /**
+      @brief processes an edge of the DCC signal
+
+      Called by the pin interrupt, or directly to feed edge times on a PC.
+
+      @param edgeTimeUs time of the edge in us, the lower 16 bits of micros() are sufficient
+    */
+    void addEdge(unsigned short const edgeTimeUs);
+};
+
+#endif
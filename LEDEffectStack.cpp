@@ -0,0 +1,97 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "LEDEffectStack.h"
+#include <Arduino.h>
+
+//full brightness in 8.8 fixed point
+#define STACK_FULL_LEVEL 256u
+
+LEDEffectStack::LEDEffectStack(unsigned char const maxLayerCount):
+  _layers(new Layer[maxLayerCount]),
+  _maxLayerCount(maxLayerCount),
+  _layerCount(0)
+{}
+
+bool LEDEffectStack::addLayer(LEDCyclicEffect * const effect, const BlendModes blendMode) {
+  if (_layerCount >= _maxLayerCount) {
+    return false;
+  }
+
+  _layers[_layerCount].effect = effect;
+  _layers[_layerCount].blendMode = blendMode;
+  _layerCount++;
+  return true;
+}
+
+void LEDEffectStack::getBrightnessBatch(unsigned long const * const timesMs, unsigned char const * const maxBrightness,
+                                        unsigned char * const brightness, unsigned char const count) {
+  unsigned char fullBrightness[LED_EFFECT_STACK_CHUNK];
+  memset(fullBrightness, 255, sizeof(fullBrightness));
+
+  for (unsigned char chunkStart = 0; chunkStart < count; chunkStart += LED_EFFECT_STACK_CHUNK) {
+    const unsigned char chunkCount = ((count - chunkStart) < LED_EFFECT_STACK_CHUNK) ? (count - chunkStart) : LED_EFFECT_STACK_CHUNK;
+    unsigned short levels[LED_EFFECT_STACK_CHUNK];
+    unsigned char layerBrightness[LED_EFFECT_STACK_CHUNK];
+
+    for (unsigned char index = 0; index < chunkCount; index++) {
+      levels[index] = STACK_FULL_LEVEL;
+    }
+
+    for (unsigned char layerIndex = 0; layerIndex < _layerCount; layerIndex++) {
+      //one call per layer for the whole chunk
+      _layers[layerIndex].effect->getBrightnessBatch(&timesMs[chunkStart], fullBrightness, layerBrightness, chunkCount);
+      const unsigned char blendMode = layerIndex ? _layers[layerIndex].blendMode : (unsigned char)BLEND_MULTIPLY;
+
+      for (unsigned char index = 0; index < chunkCount; index++) {
+        //0..255 to 0..256, so full brightness stays exact when multiplied
+        const unsigned short level = layerBrightness[index] + (layerBrightness[index] >> 7);
+
+        switch (blendMode) {
+          case BLEND_MULTIPLY:
+            levels[index] = ((unsigned long)levels[index] * level) >> 8;
+            break;
+          case BLEND_MAX:
+            if (level > levels[index]) {
+              levels[index] = level;
+            }
+            break;
+          case BLEND_ADD:
+            levels[index] += level;
+            if (levels[index] > STACK_FULL_LEVEL) {
+              levels[index] = STACK_FULL_LEVEL;
+            }
+            break;
+        }
+      }
+    }
+
+    for (unsigned char index = 0; index < chunkCount; index++) {
+      brightness[chunkStart + index] = ((unsigned long)levels[index] * maxBrightness[chunkStart + index]) >> 8;
+    }
+  }
+}
+
+unsigned int LEDEffectStack::getUpdateIntervalMs() const {
+  unsigned int intervalMs = LED_UPDATE_INTERVAL_STEADY_MS;
+  for (unsigned char layerIndex = 0; layerIndex < _layerCount; layerIndex++) {
+    const unsigned int layerIntervalMs = _layers[layerIndex].effect->getUpdateIntervalMs();
+    if (layerIntervalMs < intervalMs) {
+      intervalMs = layerIntervalMs;
+    }
+  }
+  return intervalMs;
+}
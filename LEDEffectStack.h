@@ -0,0 +1,102 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef LEDEFFECTSTACK_H
+#define LEDEFFECTSTACK_H
+
+#include "LEDLightingEffect.h"
+
+///number of points in time evaluated together by LEDEffectStack
+#define LED_EFFECT_STACK_CHUNK 8
+
+/**
+  @brief Combines several cyclic effects into one.
+
+  The first layer sets the brightness, every further layer is blended onto the result with its blend mode.
+  For example a BeaconEffect multiplied with a slow CandleEffect results in a beacon with a flickering lamp.
+
+  All layers are evaluated for the same timestamp. Each layer is evaluated with one call of
+  LEDCyclicEffect::getBrightnessBatch() for up to #LED_EFFECT_STACK_CHUNK points in time, and the layers are
+  combined with 8.8 fixed point intermediates, so rounding errors do not add up over the layers.
+  The stack is an LEDCyclicEffect itself and can be used wherever an on effect is expected.
+*/
+class LEDEffectStack : public LEDCyclicEffect {
+  public:
+    ///Enumeration for the blend modes of the layers
+    enum BlendModes {
+      ///multiplies the result with the layer, e.g. to dim an effect with a flicker
+      BLEND_MULTIPLY,
+      ///uses the brighter of the result and the layer
+      BLEND_MAX,
+      ///adds the layer to the result, limited to full brightness
+      BLEND_ADD
+    };
+
+  private:
+    /**
+      @brief One effect of the stack.
+    */
+    struct Layer {
+      ///effect of the layer
+      LEDCyclicEffect * effect;
+      ///one of #BlendModes stored in a single byte
+      unsigned char blendMode;
+    };
+
+    ///layers in the order they are blended
+    Layer * const _layers;
+    ///maximum number of layers
+    const unsigned char _maxLayerCount;
+    ///number of layers added
+    unsigned char _layerCount;
+
+  public:
+    /**
+      @brief creates a new LEDEffectStack instance without layers
+
+      @param maxLayerCount maximum number of layers added with #addLayer()
+    */
+    LEDEffectStack(unsigned char const maxLayerCount);
+
+    /**
+      @brief adds a layer on top of the stack
+
+      @param effect effect of the layer
+      @param blendMode combines the layer with the layers below, ignored for the first layer
+      @return false if the stack is already full
+    */
+    bool addLayer(LEDCyclicEffect * const effect, const BlendModes blendMode = BLEND_MULTIPLY);
+
+    /**
+      @brief computes the combined brightness of all layers for several points in time
+
+      @param timesMs array of \p count times in ms as returned by millis()
+      @param maxBrightness array of \p count max allowed brightness values
+      @param brightness array of \p count output brightness values
+      @param count number of elements in each array
+    */
+    void getBrightnessBatch(unsigned long const * const timesMs, unsigned char const * const maxBrightness,
+                            unsigned char * const brightness, unsigned char const count);
+
+    /**
+      @brief returns the shortest update interval of all layers
+
+      @return update interval in ms
+    */
+    unsigned int getUpdateIntervalMs() const;
+};
+
+#endif
@@ -0,0 +1,107 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "LEDFrameEngine.h"
+#include <Arduino.h>
+
+LEDFrameEngine * LEDFrameEngine::_instance = 0;
+
+#if defined(__AVR__) && defined(TIMER0_COMPA_vect)
+ISR(TIMER0_COMPA_vect) {
+  LEDFrameEngine::handleTimerInterrupt();
+}
+#endif
+
+LEDFrameEngine::LEDFrameEngine(LEDStaticLighting * const * const lights, unsigned char const lightCount, unsigned char const frameIntervalTicks):
+  _lights(lights),
+  _lightCount(lightCount),
+  _frameIntervalTicks(frameIntervalTicks),
+  _tickCount(0),
+  _isFrameDue(false),
+  _missedFrames(0)
+{}
+
+void LEDFrameEngine::begin() {
+  for (unsigned char lightIndex = 0; lightIndex < _lightCount; lightIndex++) {
+    _lights[lightIndex]->setOutputDeferred(true);
+  }
+
+  _instance = this;
+#if defined(__AVR__) && defined(TIMER0_COMPA_vect)
+  //timer 0 is already running for millis(), the compare match fires once per cycle regardless of OCR0A
+  TIMSK0 |= _BV(OCIE0A);
+#endif
+}
+
+void LEDFrameEngine::end() {
+#if defined(__AVR__) && defined(TIMER0_COMPA_vect)
+  TIMSK0 &= ~_BV(OCIE0A);
+#endif
+  _instance = 0;
+
+  for (unsigned char lightIndex = 0; lightIndex < _lightCount; lightIndex++) {
+    _lights[lightIndex]->setOutputDeferred(false);
+  }
+}
+
+bool LEDFrameEngine::execute() {
+  if (not _isFrameDue) {
+    return false;
+  }
+
+  //a single byte, clearing it needs no lock
+  _isFrameDue = false;
+  runFrame();
+  return true;
+}
+
+void LEDFrameEngine::runFrame() {
+  //render the frame into the requested brightness of each light
+  for (unsigned char lightIndex = 0; lightIndex < _lightCount; lightIndex++) {
+    _lights[lightIndex]->execute();
+  }
+
+  //swap: all pins are written in one pass after the frame is complete
+  for (unsigned char lightIndex = 0; lightIndex < _lightCount; lightIndex++) {
+    _lights[lightIndex]->updateOutput();
+  }
+}
+
+void LEDFrameEngine::handleTimerInterrupt() {
+  if (_instance) {
+    _instance->tick();
+  }
+}
+
+void LEDFrameEngine::tick() {
+  if (++_tickCount < _frameIntervalTicks) {
+    return;
+  }
+  _tickCount = 0;
+
+  if (_isFrameDue) {
+    _missedFrames++;
+    return;
+  }
+  _isFrameDue = true;
+}
+
+unsigned int LEDFrameEngine::getMissedFrames() const {
+  noInterrupts();
+  const unsigned int missedFrames = _missedFrames;
+  interrupts();
+  return missedFrames;
+}
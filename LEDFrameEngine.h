@@ -0,0 +1,116 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef LEDFRAMEENGINE_H
+#define LEDFRAMEENGINE_H
+
+#include "LEDLightingCycle.h"
+
+/**
+  @brief Executes all lights at a fixed frame rate paced by a timer interrupt.
+
+  On AVR boards the engine uses the compare match A interrupt of timer 0. The interrupt fires once
+  per timer 0 cycle (about 976Hz on a 16MHz board) without changing the PWM output of timer 0 or millis().
+  Every \p frameIntervalTicks interrupts one frame becomes due.
+
+  The interrupt only marks the frame as due, the lights are executed by #execute() in loop(). So the lights,
+  their effects and their trigger variables are never changed by an interrupt while loop() works with them.
+  During a frame all lights execute into their requested brightness (the back buffer) without touching
+  the pins. Once all lights have been executed, all pins are updated in one pass, so no frame is shown half done.
+  The sketch must not call execute() of the lights anymore.
+
+  If the previous frame has not been executed yet when the next frame is due, the next frame is skipped and
+  counted as missed. Keep the other code in loop() shorter than one frame to avoid missed frames.
+
+  On other boards #handleTimerInterrupt() can be called from any periodic timer callback.
+*/
+class LEDFrameEngine {
+  private:
+    ///lights executed in every frame
+    LEDStaticLighting * const * const _lights;
+    ///number of lights in #_lights
+    const unsigned char _lightCount;
+    ///number of timer interrupts per frame
+    const unsigned char _frameIntervalTicks;
+    ///timer interrupts since the last frame
+    volatile unsigned char _tickCount;
+    ///true if a frame is due and has not been executed yet
+    volatile bool _isFrameDue;
+    ///number of frames skipped because the previous frame had not been executed yet
+    volatile unsigned int _missedFrames;
+
+    ///engine driven by the timer interrupt
+    static LEDFrameEngine * _instance;
+
+    /**
+      @brief handles one timer interrupt
+
+      Marks a frame as due every #_frameIntervalTicks calls.
+    */
+    void tick();
+
+  public:
+    /**
+      @brief creates a new LEDFrameEngine instance
+
+      @param lights array of lights to be executed in each frame
+      @param lightCount number of lights in \p lights
+      @param frameIntervalTicks number of timer interrupts per frame, 5 results in about 200Hz
+    */
+    LEDFrameEngine(LEDStaticLighting * const * const lights, unsigned char const lightCount, unsigned char const frameIntervalTicks = 5);
+
+    /**
+      @brief defers the outputs of all lights to the engine and starts the timer interrupt
+
+      Only one engine can be driven by the timer interrupt.
+    */
+    void begin();
+
+    /**
+      @brief stops the timer interrupt and returns the outputs to immediate pin writes
+    */
+    void end();
+
+    /**
+      @brief This method needs to be called in the loop() function of the sketch.
+
+      Executes a frame if one is due.
+
+      @return true if a frame has been executed
+    */
+    bool execute();
+
+    /**
+      @brief executes all lights and updates all outputs afterwards
+    */
+    void runFrame();
+
+    /**
+      @brief forwards a timer interrupt to the engine started with #begin()
+
+      Called by the interrupt service routine.
+    */
+    static void handleTimerInterrupt();
+
+    /**
+      @brief returns the number of missed frames
+
+      @return number of frames skipped because the previous frame had not been executed yet
+    */
+    unsigned int getMissedFrames() const;
+};
+
+#endif
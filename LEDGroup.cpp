@@ -0,0 +1,167 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "LEDGroup.h"
+#include <Arduino.h>
+
+LEDGroup::LEDGroup(unsigned char const ledPin, unsigned char const brightness, unsigned char const maxMemberCount,
+                   unsigned long const onTimeMinMs, unsigned long const onTimeMaxMs,
+                   unsigned long const offTimeMinMs, unsigned long const offTimeMaxMs,
+                   LEDCyclicEffect * const onEffect,
+                   LEDOneShotEffect * const offToOnEffect,
+                   LEDOneShotEffect * const onToOffEffect):
+  LEDRandomLightingCycle(ledPin, brightness, onTimeMinMs, onTimeMaxMs, offTimeMinMs, offTimeMaxMs, onEffect, offToOnEffect, onToOffEffect),
+  _memberPins(new unsigned char[maxMemberCount]),
+  _memberOffsetsMs(new unsigned short[maxMemberCount]),
+  _maxMemberCount(maxMemberCount),
+  _memberCount(0),
+  _joinedCount(0),
+  _wasActive(isOutputActive()),
+  _lastOutputBrightness(0),
+  _lastPinBrightness(0),
+  _waitingBrightness(0),
+  _switchTimeMs(0),
+  _isMemberOutputPending(false)
+{}
+
+LEDGroup::LEDGroup(unsigned char const ledPin, unsigned char const brightness, unsigned char const maxMemberCount,
+                   const LEDTimingRanges * const timingRanges,
+                   LEDCyclicEffect * const onEffect,
+                   LEDOneShotEffect * const offToOnEffect,
+                   LEDOneShotEffect * const onToOffEffect):
+  LEDRandomLightingCycle(ledPin, brightness, timingRanges, onEffect, offToOnEffect, onToOffEffect),
+  _memberPins(new unsigned char[maxMemberCount]),
+  _memberOffsetsMs(new unsigned short[maxMemberCount]),
+  _maxMemberCount(maxMemberCount),
+  _memberCount(0),
+  _joinedCount(0),
+  _wasActive(isOutputActive()),
+  _lastOutputBrightness(0),
+  _lastPinBrightness(0),
+  _waitingBrightness(0),
+  _switchTimeMs(0),
+  _isMemberOutputPending(false)
+{}
+
+bool LEDGroup::addMember(unsigned char const ledPin, unsigned short const offsetMs) {
+  if (_memberCount >= _maxMemberCount) {
+    return false;
+  }
+
+  //inserting would mix up waiting and joined members
+  joinWaitingMembers(_lastOutputBrightness);
+
+  //keep the offsets sorted, so joining members are always at the start of the waiting range
+  unsigned char memberIndex = _memberCount;
+  while (memberIndex && (_memberOffsetsMs[memberIndex - 1] > offsetMs)) {
+    _memberPins[memberIndex] = _memberPins[memberIndex - 1];
+    _memberOffsetsMs[memberIndex] = _memberOffsetsMs[memberIndex - 1];
+    memberIndex--;
+  }
+  _memberPins[memberIndex] = ledPin;
+  _memberOffsetsMs[memberIndex] = offsetMs;
+  _memberCount++;
+  _joinedCount = _memberCount;
+
+  pinMode(ledPin, OUTPUT);
+  setMemberOutput(memberIndex, 0, _lastOutputBrightness);
+  return true;
+}
+
+void LEDGroup::setMemberOutput(unsigned char const memberIndex, unsigned char const oldBrightness, unsigned char const brightness) {
+  if (_powerBudget && (oldBrightness != brightness)) {
+    //only changes touch the running total of the budget
+    _powerBudget->changeLoad((unsigned int)oldBrightness * _currentMa, (unsigned int)brightness * _currentMa);
+  }
+
+  if (_isOutputDeferred) {
+    _isMemberOutputPending = true;
+  }
+  else {
+    analogWrite(_memberPins[memberIndex], _powerBudget ? _powerBudget->scale(brightness) : brightness);
+  }
+}
+
+void LEDGroup::writeMemberPin(unsigned char const memberIndex) const {
+  //joined members show the leader, waiting members keep the brightness from before the switch
+  unsigned char brightness = (memberIndex < _joinedCount) ? _outputBrightness : _waitingBrightness;
+  if (_powerBudget) {
+    brightness = _powerBudget->scale(brightness);
+  }
+  analogWrite(_memberPins[memberIndex], brightness);
+}
+
+void LEDGroup::updateOutput() {
+  LEDRandomLightingCycle::updateOutput();
+  if (not _isMemberOutputPending) {
+    return;
+  }
+
+  for (unsigned char memberIndex = 0; memberIndex < _memberCount; memberIndex++) {
+    writeMemberPin(memberIndex);
+  }
+  _isMemberOutputPending = false;
+}
+
+void LEDGroup::joinWaitingMembers(unsigned char const brightness) {
+  for (; _joinedCount < _memberCount; _joinedCount++) {
+    setMemberOutput(_joinedCount, _waitingBrightness, brightness);
+  }
+}
+
+void LEDGroup::execute() {
+  LEDRandomLightingCycle::execute();
+  const unsigned long currentTimeMs = millis();
+
+  const bool isActive = isOutputActive();
+  if (isActive != _wasActive) {
+    //the leader switched, all members wait for their delay again
+    joinWaitingMembers(_lastOutputBrightness);
+    _wasActive = isActive;
+    _waitingBrightness = _lastOutputBrightness;
+    _joinedCount = 0;
+    _switchTimeMs = currentTimeMs;
+  }
+
+  //joined members only need to be written when the leader changes, including changes of the power budget
+  const unsigned char pinBrightness = getPinBrightness();
+  if ((_outputBrightness != _lastOutputBrightness) || (pinBrightness != _lastPinBrightness)) {
+    for (unsigned char memberIndex = 0; memberIndex < _joinedCount; memberIndex++) {
+      setMemberOutput(memberIndex, _lastOutputBrightness, _outputBrightness);
+    }
+  }
+
+  const unsigned long elapsedMs = currentTimeMs - _switchTimeMs;
+  while ((_joinedCount < _memberCount) && (_memberOffsetsMs[_joinedCount] <= elapsedMs)) {
+    setMemberOutput(_joinedCount, _waitingBrightness, _outputBrightness);
+    _joinedCount++;
+  }
+
+  _lastOutputBrightness = _outputBrightness;
+  _lastPinBrightness = pinBrightness;
+}
+
+unsigned int LEDGroup::getUpdateIntervalMs() const {
+  const unsigned int intervalMs = LEDRandomLightingCycle::getUpdateIntervalMs();
+  if (_joinedCount >= _memberCount) {
+    return intervalMs;
+  }
+
+  const unsigned long elapsedMs = millis() - _switchTimeMs;
+  const unsigned short offsetMs = _memberOffsetsMs[_joinedCount];
+  const unsigned long timeToJoinMs = (offsetMs > elapsedMs) ? (offsetMs - elapsedMs) : 0;
+  return (timeToJoinMs < intervalMs) ? timeToJoinMs : intervalMs;
+}
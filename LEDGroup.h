@@ -0,0 +1,166 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef LEDGROUP_H
+#define LEDGROUP_H
+
+#include "LEDLightingCycle.h"
+
+/**
+  @brief Random lighting cycle switching a group of outputs together, e.g. all windows of a floor.
+
+  The group makes one switching decision for all outputs. Its own pin is the leader, further outputs are added
+  with #addMember() and follow the leader after a delay measured from each switch of the leader:
+  ```
+  LEDGroup * floor1 = new LEDGroup(PWM_PIN0, 255, 3, 60000, 120000, 30000, 60000, new LEDCyclicEffect(), new FluorescentStartEffect(500, 2000));
+  floor1->addMember(PWM_PIN1, 400);
+  floor1->addMember(PWM_PIN2, 1500);
+  floor1->addMember(PWM_PIN3, 900);
+  ```
+  Members share the effects of the leader. A member that has joined shows the brightness of the leader, a member
+  still waiting for its delay keeps the brightness the group had before the switch.
+
+  The offsets only delay the handover to the leader, the transition of the leader is not replayed for each member.
+  In the example above the member with 400 ms joins during the start flicker and flickers in lockstep with the leader,
+  the members with 900 and 1500 ms may join after the flicker has ended and switch on without it. Transition effects
+  keep their own random state, so a delayed copy would need an effect per member. Use a LEDChainedCycle with its own
+  effects for outputs that need an individual transition.
+
+  Member pins are only written when the brightness of the leader changes or when a member joins, so the cost of
+  #execute() depends on the number of members that change and not on the size of the group.
+  Members take the output path of the leader: they follow its dithered brightness, and while the output is deferred
+  by an LEDFrameEngine they are written together with the leader by #updateOutput().
+  Members are attached to the power budget of the group when they are added, so call setPowerBudget() first.
+*/
+class LEDGroup : public LEDRandomLightingCycle {
+  private:
+    ///output pins of the members
+    unsigned char * const _memberPins;
+    ///delays of the members after a switch of the leader in ms, sorted ascending
+    unsigned short * const _memberOffsetsMs;
+    ///maximum number of members
+    const unsigned char _maxMemberCount;
+    ///number of added members
+    unsigned char _memberCount;
+    ///number of members following the leader, members from this index on still wait for their delay
+    unsigned char _joinedCount;
+    ///true if the output of the leader was active on the last execution
+    bool _wasActive;
+    ///brightness requested by the leader on the last execution
+    unsigned char _lastOutputBrightness;
+    ///pin brightness of the leader on the last execution
+    unsigned char _lastPinBrightness;
+    ///brightness of the members still waiting for their delay
+    unsigned char _waitingBrightness;
+    ///time of the last switch of the leader in ms
+    unsigned long _switchTimeMs;
+    ///true if a member changed while the output is deferred, so #updateOutput() needs to write the members
+    bool _isMemberOutputPending;
+
+    /**
+      @brief writes the current brightness of a member to its pin, used by #updateOutput() for deferred outputs
+
+      @param memberIndex index of the member
+    */
+    void writeMemberPin(unsigned char const memberIndex) const;
+
+    /**
+      @brief changes the brightness of a member
+
+      @param memberIndex index of the member
+      @param oldBrightness brightness the member showed so far, used for the power budget
+      @param brightness new brightness of the member
+    */
+    void setMemberOutput(unsigned char const memberIndex, unsigned char const oldBrightness, unsigned char const brightness);
+
+    /**
+      @brief lets all members waiting for their delay join the leader immediately
+
+      @param brightness brightness of the members following the leader
+    */
+    void joinWaitingMembers(unsigned char const brightness);
+
+  public:
+    /**
+      @brief Creates a new LEDGroup object.
+
+      @param ledPin number of the pin of the leader. Arduino defines like LED_BUILTIN are allowed
+      @param brightness sets the PWM duty cycle from 0 (off) to 255 (full brightness)
+      @param maxMemberCount maximum number of members added with #addMember()
+      @param onTimeMinMs Minimum on (active) time in ms
+      @param onTimeMaxMs Maximum on (active) time in ms
+      @param offTimeMinMs Minimum off (inactive) time in ms
+      @param offTimeMaxMs Maximum off (inactive) time in ms
+      @param onEffect sets the effect class to use when the output is active
+      @param offToOnEffect set the effect class to use when the output state transitions from CYCLE_OFF to CYCLE_ON
+      @param onToOffEffect set the effect class to use when the output state transitions from CYCLE_ON to CYCLE_OFF
+    */
+    LEDGroup(unsigned char const ledPin, unsigned char const brightness, unsigned char const maxMemberCount,
+             unsigned long const onTimeMinMs, unsigned long const onTimeMaxMs,
+             unsigned long const offTimeMinMs, unsigned long const offTimeMaxMs,
+             LEDCyclicEffect * const onEffect = new LEDCyclicEffect(),
+             LEDOneShotEffect * const offToOnEffect = 0,
+             LEDOneShotEffect * const onToOffEffect = 0);
+
+    /**
+      @brief Creates a new LEDGroup object with timing ranges located in flash.
+
+      The switch on range of \p timingRanges is used as off time, the switch off range as on time.
+
+      @param ledPin number of the pin of the leader. Arduino defines like LED_BUILTIN are allowed
+      @param brightness sets the PWM duty cycle from 0 (off) to 255 (full brightness)
+      @param maxMemberCount maximum number of members added with #addMember()
+      @param timingRanges off and on times, declared with PROGMEM
+      @param onEffect sets the effect class to use when the output is active
+      @param offToOnEffect set the effect class to use when the output state transitions from CYCLE_OFF to CYCLE_ON
+      @param onToOffEffect set the effect class to use when the output state transitions from CYCLE_ON to CYCLE_OFF
+    */
+    LEDGroup(unsigned char const ledPin, unsigned char const brightness, unsigned char const maxMemberCount,
+             const LEDTimingRanges * const timingRanges,
+             LEDCyclicEffect * const onEffect = new LEDCyclicEffect(),
+             LEDOneShotEffect * const offToOnEffect = 0,
+             LEDOneShotEffect * const onToOffEffect = 0);
+
+    /**
+      @brief adds an output to the group
+
+      The member shows the current brightness of the group right away.
+
+      @param ledPin number of the pin of the member
+      @param offsetMs delay in ms after each switch of the leader before the member takes over the brightness of the leader
+      @return false if the group already has \p maxMemberCount members
+    */
+    bool addMember(unsigned char const ledPin, unsigned short const offsetMs);
+
+    /**
+      @brief Executes the output cycle code and updates the members.
+    */
+    void execute();
+
+    /**
+      @brief writes the requested brightness to the pins of the leader and of the members
+    */
+    void updateOutput();
+
+    /**
+      @brief returns the update interval, limited to the time left until the next member joins
+
+      @return update interval in ms
+    */
+    unsigned int getUpdateIntervalMs() const;
+};
+
+#endif
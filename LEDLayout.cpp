@@ -0,0 +1,65 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "LEDLayout.h"
+#include <new>
+
+//steady on effect without state, shared by all lights of all layouts
+static LEDCyclicEffect steadyEffect;
+
+void LEDLayout::create(const LEDLightDefinition * const layout, unsigned char const lightCount, LEDStaticLighting ** const lights,
+                       unsigned char * storage) {
+  for (unsigned char lightIndex = 0; lightIndex < lightCount; lightIndex++) {
+    //the definition is copied to the stack, the light keeps referencing its timing ranges in flash
+    LEDLightDefinition light;
+    memcpy_P(&light, &layout[lightIndex], sizeof(light));
+    const LEDTimingRanges * const timingRanges = &layout[lightIndex].timingRanges;
+
+    //the lighting cycle is placed first and its transitions follow, getLightSize() counts the same objects
+    unsigned char * const lightStorage = storage;
+    storage += getCycleSize(light);
+    LEDOneShotEffect * const offToOnEffect = createTransition(light.offToOn, true, storage);
+    LEDOneShotEffect * const onToOffEffect = createTransition(light.onToOff, false, storage);
+
+    switch (light.type) {
+      case LIGHT_RANDOM:
+        lights[lightIndex] = new (lightStorage) LEDRandomLightingCycle(light.pin, light.brightness, timingRanges, &steadyEffect,
+            offToOnEffect, onToOffEffect);
+        break;
+      case LIGHT_CHAINED:
+        lights[lightIndex] = new (lightStorage) LEDChainedCycle(light.pin, light.brightness, lights[light.masterIndex], timingRanges, &steadyEffect,
+            offToOnEffect, onToOffEffect);
+        break;
+      default:
+        lights[lightIndex] = new (lightStorage) LEDStaticLighting(light.pin, light.brightness, LEDStaticLighting::CYCLE_ON, &steadyEffect);
+        break;
+    }
+  }
+}
+
+LEDOneShotEffect * LEDLayout::createTransition(const LEDTransitionDefinition & transition, bool const isOffToOn, unsigned char * & storage) {
+  unsigned char * const effectStorage = storage;
+  storage += getTransitionSize(transition);
+
+  switch (transition.type) {
+    case TRANSITION_FADE:
+      return new (effectStorage) FadeEffect(transition.durationMs, isOffToOn ? FadeEffect::FADE_IN : FadeEffect::FADE_OUT);
+    case TRANSITION_FLUORESCENT:
+      return new (effectStorage) FluorescentStartEffect(transition.minDurationMs, transition.durationMs);
+    default:
+      return 0;
+  }
+}
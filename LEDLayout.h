@@ -0,0 +1,336 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef LEDLAYOUT_H
+#define LEDLAYOUT_H
+
+#include "LEDLightingCycle.h"
+#include <Arduino.h>
+
+/**
+  @brief Static RAM receiving the lights and effects of a layout table.
+
+  Declare it with #LED_LAYOUT_STORAGE(), which computes \p Size from the table.
+*/
+template <unsigned int Size> struct LEDLayoutStorage {
+  ///bytes receiving the objects, aligned for all classes created by LEDLayout
+  alignas(LEDChainedCycle) alignas(LEDRandomLightingCycle) alignas(FadeEffect) alignas(FluorescentStartEffect) unsigned char bytes[Size];
+};
+
+/**
+  @brief Transition of a light in a layout table.
+
+  Use LEDLayout::fade() and LEDLayout::fluorescentStart() to create the values.
+*/
+struct LEDTransitionDefinition {
+  ///one of LEDLayout::TransitionTypes
+  unsigned char type;
+  ///minimum duration in ms, only used by fluorescent starts
+  unsigned short minDurationMs;
+  ///duration in ms
+  unsigned short durationMs;
+};
+
+/**
+  @brief Light in a layout table.
+
+  Use LEDLayout::staticLight(), LEDLayout::randomCycle() and LEDLayout::chainedCycle() to create the values.
+*/
+struct LEDLightDefinition {
+  ///one of LEDLayout::LightTypes
+  unsigned char type;
+  ///pin number of the output
+  unsigned char pin;
+  ///PWM duty cycle from 0 (off) to 255 (full brightness)
+  unsigned char brightness;
+  ///index of the master light of a chained cycle
+  unsigned char masterIndex;
+  ///timing ranges of lighting cycles, used directly from flash
+  LEDTimingRanges timingRanges;
+  ///effect used when the output transitions from CYCLE_OFF to CYCLE_ON
+  LEDTransitionDefinition offToOn;
+  ///effect used when the output transitions from CYCLE_ON to CYCLE_OFF
+  LEDTransitionDefinition onToOff;
+};
+
+/**
+  @brief Layout tables checked by the compiler and stored in flash.
+
+  A layout declares all lights of a sketch in one constexpr table. #LED_LAYOUT_CHECK() rejects wrong pins,
+  timing ranges with min > max and chained cycles that come before their master when the sketch is compiled:
+  ```
+  constexpr LEDLightDefinition yardOffice[] PROGMEM = {
+    LEDLayout::staticLight(3, 255),
+    LEDLayout::randomCycle(9, 255, 5 * 60 * 1000ul, 10 * 60 * 1000ul, 5 * 60 * 1000ul, 10 * 60 * 1000ul,
+                           LEDLayout::fluorescentStart(500, 4000), LEDLayout::fade(50)),
+    LEDLayout::chainedCycle(10, 255, 1, 30 * 1000ul, 2 * 60 * 1000ul, 2 * 60 * 1000ul, 10 * 60 * 1000ul,
+                            LEDLayout::fluorescentStart(500, 2000), LEDLayout::fade(50))
+  };
+  LED_LAYOUT_CHECK(yardOffice);
+
+  LEDStaticLighting * ledSetups[LED_LAYOUT_SIZE(yardOffice)];
+  LED_LAYOUT_STORAGE(yardOffice) yardOfficeStorage;
+
+  void setup() {
+    LEDLayout::create(yardOffice, ledSetups, yardOfficeStorage);
+  }
+  ```
+  The table stays in flash and the timing ranges are referenced in flash instead of being copied to RAM.
+  #create() places the light and effect objects into the static storage declared with #LED_LAYOUT_STORAGE(),
+  which is sized from the table when the sketch is compiled. Startup does not allocate from the heap and the RAM
+  of the lights is reported with the global variables by the compiler. The constructors still run in #create(),
+  because the objects hold the mutable state of the lights and set the pin modes. All steady lights share one
+  stateless LEDCyclicEffect.
+*/
+class LEDLayout {
+  public:
+    ///Types of lights in a layout table
+    enum LightTypes {
+      ///LEDStaticLighting
+      LIGHT_STATIC,
+      ///LEDRandomLightingCycle
+      LIGHT_RANDOM,
+      ///LEDChainedCycle
+      LIGHT_CHAINED
+    };
+
+    ///Types of transitions in a layout table
+    enum TransitionTypes {
+      ///the output switches immediately
+      TRANSITION_NONE,
+      ///FadeEffect in the direction of the transition
+      TRANSITION_FADE,
+      ///FluorescentStartEffect
+      TRANSITION_FLUORESCENT
+    };
+
+    /**
+      @brief returns a transition switching immediately
+
+      @return transition definition
+    */
+    static constexpr LEDTransitionDefinition noTransition() {
+      return LEDTransitionDefinition{TRANSITION_NONE, 0, 0};
+    }
+
+    /**
+      @brief returns a fade, fading in when switching on and fading out when switching off
+
+      @param durationMs fade duration in ms
+      @return transition definition
+    */
+    static constexpr LEDTransitionDefinition fade(unsigned short const durationMs) {
+      return LEDTransitionDefinition{TRANSITION_FADE, durationMs, durationMs};
+    }
+
+    /**
+      @brief returns a fluorescent start, see FluorescentStartEffect
+
+      @param minDurationMs minimum effect duration in ms
+      @param maxDurationMs maximum effect duration in ms
+      @return transition definition
+    */
+    static constexpr LEDTransitionDefinition fluorescentStart(unsigned short const minDurationMs, unsigned short const maxDurationMs) {
+      return LEDTransitionDefinition{TRANSITION_FLUORESCENT, minDurationMs, maxDurationMs};
+    }
+
+    /**
+      @brief returns a light that is always on, see LEDStaticLighting
+
+      @param pin number of the output pin
+      @param brightness PWM duty cycle from 0 (off) to 255 (full brightness)
+      @return light definition
+    */
+    static constexpr LEDLightDefinition staticLight(unsigned char const pin, unsigned char const brightness) {
+      return LEDLightDefinition{LIGHT_STATIC, pin, brightness, 0, {0, 0, 0, 0}, noTransition(), noTransition()};
+    }
+
+    /**
+      @brief returns a light switching after random times, see LEDRandomLightingCycle
+
+      @param pin number of the output pin
+      @param brightness PWM duty cycle from 0 (off) to 255 (full brightness)
+      @param onTimeMinMs Minimum on (active) time in ms
+      @param onTimeMaxMs Maximum on (active) time in ms
+      @param offTimeMinMs Minimum off (inactive) time in ms
+      @param offTimeMaxMs Maximum off (inactive) time in ms
+      @param offToOn transition when switching on
+      @param onToOff transition when switching off
+      @return light definition
+    */
+    static constexpr LEDLightDefinition randomCycle(unsigned char const pin, unsigned char const brightness,
+        unsigned long const onTimeMinMs, unsigned long const onTimeMaxMs,
+        unsigned long const offTimeMinMs, unsigned long const offTimeMaxMs,
+        const LEDTransitionDefinition offToOn = noTransition(), const LEDTransitionDefinition onToOff = noTransition()) {
+      //the switch on range is the off time, the switch off range is the on time
+      return LEDLightDefinition{LIGHT_RANDOM, pin, brightness, 0, {offTimeMinMs, offTimeMaxMs, onTimeMinMs, onTimeMaxMs}, offToOn, onToOff};
+    }
+
+    /**
+      @brief returns a light switching on after its master, see LEDChainedCycle
+
+      @param pin number of the output pin
+      @param brightness PWM duty cycle from 0 (off) to 255 (full brightness)
+      @param masterIndex index of the master light in the layout, the master has to come first
+      @param onDelayMinMs minimum delay in ms after the master switched on
+      @param onDelayMaxMs maximum delay in ms after the master switched on
+      @param onTimeMinMs Minimum on (active) time in ms
+      @param onTimeMaxMs Maximum on (active) time in ms
+      @param offToOn transition when switching on
+      @param onToOff transition when switching off
+      @return light definition
+    */
+    static constexpr LEDLightDefinition chainedCycle(unsigned char const pin, unsigned char const brightness, unsigned char const masterIndex,
+        unsigned long const onDelayMinMs, unsigned long const onDelayMaxMs,
+        unsigned long const onTimeMinMs, unsigned long const onTimeMaxMs,
+        const LEDTransitionDefinition offToOn = noTransition(), const LEDTransitionDefinition onToOff = noTransition()) {
+      return LEDLightDefinition{LIGHT_CHAINED, pin, brightness, masterIndex, {onDelayMinMs, onDelayMaxMs, onTimeMinMs, onTimeMaxMs}, offToOn, onToOff};
+    }
+
+    /**
+      @brief checks whether the pin of \p light can show the brightness levels the light needs
+
+      Lights with transitions or a brightness other than 0 and 255 need a PWM pin.
+
+      @param light light definition
+      @return true if the pin is valid
+    */
+    static constexpr bool isValidPin(const LEDLightDefinition & light) {
+#if defined(NUM_DIGITAL_PINS) && defined(digitalPinHasPWM)
+      return (light.pin < NUM_DIGITAL_PINS)
+             && (digitalPinHasPWM(light.pin)
+                 || (((light.brightness == 0) || (light.brightness == 255))
+                     && (light.offToOn.type == TRANSITION_NONE) && (light.onToOff.type == TRANSITION_NONE)));
+#else
+      return ((void)light, true);
+#endif
+    }
+
+    /**
+      @brief checks that all minimum durations of \p light are not larger than their maximum
+
+      @param light light definition
+      @return true if all ranges are valid
+    */
+    static constexpr bool isValidRange(const LEDLightDefinition & light) {
+      return (light.timingRanges.switchOnMinMs <= light.timingRanges.switchOnMaxMs)
+             && (light.timingRanges.switchOffMinMs <= light.timingRanges.switchOffMaxMs)
+             && (light.offToOn.minDurationMs <= light.offToOn.durationMs)
+             && (light.onToOff.minDurationMs <= light.onToOff.durationMs);
+    }
+
+    /**
+      @brief checks that a chained cycle comes after its master, so the master is created first
+
+      @param light light definition
+      @param index index of \p light in the layout
+      @return true if the light is no chained cycle or its master comes first
+    */
+    static constexpr bool isValidChain(const LEDLightDefinition & light, unsigned char const index) {
+      return (light.type != LIGHT_CHAINED) || (light.masterIndex < index);
+    }
+
+    ///@return true if all lights of \p layout from \p index on have valid pins
+    template <unsigned char N> static constexpr bool hasValidPins(const LEDLightDefinition (&layout)[N], unsigned char const index = 0) {
+      return (index >= N) || (isValidPin(layout[index]) && hasValidPins(layout, index + 1));
+    }
+
+    ///@return true if all lights of \p layout from \p index on have valid ranges
+    template <unsigned char N> static constexpr bool hasValidRanges(const LEDLightDefinition (&layout)[N], unsigned char const index = 0) {
+      return (index >= N) || (isValidRange(layout[index]) && hasValidRanges(layout, index + 1));
+    }
+
+    ///@return true if all chained cycles of \p layout from \p index on come after their master
+    template <unsigned char N> static constexpr bool hasValidChains(const LEDLightDefinition (&layout)[N], unsigned char const index = 0) {
+      return (index >= N) || (isValidChain(layout[index], index) && hasValidChains(layout, index + 1));
+    }
+
+    ///@return \p size rounded up to the alignment of LEDLayoutStorage
+    static constexpr unsigned int getObjectSize(unsigned int const size) {
+      return (size + alignof(LEDLayoutStorage<1>) - 1) / alignof(LEDLayoutStorage<1>) * alignof(LEDLayoutStorage<1>);
+    }
+
+    ///@return bytes of storage used by the effect of \p transition
+    static constexpr unsigned int getTransitionSize(const LEDTransitionDefinition & transition) {
+      return (transition.type == TRANSITION_FADE) ? getObjectSize(sizeof(FadeEffect))
+             : (transition.type == TRANSITION_FLUORESCENT) ? getObjectSize(sizeof(FluorescentStartEffect)) : 0;
+    }
+
+    ///@return bytes of storage used by the lighting cycle of \p light without its transitions
+    static constexpr unsigned int getCycleSize(const LEDLightDefinition & light) {
+      return getObjectSize((light.type == LIGHT_RANDOM) ? sizeof(LEDRandomLightingCycle)
+                           : (light.type == LIGHT_CHAINED) ? sizeof(LEDChainedCycle) : sizeof(LEDStaticLighting));
+    }
+
+    ///@return bytes of storage used by \p light and its transitions
+    static constexpr unsigned int getLightSize(const LEDLightDefinition & light) {
+      return getCycleSize(light) + getTransitionSize(light.offToOn) + getTransitionSize(light.onToOff);
+    }
+
+    ///@return bytes of storage used by all lights of \p layout from \p index on
+    template <unsigned char N> static constexpr unsigned int getStorageSize(const LEDLightDefinition (&layout)[N], unsigned char const index = 0) {
+      return (index >= N) ? 0 : (getLightSize(layout[index]) + getStorageSize(layout, index + 1));
+    }
+
+    /**
+      @brief creates the lights of a layout table located in flash
+
+      @param layout layout table declared with PROGMEM
+      @param lightCount number of lights in \p layout
+      @param lights receives \p lightCount lights
+      @param storage static RAM of at least #getStorageSize() bytes receiving the lights and effects
+    */
+    static void create(const LEDLightDefinition * const layout, unsigned char const lightCount, LEDStaticLighting ** const lights,
+                       unsigned char * storage);
+
+    /**
+      @brief creates the lights of a layout table located in flash
+
+      @param layout layout table declared with PROGMEM
+      @param lights receives one light per entry of \p layout
+      @param storage storage declared with #LED_LAYOUT_STORAGE() for \p layout
+    */
+    template <unsigned char N, unsigned int Size> static void create(const LEDLightDefinition (&layout)[N], LEDStaticLighting * (&lights)[N],
+        LEDLayoutStorage<Size> & storage) {
+      create(layout, N, lights, storage.bytes);
+    }
+
+  private:
+    /**
+      @brief creates the effect of a transition
+
+      @param transition transition definition in RAM
+      @param isOffToOn true for the transition from CYCLE_OFF to CYCLE_ON
+      @param storage next free byte of the storage, advanced past the effect
+      @return new effect or 0 for TRANSITION_NONE
+    */
+    static LEDOneShotEffect * createTransition(const LEDTransitionDefinition & transition, bool const isOffToOn, unsigned char * & storage);
+};
+
+///number of lights in a layout table
+#define LED_LAYOUT_SIZE(layout) (sizeof(layout) / sizeof(LEDLightDefinition))
+
+///type of the static storage for the lights and effects of a constexpr layout table
+#define LED_LAYOUT_STORAGE(layout) LEDLayoutStorage<LEDLayout::getStorageSize(layout)>
+
+///checks a constexpr layout table when the sketch is compiled
+#define LED_LAYOUT_CHECK(layout) \
+  static_assert(LED_LAYOUT_SIZE(layout) < 256, #layout ": too many lights"); \
+  static_assert(LEDLayout::hasValidPins(layout), #layout ": pin does not exist or can not dim the light"); \
+  static_assert(LEDLayout::hasValidRanges(layout), #layout ": minimum time is larger than maximum time"); \
+  static_assert(LEDLayout::hasValidChains(layout), #layout ": chained cycle comes before its master")
+
+#endif
@@ -26,14 +26,24 @@ LEDStaticLighting::LEDStaticLighting(unsigned char const ledPin,
                                      LEDCyclicEffect * const onEffect,
                                      LEDOneShotEffect * const offToOnEffect,
                                      LEDOneShotEffect * const onToOffEffect):
+  _currentState(initialState),
   _brightness(brightness),
   _ledPin(ledPin),
-  _currentState(initialState),
-  _onEffect(onEffect),
   _offToOnEffect(offToOnEffect),
-  _onToOffEffect(onToOffEffect)
+  _onToOffEffect(onToOffEffect),
+  _onEffect(onEffect),
+  _powerBudget(0),
+  _currentMa(0),
+  _outputBrightness(0),
+  _writtenBrightness(0),
+  _isUpdateRequested(false),
+  _isOutputDeferred(false),
+  _ditherFlags(0),
+  _ditherError(0)
 {
-  pinMode(_ledPin, OUTPUT);
+  if (_ledPin != LED_NO_PIN) {
+    pinMode(_ledPin, OUTPUT);
+  }
 }
 
 void LEDStaticLighting::execute() {
@@ -49,12 +59,138 @@ void LEDStaticLighting::execute() {
   }
 }
 
+void LEDStaticLighting::setOutput(unsigned char const brightness) {
+  if (_powerBudget && (brightness != _outputBrightness)) {
+    //only changes touch the running total of the budget
+    _powerBudget->changeLoad(_outputBrightness * _currentMa, brightness * _currentMa);
+  }
+
+  _outputBrightness = brightness;
+
+  if (not _isOutputDeferred) {
+    updateOutput();
+  }
+}
+
+void LEDStaticLighting::setOutputFromEffect(LEDLightingEffect * const effect) {
+  if (not (_ditherFlags & DITHER_ENABLED)) {
+    setOutput(effect->getBrightness(_brightness));
+    return;
+  }
+
+  const unsigned short brightness = effect->getBrightness16(_brightness);
+  if (brightness & 0xFF) {
+    _ditherFlags |= DITHER_ACTIVE;
+  }
+  else {
+    _ditherFlags &= ~DITHER_ACTIVE;
+  }
+
+  //first order sigma-delta: the high byte is the output, the low byte carries the error to the next execution
+  //brightness is at most 0xFF00, so adding the error can not overflow
+  const unsigned short ditheredBrightness = brightness + _ditherError;
+  _ditherError = ditheredBrightness & 0xFF;
+  setOutput(ditheredBrightness >> 8);
+}
+
+void LEDStaticLighting::updateOutput() {
+  _writtenBrightness = getPinBrightness();
+  if (_ledPin != LED_NO_PIN) {
+    analogWrite(_ledPin, _writtenBrightness);
+  }
+}
+
+bool LEDStaticLighting::isOutputScaleChanged() const {
+  return _powerBudget && (_powerBudget->scale(_outputBrightness) != _writtenBrightness);
+}
+
+bool LEDStaticLighting::isUpdateRequested() const {
+  return _isUpdateRequested || isOutputScaleChanged();
+}
+
+void LEDStaticLighting::setUpdateRequested(bool const isRequested) {
+  _isUpdateRequested = isRequested;
+}
+
+unsigned char LEDStaticLighting::getPinBrightness() const {
+  if (_powerBudget) {
+    return _powerBudget->scale(_outputBrightness);
+  }
+
+  return _outputBrightness;
+}
+
+void LEDStaticLighting::setOutputDeferred(bool const isDeferred) {
+  _isOutputDeferred = isDeferred;
+}
+
+void LEDStaticLighting::setDithering(bool const isDithered) {
+  _ditherFlags = isDithered ? DITHER_ENABLED : 0;
+  _ditherError = 0;
+}
+
+void LEDStaticLighting::setPowerBudget(LEDPowerBudget * const powerBudget, unsigned char const currentMa) {
+  if (_powerBudget) {
+    //remove the load from the previous budget
+    _powerBudget->changeLoad(_outputBrightness * _currentMa, 0);
+  }
+
+  _powerBudget = powerBudget;
+  _currentMa = currentMa;
+
+  if (_powerBudget) {
+    _powerBudget->changeLoad(0, _outputBrightness * _currentMa);
+  }
+}
+
+void LEDStaticLighting::setState(const CycleStates state) {
+  if ((state == CYCLE_OFF_TO_ON) || (state == CYCLE_ON_TO_OFF)) {
+    resetTransitions();
+  }
+  _currentState = state;
+  _isUpdateRequested = true;
+}
+
+void LEDStaticLighting::setBrightness(unsigned char const brightness) {
+  _brightness = brightness;
+  _isUpdateRequested = true;
+}
+
+unsigned char LEDStaticLighting::getBrightness() const {
+  return _brightness;
+}
+
+void LEDStaticLighting::setOnEffect(LEDCyclicEffect * const onEffect) {
+  _onEffect = onEffect;
+  _isUpdateRequested = true;
+}
+
+LEDCyclicEffect * LEDStaticLighting::getOnEffect() const {
+  return _onEffect;
+}
+
+bool LEDStaticLighting::getTimingRanges(LEDTimingRanges &) const {
+  return false;
+}
+
+bool LEDStaticLighting::setTimingRanges(const LEDTimingRanges &) {
+  return false;
+}
+
+unsigned char LEDStaticLighting::getPin() const {
+  return _ledPin;
+}
+
+unsigned char LEDStaticLighting::getOutputBrightness() const {
+  return _outputBrightness;
+}
+
 void LEDStaticLighting::lightOn() {
-  analogWrite(_ledPin, _onEffect->getBrightness(_brightness));
+  setOutputFromEffect(_onEffect);
 }
 
 void LEDStaticLighting::lightOff() {
-  digitalWrite(_ledPin, LOW);
+  setOutput(0);
 }
 
 void LEDStaticLighting::resetTransitions() {
@@ -72,7 +208,7 @@ bool LEDStaticLighting::lightOffToOn() {
     return 1;
   }
 
-  analogWrite(_ledPin, _offToOnEffect->getBrightness(_brightness));
+  setOutputFromEffect(_offToOnEffect);
 
   return _offToOnEffect->isFinished();
 }
@@ -83,7 +219,7 @@ bool LEDStaticLighting::lightOnToOff() {
     return 1;
   }
 
-  analogWrite(_ledPin, _onToOffEffect->getBrightness(_brightness));
+  setOutputFromEffect(_onToOffEffect);
 
   return _onToOffEffect->isFinished();
 }
@@ -92,6 +228,228 @@ bool LEDStaticLighting::isOutputActive() const {
   return (_currentState == CYCLE_ON) || (_currentState == CYCLE_OFF_TO_ON);
 }
 
+bool LEDStaticLighting::isInTransition() const {
+  return (_currentState == CYCLE_OFF_TO_ON) || (_currentState == CYCLE_ON_TO_OFF);
+}
+
+LEDStaticLighting::CycleStates LEDStaticLighting::getState() const {
+  return (CycleStates)_currentState;
+}
+
+unsigned int LEDStaticLighting::getUpdateIntervalMs() const {
+  switch (_currentState) {
+    case CYCLE_OFF:
+      return LED_UPDATE_INTERVAL_STEADY_MS;
+    case CYCLE_ON:
+      if (_ditherFlags & DITHER_ACTIVE) {
+        //the output alternates between two values on every execution
+        return 0;
+      }
+      return _onEffect->getUpdateIntervalMs();
+    case CYCLE_OFF_TO_ON:
+      //transitions are updated as often as their effect changes, which is as often as possible for most effects
+      return (_offToOnEffect && not (_ditherFlags & DITHER_ACTIVE)) ? _offToOnEffect->getUpdateIntervalMs() : 0;
+    case CYCLE_ON_TO_OFF:
+      return (_onToOffEffect && not (_ditherFlags & DITHER_ACTIVE)) ? _onToOffEffect->getUpdateIntervalMs() : 0;
+    default:
+      return 0;
+  }
+}
+
+/*
+  LEDTimedCycle
+*/
+//the longest range may use a quarter of the 16 bit tick range, leaving room for late checks of the switch time
+#define TIMING_MAX_RANGE_TICKS 0x4000
+
+//number of distinct timing ranges in ms that are stored without a heap allocation
+#define TIMING_RANGES_POOL_SIZE 4
+
+//timing ranges passed to the constructors as times in ms, lights with equal ranges share one entry
+static LEDTimingRanges timingRangesPool[TIMING_RANGES_POOL_SIZE];
+//number of lights using each entry of timingRangesPool, 0 for free entries
+static unsigned char timingRangesUsers[TIMING_RANGES_POOL_SIZE];
+
+static bool isEqualTimingRanges(const LEDTimingRanges & first, const LEDTimingRanges & second) {
+  return (first.switchOnMinMs == second.switchOnMinMs) && (first.switchOnMaxMs == second.switchOnMaxMs)
+         && (first.switchOffMinMs == second.switchOffMinMs) && (first.switchOffMaxMs == second.switchOffMaxMs);
+}
+
+/**
+  @brief returns an entry of the pool holding \p timingRanges
+
+  Lights with equal ranges share the entry. When the pool is full the ranges are allocated on the heap.
+*/
+static const LEDTimingRanges * acquireTimingRanges(const LEDTimingRanges & timingRanges) {
+  unsigned char freeIndex = TIMING_RANGES_POOL_SIZE;
+  for (unsigned char poolIndex = 0; poolIndex < TIMING_RANGES_POOL_SIZE; poolIndex++) {
+    if (timingRangesUsers[poolIndex] == 0) {
+      if (freeIndex == TIMING_RANGES_POOL_SIZE) {
+        freeIndex = poolIndex;
+      }
+    }
+    else if ((timingRangesUsers[poolIndex] < 0xFF) && isEqualTimingRanges(timingRangesPool[poolIndex], timingRanges)) {
+      timingRangesUsers[poolIndex]++;
+      return &timingRangesPool[poolIndex];
+    }
+  }
+
+  if (freeIndex < TIMING_RANGES_POOL_SIZE) {
+    timingRangesPool[freeIndex] = timingRanges;
+    timingRangesUsers[freeIndex] = 1;
+    return &timingRangesPool[freeIndex];
+  }
+
+  return new LEDTimingRanges(timingRanges);
+}
+
+/**
+  @brief releases ranges returned by acquireTimingRanges()
+
+  @return false if the ranges have been allocated on the heap and are owned by the caller
+*/
+static bool releaseTimingRanges(const LEDTimingRanges * const timingRanges) {
+  if ((timingRanges < timingRangesPool) || (timingRanges >= timingRangesPool + TIMING_RANGES_POOL_SIZE)) {
+    return false;
+  }
+
+  timingRangesUsers[timingRanges - timingRangesPool]--;
+  return true;
+}
+
+/**
+  @brief stores timing ranges in RAM for the constructors taking the ranges as parameters
+*/
+static const LEDTimingRanges * newTimingRanges(unsigned long const switchOnMinMs, unsigned long const switchOnMaxMs,
+    unsigned long const switchOffMinMs, unsigned long const switchOffMaxMs) {
+  const LEDTimingRanges timingRanges = {switchOnMinMs, switchOnMaxMs, switchOffMinMs, switchOffMaxMs};
+  return acquireTimingRanges(timingRanges);
+}
+
+LEDTimedCycle::LEDTimedCycle(unsigned char const ledPin, unsigned char const brightness,
+                             const LEDTimingRanges * const timingRanges, bool const isInFlash,
+                             LEDCyclicEffect * const onEffect, LEDOneShotEffect * const offToOnEffect, LEDOneShotEffect * const onToOffEffect):
+  LEDStaticLighting(ledPin, brightness, CYCLE_OFF, onEffect, offToOnEffect, onToOffEffect),
+  _timingRanges(timingRanges),
+  _nextSwitchTicks(0),
+  _timingFlags(isInFlash ? TIMING_RANGES_IN_FLASH : 0)
+{
+  updateTickShift();
+}
+
+void LEDTimedCycle::updateTickShift() {
+  unsigned long longestRangeMs = readTimingRange(&_timingRanges->switchOnMaxMs);
+  const unsigned long switchOffMaxMs = readTimingRange(&_timingRanges->switchOffMaxMs);
+  if (switchOffMaxMs > longestRangeMs) {
+    longestRangeMs = switchOffMaxMs;
+  }
+
+  //use the shortest tick that fits the longest range
+  unsigned char tickShift = 0;
+  while (((longestRangeMs >> tickShift) >= TIMING_MAX_RANGE_TICKS) && (tickShift < TIMING_TICK_SHIFT_MASK)) {
+    tickShift++;
+  }
+  _timingFlags = (_timingFlags & ~TIMING_TICK_SHIFT_MASK) | tickShift;
+}
+
+void LEDTimedCycle::setState(const CycleStates state) {
+  LEDStaticLighting::setState(state);
+  stopSwitchTimer();
+}
+
+bool LEDTimedCycle::getTimingRanges(LEDTimingRanges & timingRanges) const {
+  timingRanges.switchOnMinMs = readTimingRange(&_timingRanges->switchOnMinMs);
+  timingRanges.switchOnMaxMs = readTimingRange(&_timingRanges->switchOnMaxMs);
+  timingRanges.switchOffMinMs = readTimingRange(&_timingRanges->switchOffMinMs);
+  timingRanges.switchOffMaxMs = readTimingRange(&_timingRanges->switchOffMaxMs);
+  return true;
+}
+
+bool LEDTimedCycle::setTimingRanges(const LEDTimingRanges & timingRanges) {
+  if (_timingFlags & TIMING_RANGES_IN_FLASH) {
+    return false;
+  }
+
+  //pooled ranges may be shared with other lights, ranges on the heap belong to this light and are writable
+  if (releaseTimingRanges(_timingRanges)) {
+    _timingRanges = acquireTimingRanges(timingRanges);
+  }
+  else {
+    *const_cast<LEDTimingRanges *>(_timingRanges) = timingRanges;
+  }
+
+  //keep the switch time of a running timer when the tick length changes
+  const unsigned long currentTimeMs = millis();
+  const bool isReached = isSwitchTimeReached(currentTimeMs);
+  const unsigned long switchTimeMs = currentTimeMs + getTimeToSwitchMs(currentTimeMs);
+  updateTickShift();
+  if (isSwitchTimerStarted()) {
+    const unsigned char tickShift = _timingFlags & TIMING_TICK_SHIFT_MASK;
+    if (isReached) {
+      //one tick in the past, so the timer stays elapsed
+      _nextSwitchTicks = (currentTimeMs >> tickShift) - 1;
+    }
+    else {
+      //the switch time is reached at the start of the tick after the switch tick
+      _nextSwitchTicks = (switchTimeMs - 1) >> tickShift;
+    }
+  }
+  _isUpdateRequested = true;
+  return true;
+}
+
+unsigned long LEDTimedCycle::readTimingRange(const unsigned long * const value) const {
+  if (_timingFlags & TIMING_RANGES_IN_FLASH) {
+    return pgm_read_dword(value);
+  }
+
+  return *value;
+}
+
+void LEDTimedCycle::startSwitchTimer(bool const isSwitchingOn, unsigned long const currentTimeMs) {
+  unsigned long switchDelayMs;
+  if (isSwitchingOn) {
+    switchDelayMs = random(readTimingRange(&_timingRanges->switchOnMinMs), readTimingRange(&_timingRanges->switchOnMaxMs));
+  }
+  else {
+    switchDelayMs = random(readTimingRange(&_timingRanges->switchOffMinMs), readTimingRange(&_timingRanges->switchOffMaxMs));
+  }
+
+  _nextSwitchTicks = (currentTimeMs + switchDelayMs) >> (_timingFlags & TIMING_TICK_SHIFT_MASK);
+  _timingFlags |= TIMING_SWITCH_ARMED;
+}
+
+void LEDTimedCycle::stopSwitchTimer() {
+  _timingFlags &= ~TIMING_SWITCH_ARMED;
+}
+
+bool LEDTimedCycle::isSwitchTimerStarted() const {
+  return _timingFlags & TIMING_SWITCH_ARMED;
+}
+
+bool LEDTimedCycle::isSwitchTimeReached(unsigned long const currentTimeMs) const {
+  if (not isSwitchTimerStarted()) {
+    return true;
+  }
+
+  //the signed difference stays correct when the tick counter wraps around
+  const unsigned short currentTicks = currentTimeMs >> (_timingFlags & TIMING_TICK_SHIFT_MASK);
+  return (short)(currentTicks - _nextSwitchTicks) > 0;
+}
+
+unsigned long LEDTimedCycle::getTimeToSwitchMs(unsigned long const currentTimeMs) const {
+  if (isSwitchTimeReached(currentTimeMs)) {
+    return 0;
+  }
+
+  const unsigned char tickShift = _timingFlags & TIMING_TICK_SHIFT_MASK;
+  const unsigned short currentTicks = currentTimeMs >> tickShift;
+  const unsigned short remainingTicks = _nextSwitchTicks - currentTicks;
+
+  //the switch time is reached at the start of the tick after the switch tick
+  return (((unsigned long)remainingTicks + 1) << tickShift) - (currentTimeMs & ((1ul << tickShift) - 1));
+}
+
 /*
   LEDTriggeredCycle
 */
@@ -105,12 +463,21 @@ LEDTriggeredCycle::LEDTriggeredCycle(unsigned char const ledPin,
                                      LEDCyclicEffect * const onEffect,
                                      LEDOneShotEffect * const offToOnEffect,
                                      LEDOneShotEffect * const onToOffEffect):
-  LEDStaticLighting(ledPin, brightness, CYCLE_OFF, onEffect, offToOnEffect, onToOffEffect),
-  _nextSwitchTimeMs(0),
-  _onDelayMinMs(onDelayMinMs),
-  _onDelayMaxMs(onDelayMaxMs),
-  _offDelayMinMs(offDelayMinMs),
-  _offDelayMaxMs(offDelayMaxMs),
+  LEDTimedCycle(ledPin, brightness, newTimingRanges(onDelayMinMs, onDelayMaxMs, offDelayMinMs, offDelayMaxMs), false,
+                onEffect, offToOnEffect, onToOffEffect),
+  _trigger(trigger)
+{
+
+}
+
+LEDTriggeredCycle::LEDTriggeredCycle(unsigned char const ledPin,
+                                     unsigned char const brightness,
+                                     const LEDTimingRanges * const timingRanges,
+                                     unsigned char & trigger,
+                                     LEDCyclicEffect * const onEffect,
+                                     LEDOneShotEffect * const offToOnEffect,
+                                     LEDOneShotEffect * const onToOffEffect):
+  LEDTimedCycle(ledPin, brightness, timingRanges, true, onEffect, offToOnEffect, onToOffEffect),
   _trigger(trigger)
 {
 
@@ -123,27 +490,31 @@ void LEDTriggeredCycle::execute() {
     case CYCLE_OFF:
       lightOff();
       if (_trigger) {
-        if (not _nextSwitchTimeMs) {
-          _nextSwitchTimeMs = currentTimeMs + random(_onDelayMinMs, _onDelayMaxMs);
+        if (not isSwitchTimerStarted()) {
+          startSwitchTimer(true, currentTimeMs);
         }
 
-        if ( currentTimeMs > _nextSwitchTimeMs ) {
-          _nextSwitchTimeMs = 0;
+        if ( isSwitchTimeReached(currentTimeMs) ) {
+          stopSwitchTimer();
           resetTransitions();
           _currentState = CYCLE_OFF_TO_ON;
         }
       }
+      else {
+        //a delay that was not reached when the trigger dropped starts over with the next trigger
+        stopSwitchTimer();
+      }
       break;
     case CYCLE_OFF_TO_ON:
       {
         const char isTransitionDone = lightOffToOn();
         if (not _trigger) {
-          if (not _nextSwitchTimeMs) {
-            _nextSwitchTimeMs = currentTimeMs + random(_offDelayMinMs, _offDelayMaxMs);
+          if (not isSwitchTimerStarted()) {
+            startSwitchTimer(false, currentTimeMs);
           }
 
-          if ( currentTimeMs > _nextSwitchTimeMs ) {
-            _nextSwitchTimeMs = 0;
+          if ( isSwitchTimeReached(currentTimeMs) ) {
+            stopSwitchTimer();
             resetTransitions();
             _currentState = CYCLE_ON_TO_OFF;
           }
@@ -151,35 +522,41 @@ void LEDTriggeredCycle::execute() {
             _currentState = CYCLE_ON;
           }
         }
-        else if ( isTransitionDone ) {
-          _currentState = CYCLE_ON;
+        else {
+          stopSwitchTimer();
+          if ( isTransitionDone ) {
+            _currentState = CYCLE_ON;
+          }
         }
       }
       break;
     case CYCLE_ON:
       lightOn();
       if (not _trigger) {
-        if (not _nextSwitchTimeMs) {
-          _nextSwitchTimeMs = currentTimeMs + random(_offDelayMinMs, _offDelayMaxMs);
+        if (not isSwitchTimerStarted()) {
+          startSwitchTimer(false, currentTimeMs);
         }
 
-        if ( currentTimeMs > _nextSwitchTimeMs ) {
-          _nextSwitchTimeMs = 0;
+        if ( isSwitchTimeReached(currentTimeMs) ) {
+          stopSwitchTimer();
           resetTransitions();
           _currentState = CYCLE_ON_TO_OFF;
         }
       }
+      else {
+        stopSwitchTimer();
+      }
       break;
     case CYCLE_ON_TO_OFF:
       {
         const char isTransitionDone = lightOnToOff();
         if (_trigger) {
-          if (not _nextSwitchTimeMs) {
-            _nextSwitchTimeMs = currentTimeMs + random(_onDelayMinMs, _onDelayMaxMs);
+          if (not isSwitchTimerStarted()) {
+            startSwitchTimer(true, currentTimeMs);
           }
 
-          if ( currentTimeMs > _nextSwitchTimeMs ) {
-            _nextSwitchTimeMs = 0;
+          if ( isSwitchTimeReached(currentTimeMs) ) {
+            stopSwitchTimer();
             resetTransitions();
             _currentState = CYCLE_OFF_TO_ON;
           }
@@ -187,8 +564,11 @@ void LEDTriggeredCycle::execute() {
             _currentState = CYCLE_OFF;
           }
         }
-        else if ( isTransitionDone ) {
-          _currentState = CYCLE_OFF;
+        else {
+          stopSwitchTimer();
+          if ( isTransitionDone ) {
+            _currentState = CYCLE_OFF;
+          }
         }
       }
       break;
@@ -197,6 +577,28 @@ void LEDTriggeredCycle::execute() {
   }
 }
 
+unsigned int LEDTriggeredCycle::getUpdateIntervalMs() const {
+  const unsigned int intervalMs = LEDStaticLighting::getUpdateIntervalMs();
+  const unsigned int pollIntervalMs = (intervalMs < LED_UPDATE_INTERVAL_POLL_MS) ? intervalMs : LED_UPDATE_INTERVAL_POLL_MS;
+  if (not isSwitchTimerStarted()) {
+    return pollIntervalMs;
+  }
+
+  //switch right after the delay instead of at the next poll
+  const unsigned long timeToSwitchMs = getTimeToSwitchMs(millis());
+  return (timeToSwitchMs < pollIntervalMs) ? timeToSwitchMs : pollIntervalMs;
+}
+
+bool LEDTriggeredCycle::isUpdateRequested() const {
+  if (LEDStaticLighting::isUpdateRequested()) {
+    return true;
+  }
+
+  //a running switch timer already sets the update interval
+  const bool isSwitchedOn = (_currentState == CYCLE_ON) || (_currentState == CYCLE_OFF_TO_ON);
+  return (isSwitchedOn != (_trigger != 0)) && not isSwitchTimerStarted();
+}
+
 /*
    LEDChainedCycle
 */
@@ -210,14 +612,22 @@ LEDChainedCycle::LEDChainedCycle(unsigned char const ledPin,
                                  LEDCyclicEffect * const onEffect,
                                  LEDOneShotEffect * const offToOnEffect,
                                  LEDOneShotEffect * const onToOffEffect):
-  LEDStaticLighting(ledPin, brightness, CYCLE_OFF, onEffect, offToOnEffect, onToOffEffect),
-  _onDelayMinMs(onDelayMinMs),
-  _onDelayMaxMs(onDelayMaxMs),
-  _onTimeMinMs(onTimeMinMs),
-  _onTimeMaxMs(onTimeMaxMs),
-  _masterCycle(masterCycle),
-  _nextSwitchTimeMs(0),
-  _outputWasOn(false)
+  LEDTimedCycle(ledPin, brightness, newTimingRanges(onDelayMinMs, onDelayMaxMs, onTimeMinMs, onTimeMaxMs), false,
+                onEffect, offToOnEffect, onToOffEffect),
+  _masterCycle(masterCycle)
+{
+
+}
+
+LEDChainedCycle::LEDChainedCycle(unsigned char const ledPin,
+                                 unsigned char const brightness,
+                                 LEDStaticLighting const * const  masterCycle,
+                                 const LEDTimingRanges * const timingRanges,
+                                 LEDCyclicEffect * const onEffect,
+                                 LEDOneShotEffect * const offToOnEffect,
+                                 LEDOneShotEffect * const onToOffEffect):
+  LEDTimedCycle(ledPin, brightness, timingRanges, true, onEffect, offToOnEffect, onToOffEffect),
+  _masterCycle(masterCycle)
 {
 
 }
@@ -229,21 +639,23 @@ void LEDChainedCycle::execute() {
     case CYCLE_OFF:
       lightOff();
       if (_masterCycle->isOutputActive()) {
-        if ( not _outputWasOn ) {
-          if (not _nextSwitchTimeMs) {
-            _nextSwitchTimeMs = currentTimeMs + random(_onDelayMinMs, _onDelayMaxMs);
+        if ( not (_timingFlags & OUTPUT_WAS_ON) ) {
+          if (not isSwitchTimerStarted()) {
+            startSwitchTimer(true, currentTimeMs);
           }
 
-          if ( currentTimeMs > _nextSwitchTimeMs ) {
-            _nextSwitchTimeMs = 0;
+          if ( isSwitchTimeReached(currentTimeMs) ) {
+            stopSwitchTimer();
             resetTransitions();
             _currentState = CYCLE_OFF_TO_ON;
-            _outputWasOn = true;
+            _timingFlags |= OUTPUT_WAS_ON;
           }
         }
       }
       else {
-        _outputWasOn = false;
+        //a delay that was not reached when the master switched off starts over with the next on phase
+        stopSwitchTimer();
+        _timingFlags &= ~OUTPUT_WAS_ON;
       }
       break;
     case CYCLE_OFF_TO_ON:
@@ -258,16 +670,16 @@ void LEDChainedCycle::execute() {
     case CYCLE_ON:
       lightOn();
       if (not _masterCycle->isOutputActive()) {
-        _nextSwitchTimeMs = 0;
+        stopSwitchTimer();
         resetTransitions();
         _currentState = CYCLE_ON_TO_OFF;
       } else {
-        if (not _nextSwitchTimeMs) {
-          _nextSwitchTimeMs = currentTimeMs + random(_onTimeMinMs, _onTimeMaxMs);
+        if (not isSwitchTimerStarted()) {
+          startSwitchTimer(false, currentTimeMs);
         }
 
-        if ( currentTimeMs > _nextSwitchTimeMs ) {
-          _nextSwitchTimeMs = 0;
+        if ( isSwitchTimeReached(currentTimeMs) ) {
+          stopSwitchTimer();
           resetTransitions();
           _currentState = CYCLE_ON_TO_OFF;
         }
@@ -283,6 +695,39 @@ void LEDChainedCycle::execute() {
   }
 }
 
+unsigned int LEDChainedCycle::getUpdateIntervalMs() const {
+  const unsigned int intervalMs = LEDStaticLighting::getUpdateIntervalMs();
+  if (not isSwitchTimerStarted()) {
+    return intervalMs;
+  }
+
+  //switch right after the delay or the on time
+  const unsigned long timeToSwitchMs = getTimeToSwitchMs(millis());
+  return (timeToSwitchMs < intervalMs) ? timeToSwitchMs : intervalMs;
+}
+
+bool LEDChainedCycle::isUpdateRequested() const {
+  if (LEDStaticLighting::isUpdateRequested()) {
+    return true;
+  }
+
+  const bool isMasterOn = _masterCycle->isOutputActive();
+  switch (_currentState) {
+    case CYCLE_OFF:
+      if (isMasterOn) {
+        //the on delay has to be started
+        return not (_timingFlags & OUTPUT_WAS_ON) && not isSwitchTimerStarted();
+      }
+      //a running delay has to be stopped or the next on phase of the master allowed
+      return (_timingFlags & OUTPUT_WAS_ON) || isSwitchTimerStarted();
+    case CYCLE_OFF_TO_ON:
+    case CYCLE_ON:
+      return not isMasterOn;
+    default:
+      return false;
+  }
+}
+
 /*
    LEDLightingCycle
 */
@@ -302,12 +747,16 @@ LEDRandomLightingCycle::LEDRandomLightingCycle(unsigned char const ledPin, unsig
     LEDCyclicEffect * const onEffect,
     LEDOneShotEffect * const offToOnEffect,
     LEDOneShotEffect * const onToOffEffect ):
-  LEDStaticLighting(ledPin, brightness, CYCLE_OFF, onEffect, offToOnEffect, onToOffEffect),
-  _onTimeMinMs(onTimeMinMs),
-  _onTimeMaxMs(onTimeMaxMs),
-  _offTimeMinMs(offTimeMinMs),
-  _offTimeMaxMs(offTimeMaxMs),
-  _timeOfNextSwitchMs(0)
+  LEDTimedCycle(ledPin, brightness, newTimingRanges(offTimeMinMs, offTimeMaxMs, onTimeMinMs, onTimeMaxMs), false,
+                onEffect, offToOnEffect, onToOffEffect)
+{}
+
+LEDRandomLightingCycle::LEDRandomLightingCycle(unsigned char const ledPin, unsigned char const brightness,
+    const LEDTimingRanges * const timingRanges,
+    LEDCyclicEffect * const onEffect,
+    LEDOneShotEffect * const offToOnEffect,
+    LEDOneShotEffect * const onToOffEffect ):
+  LEDTimedCycle(ledPin, brightness, timingRanges, true, onEffect, offToOnEffect, onToOffEffect)
 {}
 
 void LEDRandomLightingCycle::execute() {
@@ -317,12 +766,11 @@ void LEDRandomLightingCycle::execute() {
   switch (_currentState) {
     case CYCLE_OFF:
       lightOff();
-      if (currentTime > _timeOfNextSwitchMs) {
+      if (isSwitchTimeReached(currentTime)) {
         //time has elaped -> switch to on and calculate duration
         _currentState = CYCLE_OFF_TO_ON;
         resetTransitions();
-        _timeOfNextSwitchMs = currentTime + _onTimeMinMs
-                              + random(0, _onTimeMaxMs - _onTimeMinMs);
+        startSwitchTimer(false, currentTime);
       }
       break;
     case CYCLE_OFF_TO_ON:
@@ -332,12 +780,11 @@ void LEDRandomLightingCycle::execute() {
       break;
     case CYCLE_ON:
       lightOn();
-      if (currentTime > _timeOfNextSwitchMs) {
+      if (isSwitchTimeReached(currentTime)) {
         //time has elaped -> switch to off and calculate duration
         _currentState = CYCLE_ON_TO_OFF;
         resetTransitions();
-        _timeOfNextSwitchMs = currentTime + _offTimeMinMs
-                              + random(0, _offTimeMaxMs - _offTimeMinMs);;
+        startSwitchTimer(true, currentTime);
       }
       break;
     case CYCLE_ON_TO_OFF:
@@ -349,3 +796,20 @@ void LEDRandomLightingCycle::execute() {
       _currentState = CYCLE_OFF;
   }
 }
+
+void LEDRandomLightingCycle::setState(const CycleStates state) {
+  LEDTimedCycle::setState(state);
+
+  //the switch on range is the off time, the switch off range is the on time
+  startSwitchTimer((state == CYCLE_OFF) || (state == CYCLE_ON_TO_OFF), millis());
+}
+
+unsigned int LEDRandomLightingCycle::getUpdateIntervalMs() const {
+  const unsigned int intervalMs = LEDStaticLighting::getUpdateIntervalMs();
+  if (not intervalMs) {
+    return 0;
+  }
+
+  const unsigned long timeToSwitchMs = getTimeToSwitchMs(millis());
+  return (timeToSwitchMs < intervalMs) ? timeToSwitchMs : intervalMs;
+}
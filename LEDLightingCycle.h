@@ -18,6 +18,12 @@
 #define LEDLIGHTINGCYCLE_H
 
 #include "LEDLightingEffect.h"
+#include "LEDPowerBudget.h"
+
+//pin number of lights without an own output, e.g. lights driven by an LEDMatrixScan
+#define LED_NO_PIN 0xFF
+
+struct LEDTimingRanges;
 
 /**
    @brief Base class for lighting cycle execution.
@@ -48,7 +54,8 @@ class LEDStaticLighting {
        configured brightness if the initial state is set to CYCLE_ON. All other states will result in the output
        being turned off.
 
-       The assigned pin will be configured as OUTPUT.
+       The assigned pin will be configured as OUTPUT. Lights created with LED_NO_PIN do not touch any pin,
+       their brightness is only read by other objects like an LEDMatrixScan.
 
        @param ledPin number of the pin to be used. Arduino defines like LED_BUILTIN are allowed
        @param brightness sets the PWM duty cycle from 0 (off) to 255 (full brightness)
@@ -76,9 +83,191 @@ class LEDStaticLighting {
     */
     bool isOutputActive() const;
 
+    /**
+      @brief returns true while a transition effect is executing
+
+      @return true in the states CYCLE_OFF_TO_ON and CYCLE_ON_TO_OFF
+    */
+    bool isInTransition() const;
+
+    /**
+      @brief returns the current state of the lighting cycle
+
+      @return current state
+    */
+    CycleStates getState() const;
+
+    /**
+      @brief returns how long the light can wait before #execute() needs to be called again
+
+      Transitions use the update interval of their effect, which is 0 for effects that change all the time.
+      While the output is on, the update interval of #_onEffect is used. Otherwise #LED_UPDATE_INTERVAL_STEADY_MS is returned.
+
+      @return update interval in ms
+    */
+    virtual unsigned int getUpdateIntervalMs() const;
+
+    /**
+      @brief returns true if the light needs to be executed before its update interval has elapsed
+
+      A scheduler checks this method on every pass. Changes made with #setState(), #setBrightness(), #setOnEffect()
+      or #setTimingRanges() request an update, and so does a power budget that rescaled the output.
+
+      @return true if the light needs to be executed on the next pass
+    */
+    virtual bool isUpdateRequested() const;
+
+    /**
+      @brief requests or clears an update on the next pass of a scheduler
+
+      @param isRequested true to execute the light on the next pass, false after it has been executed
+    */
+    void setUpdateRequested(bool const isRequested);
+
+    /**
+      @brief attaches the output to a power budget
+
+      From now on every change of the output brightness updates the running total of \p powerBudget
+      and the brightness written to the pin is scaled down whenever the budget is exceeded.
+
+      @param powerBudget budget shared by all outputs on the same regulator
+      @param currentMa current drawn by the output at full brightness in mA
+    */
+    void setPowerBudget(LEDPowerBudget * const powerBudget, unsigned char const currentMa);
+
+    /**
+      @brief forces the lighting cycle into \p state
+
+      The output follows the new state on the next call of #execute(), which a scheduler makes at once. Forcing a transition state
+      plays the transition effect from the start. Lighting cycles that follow a trigger or a master cycle
+      return to the state of their trigger or master after their usual delay.
+
+      @param state new state of the lighting cycle
+    */
+    virtual void setState(const CycleStates state);
+
+    /**
+      @brief sets the brightness of the output
+
+      If effects are configured, this value is the maximum brightness of the effects.
+      The output follows the new brightness on the next call of #execute().
+
+      @param brightness PWM duty cycle from 0 (off) to 255 (full brightness)
+    */
+    void setBrightness(unsigned char const brightness);
+
+    /**
+      @brief returns the configured brightness of the output
+
+      @return brightness set in the constructor or with #setBrightness()
+    */
+    unsigned char getBrightness() const;
+
+    /**
+      @brief replaces the effect used while the output is active
+
+      Use this method to switch between effects created in setup(), e.g. from a serial console.
+
+      @param onEffect new effect to use when the output is active
+    */
+    void setOnEffect(LEDCyclicEffect * const onEffect);
+
+    /**
+      @brief returns the effect used while the output is active
+
+      @return effect used when the output is active
+    */
+    LEDCyclicEffect * getOnEffect() const;
+
+    /**
+      @brief reads the timing ranges of the lighting cycle
+
+      The default implementation returns false, since static lights have no timing ranges.
+
+      @param timingRanges receives the timing ranges
+      @return true if the lighting cycle has timing ranges
+    */
+    virtual bool getTimingRanges(LEDTimingRanges & timingRanges) const;
+
+    /**
+      @brief replaces the timing ranges of the lighting cycle
+
+      The default implementation returns false, since static lights have no timing ranges.
+
+      @param timingRanges new timing ranges
+      @return true if the timing ranges have been changed
+    */
+    virtual bool setTimingRanges(const LEDTimingRanges & timingRanges);
+
+    /**
+      @brief returns the pin number of the output
+
+      @return output pin
+    */
+    unsigned char getPin() const;
+
+    /**
+      @brief returns the brightness last requested for the output
+
+      The value does not include any scaling applied by the power budget.
+
+      @return requested output brightness
+    */
+    unsigned char getOutputBrightness() const;
+
+    /**
+      @brief returns the brightness written to the output pin
+
+      This is the requested brightness after applying the power budget.
+
+      @return output pin brightness
+    */
+    unsigned char getPinBrightness() const;
+
+    /**
+      @brief defers writing the output pin until #updateOutput() is called
+
+      Deferred outputs only store the requested brightness when the lighting cycle executes.
+      This allows a frame engine to update all outputs at once after all lights have been executed.
+
+      @param isDeferred true to defer pin writes, false to write the pin immediately
+    */
+    void setOutputDeferred(bool const isDeferred);
+
+    /**
+      @brief writes the requested brightness to the output pin
+
+      Derived classes with further outputs override this method to write them in the same pass.
+    */
+    virtual void updateOutput();
+
+    /**
+      @brief returns true if the power budget changed the pin brightness since the last #updateOutput()
+
+      The budget ramps its scale factor independently of the update interval of the light, so a scheduler
+      executes lights again when this method returns true.
+
+      @return true if the output needs to be written again
+    */
+    bool isOutputScaleChanged() const;
+
+    /**
+      @brief enables temporal dithering of the output
+
+      Dithered outputs read the brightness of the effects with 8 fractional bits and alternate between the two
+      nearest PWM values, so the average brightness over several executions matches the fractional brightness.
+      This smooths slow fades and dim levels that would otherwise show visible 8 bit steps.
+
+      The fraction is spread across executions of the light, so the light needs to be executed often, e.g. by an
+      LEDFrameEngine. While the brightness has a fraction the light requests an update interval of 0.
+
+      @param isDithered true to enable dithering, false to round down to 8 bits
+    */
+    void setDithering(bool const isDithered);
+
   protected:
-    ///current state of the output pin
-    CycleStates _currentState;
+    ///current state of the output pin, one of #CycleStates stored in a single byte
+    unsigned char _currentState;
     ///Brightness of the output pin. If effects are configured, this value is the maximum brightness.
     unsigned char _brightness;
     ///pin number of the output
@@ -89,7 +278,52 @@ class LEDStaticLighting {
     ///Effect to be used when the output transitions fron CYCLE_ON to CYCLE_OFF
     LEDOneShotEffect * const _onToOffEffect;
     ///Effect to be used when the output is active
-    LEDCyclicEffect * const _onEffect;
+    LEDCyclicEffect * _onEffect;
+
+    ///Power budget the output is attached to, 0 if the output is not limited
+    LEDPowerBudget * _powerBudget;
+    ///current drawn by the output at full brightness in mA
+    unsigned char _currentMa;
+    ///brightness last requested for the output
+    unsigned char _outputBrightness;
+    ///brightness last written by #updateOutput(), including the scaling of the power budget
+    unsigned char _writtenBrightness;
+    ///true if the light needs to be executed before its update interval has elapsed
+    bool _isUpdateRequested;
+    ///true if the output pin is only written by #updateOutput()
+    bool _isOutputDeferred;
+
+    ///Bit masks for #_ditherFlags
+    enum DitherFlags {
+      ///dithering is enabled for the output
+      DITHER_ENABLED = 0x01,
+      ///the last brightness had a fraction, so the output alternates between two values
+      DITHER_ACTIVE = 0x02
+    };
+
+    ///combination of #DitherFlags
+    unsigned char _ditherFlags;
+    ///fraction of the brightness not yet shown on the output, in 1/256 PWM steps
+    unsigned char _ditherError;
+
+    /**
+      @brief writes \p brightness to the output pin
+
+      All writes to the output pin go through this method to keep the power budget up to date.
+
+      @param brightness requested brightness of the output
+    */
+    void setOutput(unsigned char const brightness);
+
+    /**
+      @brief sets the output to the current brightness of \p effect
+
+      With dithering enabled the fraction of the brightness is added to #_ditherError and
+      the output is rounded up whenever the accumulated fraction exceeds one PWM step.
+
+      @param effect effect providing the brightness
+    */
+    void setOutputFromEffect(LEDLightingEffect * const effect);
 
     /**
       @brief Turns the output off.
@@ -131,6 +365,159 @@ class LEDStaticLighting {
     void resetTransitions();
 };
 
+/**
+  @brief Random timing ranges of a lighting cycle.
+
+  The ranges describe how long a lighting cycle waits before switching its output on or off.
+  A table of ranges can be placed in flash with PROGMEM and shared between many lighting cycles:
+  ```
+  const LEDTimingRanges officeTiming PROGMEM = {5 * 60 * 1000ul, 10 * 60 * 1000ul, 5 * 60 * 1000ul, 10 * 60 * 1000ul};
+  ```
+*/
+struct LEDTimingRanges {
+  ///minimum time in ms before the output is switched on
+  unsigned long switchOnMinMs;
+  ///maximum time in ms before the output is switched on
+  unsigned long switchOnMaxMs;
+  ///minimum time in ms before the output is switched off
+  unsigned long switchOffMinMs;
+  ///maximum time in ms before the output is switched off
+  unsigned long switchOffMaxMs;
+};
+
+/**
+  @brief Base class for lighting cycles that switch after a random time.
+
+  The timing ranges are not stored in the object itself but referenced from a LEDTimingRanges table,
+  which can be located in flash and shared by many lighting cycles.
+
+  Ranges passed to the constructors as times in ms are kept in a small static pool instead, lights with
+  equal ranges share one entry. Only when the pool is full, the ranges are allocated on the heap.
+
+  The time of the next switch is stored as a 16 bit value in ticks relative to millis().
+  The tick length is chosen from the longest range in the table, so short ranges keep millisecond precision
+  while ranges of several minutes use ticks of a few ms. A switch happens up to one tick later than the random time,
+  which is at most 1ms or 1/8192 of the longest range, e.g. 64ms for ranges of 10 minutes. The ms precision of
+  transitions is not affected, since the transition effects keep their own timing.
+*/
+class LEDTimedCycle : public LEDStaticLighting {
+  private:
+    ///timing ranges of this cycle, either in RAM or in flash
+    const LEDTimingRanges * _timingRanges;
+    ///time of the next switch in ticks
+    unsigned short _nextSwitchTicks;
+
+  protected:
+    ///Bit masks for #_timingFlags
+    enum TimingFlags {
+      ///number of bits the time in ms is shifted to get the time in ticks
+      TIMING_TICK_SHIFT_MASK = 0x0F,
+      ///the timing ranges are located in flash
+      TIMING_RANGES_IN_FLASH = 0x10,
+      ///the switch timer has been started
+      TIMING_SWITCH_ARMED = 0x20,
+      ///free flag for subclasses
+      TIMING_USER_FLAG = 0x40
+    };
+
+    ///combination of #TimingFlags
+    unsigned char _timingFlags;
+
+    /**
+      @brief creates a new LEDTimedCycle instance
+
+      @param ledPin number of the pin to be used. Arduino defines like LED_BUILTIN are allowed
+      @param brightness sets the PWM duty cycle from 0 (off) to 255 (full brightness)
+      @param timingRanges timing ranges of this cycle
+      @param isInFlash true if \p timingRanges is located in flash
+      @param onEffect sets the effect class to use when the output is active
+      @param offToOnEffect set the effect class to use when the output state transitions from CYCLE_OFF to CYCLE_ON
+      @param onToOffEffect set the effect class to use when the output state transitions from CYCLE_ON to CYCLE_OFF
+    */
+    LEDTimedCycle(unsigned char const ledPin, unsigned char const brightness,
+                  const LEDTimingRanges * const timingRanges, bool const isInFlash,
+                  LEDCyclicEffect * const onEffect, LEDOneShotEffect * const offToOnEffect, LEDOneShotEffect * const onToOffEffect);
+
+    /**
+      @brief starts the switch timer with a random time from the switch on or switch off range
+
+      @param isSwitchingOn true to use the switch on range, false to use the switch off range
+      @param currentTimeMs current time in ms as returned by millis()
+    */
+    void startSwitchTimer(bool const isSwitchingOn, unsigned long const currentTimeMs);
+
+    /**
+      @brief stops the switch timer
+    */
+    void stopSwitchTimer();
+
+    /**
+      @brief returns true if the switch timer has been started
+
+      @return true if the switch timer is running or elapsed
+    */
+    bool isSwitchTimerStarted() const;
+
+    /**
+      @brief returns true if the switch time has passed
+
+      The comparison is wraparound safe.
+
+      @param currentTimeMs current time in ms as returned by millis()
+      @return true if the switch timer has been started and its time has passed
+    */
+    bool isSwitchTimeReached(unsigned long const currentTimeMs) const;
+
+    /**
+      @brief returns the time until #isSwitchTimeReached() returns true
+
+      @param currentTimeMs current time in ms as returned by millis()
+      @return time until the switch in ms, 0 if the switch time has passed or the timer has not been started
+    */
+    unsigned long getTimeToSwitchMs(unsigned long const currentTimeMs) const;
+
+  public:
+    /**
+      @brief forces the lighting cycle into \p state and stops the switch timer
+
+      @param state new state of the lighting cycle
+    */
+    virtual void setState(const CycleStates state);
+
+    /**
+      @brief reads the timing ranges from RAM or flash
+
+      @param timingRanges receives the timing ranges
+      @return true
+    */
+    virtual bool getTimingRanges(LEDTimingRanges & timingRanges) const;
+
+    /**
+      @brief replaces the timing ranges
+
+      Only timing ranges passed to the constructor as times in ms are located in RAM and can be changed.
+      Other lights sharing the same ranges keep their ranges. A running switch timer keeps its switch time.
+
+      @param timingRanges new timing ranges
+      @return false if the timing ranges are located in flash
+    */
+    virtual bool setTimingRanges(const LEDTimingRanges & timingRanges);
+
+  private:
+    /**
+      @brief selects the tick length for the longest range of #_timingRanges
+    */
+    void updateTickShift();
+
+    /**
+      @brief reads one value of the timing ranges from RAM or flash
+
+      @param value pointer to the value within #_timingRanges
+      @return value in ms
+    */
+    unsigned long readTimingRange(const unsigned long * const value) const;
+};
+
 /**
   @brief This class watches a trigger variable to determine the on and off state of the LED
 
@@ -139,23 +526,11 @@ class LEDStaticLighting {
 
   A range for random activation or deactivation delays can be specified.
 */
-class LEDTriggeredCycle : public LEDStaticLighting {
+class LEDTriggeredCycle : public LEDTimedCycle {
   private:
     ///reference to the trigger variable
     const unsigned char & _trigger;
 
-  protected:
-    ///time for the next switch in ms
-    unsigned long _nextSwitchTimeMs;
-    ///minimum activation delay in ms
-    const unsigned long _onDelayMinMs;
-    ///maximum activation delay in ms
-    const unsigned long _onDelayMaxMs;
-    ///minimum deactivation delay in ms
-    const unsigned long _offDelayMinMs;
-    ///maximum deactivation delay in ms
-    const unsigned long _offDelayMaxMs;
-
   public:
     /**
       @brief creates a new LEDTriggeredCycle instance
@@ -178,7 +553,42 @@ class LEDTriggeredCycle : public LEDStaticLighting {
                       unsigned long const offDelayMinMs, unsigned long const offDelayMaxMs, unsigned char & trigger,
                       LEDCyclicEffect * const onEffect = new LEDCyclicEffect(), LEDOneShotEffect * const offToOnEffect = 0, LEDOneShotEffect * const onToOffEffect = 0);
 
+    /**
+      @brief creates a new LEDTriggeredCycle instance with timing ranges located in flash
+
+      The switch on range of \p timingRanges is used as activation delay, the switch off range as deactivation delay.
+
+      @param ledPin number of the pin to be used. Arduino defines like LED_BUILTIN are allowed
+      @param brightness sets the PWM duty cycle from 0 (off) to 255 (full brightness)
+      @param timingRanges activation and deactivation delays, declared with PROGMEM
+      @param trigger reference to the trigger variable
+      @param onEffect sets the effect class to use when the output is active
+      @param offToOnEffect set the effect class to use when the output state transitions from CYCLE_OFF to CYCLE_ON
+      @param onToOffEffect set the effect class to use when the output state transitions from CYCLE_ON to CYCLE_OFF
+    */
+    LEDTriggeredCycle(unsigned char const ledPin, unsigned char const brightness,
+                      const LEDTimingRanges * const timingRanges, unsigned char & trigger,
+                      LEDCyclicEffect * const onEffect = new LEDCyclicEffect(), LEDOneShotEffect * const offToOnEffect = 0, LEDOneShotEffect * const onToOffEffect = 0);
+
     virtual void execute();
+
+    /**
+      @brief returns the update interval, limited to #LED_UPDATE_INTERVAL_POLL_MS to watch the trigger variable
+
+      While a switch delay is running the interval ends at the switch time.
+
+      @return update interval in ms
+    */
+    virtual unsigned int getUpdateIntervalMs() const;
+
+    /**
+      @brief returns true if the trigger variable asks for a switch that has not been started yet
+
+      A scheduler thus reacts to a changed trigger on its next pass instead of the next poll.
+
+      @return true if the light needs to be executed on the next pass
+    */
+    virtual bool isUpdateRequested() const;
 };
 
 /**
@@ -188,24 +598,13 @@ class LEDTriggeredCycle : public LEDStaticLighting {
   This is intended to for rooms that are only accessable from other rooms in the building where
   the light should also be turned on.
 */
-class LEDChainedCycle : public LEDStaticLighting {
+class LEDChainedCycle : public LEDTimedCycle {
   private:
     ///Master lighting cycle governing this lighting cycle
     LEDStaticLighting const * const _masterCycle;
-    ///variable to remember whether this cycle was already active for the current master cycle active state
-    bool _outputWasOn;
-
-    ///time for the next switch in ms
-    unsigned long _nextSwitchTimeMs;
-    ///minimum activation delay in ms
-    const unsigned long _onDelayMinMs;
-    ///maximum activation delay in ms
-    const unsigned long _onDelayMaxMs;
-    ///Minimum on (active) time in ms
-    unsigned long _onTimeMinMs;
-    ///Maximum on (active) time in ms
-    unsigned long _onTimeMaxMs;
-    ///Minimum off (inactive) time in ms
+
+    ///flag in #_timingFlags to remember whether this cycle was already active for the current master cycle active state
+    static const unsigned char OUTPUT_WAS_ON = TIMING_USER_FLAG;
 
   public:
     /**
@@ -233,7 +632,43 @@ class LEDChainedCycle : public LEDStaticLighting {
                     const unsigned long onTimeMinMs, const unsigned long onTimeMaxMs,
                     LEDCyclicEffect * const onEffect = new LEDCyclicEffect(), LEDOneShotEffect * const offToOnEffect = 0, LEDOneShotEffect * const onToOffEffect = 0);
 
+    /**
+      @brief Creates a new LEDChainedCycle instance with timing ranges located in flash
+
+      The switch on range of \p timingRanges is used as activation delay, the switch off range as on (active) time.
+
+      @param ledPin number of the pin to be used. Arduino defines like LED_BUILTIN are allowed
+      @param brightness sets the PWM duty cycle from 0 (off) to 255 (full brightness)
+      @param masterCycle Master cycle to enable the active state of this cycle
+      @param timingRanges activation delay and on time, declared with PROGMEM
+      @param onEffect sets the effect class to use when the output is active
+      @param offToOnEffect set the effect class to use when the output state transitions from CYCLE_OFF to CYCLE_ON
+      @param onToOffEffect set the effect class to use when the output state transitions from CYCLE_ON to CYCLE_OFF
+    */
+    LEDChainedCycle(const unsigned char ledPin, const unsigned char brightness, LEDStaticLighting const * const  masterCycle,
+                    const LEDTimingRanges * const timingRanges,
+                    LEDCyclicEffect * const onEffect = new LEDCyclicEffect(), LEDOneShotEffect * const offToOnEffect = 0, LEDOneShotEffect * const onToOffEffect = 0);
+
     virtual void execute();
+
+    /**
+      @brief returns the update interval of the output
+
+      While a switch delay is running the interval ends at the switch time. Changes of the master cycle
+      are reported by #isUpdateRequested(), so the master does not need to be polled.
+
+      @return update interval in ms
+    */
+    virtual unsigned int getUpdateIntervalMs() const;
+
+    /**
+      @brief returns true if the master cycle switched in a way this cycle has not followed yet
+
+      A scheduler thus reacts to the master on its next pass.
+
+      @return true if the light needs to be executed on the next pass
+    */
+    virtual bool isUpdateRequested() const;
 };
 
 
@@ -244,19 +679,7 @@ class LEDChainedCycle : public LEDStaticLighting {
    The transition effects will always play out in full, even when they take longer than the total time alotted for the
    on or off state they are assigned to.
 */
-class LEDRandomLightingCycle: public LEDStaticLighting {
-  protected:
-    ///Minimum on (active) time in ms
-    unsigned long _onTimeMinMs;
-    ///Maximum on (active) time in ms
-    unsigned long _onTimeMaxMs;
-    ///Minimum off (inactive) time in ms
-    unsigned long _offTimeMinMs;
-    ///Maximum off (inactive) time in ms
-    unsigned long _offTimeMaxMs;
-    ///Time for the next transition from off to on or vice versa
-    unsigned long _timeOfNextSwitchMs;
-
+class LEDRandomLightingCycle: public LEDTimedCycle {
   public:
     /**
       @brief Creates a new LEDRandomLightingCycle object.
@@ -278,10 +701,44 @@ class LEDRandomLightingCycle: public LEDStaticLighting {
                            LEDOneShotEffect * const offToOnEffect = 0,
                            LEDOneShotEffect * const onToOffEffect = 0);
 
+    /**
+      @brief Creates a new LEDRandomLightingCycle object with timing ranges located in flash.
+
+      The switch on range of \p timingRanges is used as off time, the switch off range as on time.
+
+      @param ledPin number of the pin to be used. Arduino defines like LED_BUILTIN are allowed
+      @param brightness sets the PWM duty cycle from 0 (off) to 255 (full brightness)
+      @param timingRanges off and on times, declared with PROGMEM
+      @param onEffect sets the effect class to use when the output is active
+      @param offToOnEffect set the effect class to use when the output state transitions from CYCLE_OFF to CYCLE_ON
+      @param onToOffEffect set the effect class to use when the output state transitions from CYCLE_ON to CYCLE_OFF
+    */
+    LEDRandomLightingCycle(unsigned char const ledPin, unsigned char const brightness,
+                           const LEDTimingRanges * const timingRanges,
+                           LEDCyclicEffect * const onEffect = new LEDCyclicEffect(),
+                           LEDOneShotEffect * const offToOnEffect = 0,
+                           LEDOneShotEffect * const onToOffEffect = 0);
+
     /**
       @brief Executes the output cycle code.
     */
     void execute();
+
+    /**
+      @brief forces the lighting cycle into \p state
+
+      The lighting cycle stays in the new state for a random time from the range of that state and then continues to cycle.
+
+      @param state new state of the lighting cycle
+    */
+    void setState(const CycleStates state);
+
+    /**
+      @brief returns the update interval, limited to the time left until the next switch
+
+      @return update interval in ms
+    */
+    unsigned int getUpdateIntervalMs() const;
 };
 
 /**
@@ -15,12 +15,21 @@
     along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
 */
 #include "LEDLightingEffect.h"
+#include "LEDCoroutine.h"
 #include <Arduino.h>
 
 unsigned char LEDLightingEffect::getBrightness( unsigned char const maxBrightness) {
   return maxBrightness;
 }
 
+unsigned short LEDLightingEffect::getBrightness16( unsigned char const maxBrightness) {
+  return (unsigned short)getBrightness(maxBrightness) << 8;
+}
+
+unsigned int LEDLightingEffect::getUpdateIntervalMs() const {
+  return LED_UPDATE_INTERVAL_STEADY_MS;
+}
+
 /*
    KEDOneShotEffect
 */
@@ -42,6 +51,10 @@ bool LEDOneShotEffect::isFinished() {
   return not getRemainingDuration(millis());
 }
 
+unsigned int LEDOneShotEffect::getUpdateIntervalMs() const {
+  return 0;
+}
+
 unsigned short LEDOneShotEffect::getRemainingDuration(const unsigned long currentTimeMs) {
   if ((_startMs + _durationMs + _startDelayMs) > currentTimeMs) {
     //safe to do the subtraction without risking wraparound
@@ -71,10 +84,14 @@ FadeEffect::FadeEffect(unsigned short const durationMs, const FadeDirections fad
 {}
 
 unsigned char FadeEffect::getBrightness( unsigned char const maxBrightness) {
+  return getBrightness16(maxBrightness) >> 8;
+}
+
+unsigned short FadeEffect::getBrightness16( unsigned char const maxBrightness) {
   const unsigned long currentTimeMs = millis();
   if (getRemainingStartDelay(currentTimeMs)) {
     if ( _fadeDirection == FADE_OUT ) {
-      return maxBrightness;
+      return (unsigned short)maxBrightness << 8;
     }
     else {
       return 0;
@@ -82,10 +99,13 @@ unsigned char FadeEffect::getBrightness( unsigned char const maxBrightness) {
   }
 
   float fadeProgressPercent = (currentTimeMs - (_startMs + _startDelayMs)) / (float)_durationMs;
+  if (fadeProgressPercent > 1) {
+    fadeProgressPercent = 1;
+  }
   if ( _fadeDirection == FADE_OUT ) {
     fadeProgressPercent = 1 - fadeProgressPercent;
   }
-  return fadeProgressPercent * maxBrightness;
+  return fadeProgressPercent * ((unsigned short)maxBrightness << 8);
 }
 
 /*
@@ -102,10 +122,11 @@ FluorescentStartEffect::FluorescentStartEffect(unsigned short const minDurationM
     unsigned short const durationMs,
     const unsigned short maxStartDelayMs):
   LEDOneShotEffect(durationMs, maxStartDelayMs),
+  _resumeState(LED_COROUTINE_START),
+  _stageStartTimeMs(0),
+  _stageDurationMs(0),
   _minDurationMs(minDurationMs),
-  _currentStageStartTimeMs(0),
-  _currentStageDurationMs(0),
-  _currentStage(START_UNINITIALIZED)
+  _isFloating(false)
 {}
 
 unsigned short FluorescentStartEffect::getRemainingDuration(const unsigned long currentTimeMs) {
@@ -118,159 +139,348 @@ unsigned short FluorescentStartEffect::getRemainingDuration(const unsigned long
   return 0;
 }
 
-FluorescentStartEffect::EffectStages FluorescentStartEffect::getNextStage(const unsigned long currentTimeMs) {
-  EffectStages nextStage = START_ON; //default stage if something weird happens...
-  const long randomNumber = random(0, 10);
-  unsigned char isFloatAllowed = 0;
+void FluorescentStartEffect::startStage(const unsigned long currentTimeMs, unsigned short const durationMs) {
+  _stageStartTimeMs = currentTimeMs;
+  _stageDurationMs = durationMs;
+}
 
+bool FluorescentStartEffect::isStageRunning(const unsigned long currentTimeMs) const {
+  return currentTimeMs < (_stageStartTimeMs + _stageDurationMs);
+}
+
+bool FluorescentStartEffect::isFloatAllowed(const unsigned long currentTimeMs) const {
   const unsigned short elapsedTimeMs = currentTimeMs - (_startMs + _startDelayMs);
-  if ( elapsedTimeMs > (_currentDurationMs  / 2)) {
-    isFloatAllowed = 1;
-  }
+  return elapsedTimeMs > (_currentDurationMs / 2);
+}
 
+unsigned char FluorescentStartEffect::getBrightness( unsigned char const maxBrightness) {
+  return getBrightness16(maxBrightness) >> 8;
+}
 
-  switch (_currentStage) {
-    case START_OFF:
-      if (randomNumber < 8) {
-        nextStage = START_FLICKER;
-      }
-      else {
-        if (isFloatAllowed) {
-          nextStage = START_FLOAT;
-        }
-        else {
-          nextStage = START_FLICKER;
-        }
-      }
-      break;
-    case START_FLICKER:
-      if (randomNumber < 8) {
-        nextStage = START_OFF;
-      }
-      else {
-        if (isFloatAllowed) {
-          nextStage = START_FLOAT;
-        }
-        else {
-          nextStage = START_OFF;
-        }
-      }
-      break;
-    case START_FLOAT:
-      if (randomNumber) {
-        nextStage = START_FLICKER;
-      }
-      else {
-        nextStage = START_OFF;
-      }
-      break;
-  }
+unsigned short FluorescentStartEffect::getBrightness16( unsigned char const maxBrightness) {
+  const unsigned long currentTimeMs = millis();
+  //brightness in 8.8 fixed point
+  const unsigned short fullBrightness = (unsigned short)maxBrightness << 8;
 
-  return nextStage;
-}
+  if (getRemainingStartDelay(currentTimeMs)) {
+    return 0;
+  }
 
-void FluorescentStartEffect::setupNextStage(const unsigned long currentTimeMs) {
-  _currentStage = getNextStage(currentTimeMs);
-  _currentStageStartTimeMs = currentTimeMs;
+  if (not getRemainingDuration(currentTimeMs)) {
+    //solid on once the duration of the current execution has elapsed
+    return fullBrightness;
+  }
 
-  switch (_currentStage) {
-    case START_OFF:
-      _currentStageDurationMs = random(START_OFF_MIN_DURATION_MS, START_OFF_MAX_DURATION_MS);
+  LED_COROUTINE_BEGIN(_resumeState);
+  _isFloating = false;
+  startStage(currentTimeMs, random(START_FLICKER_MIN_DURATION_MS, START_FLICKER_MAX_DURATION_MS));
+  while (true) {
+    //short flash at full brightness
+    LED_COROUTINE_WAIT_WHILE(_resumeState, isStageRunning(currentTimeMs), fullBrightness);
+    if ((random(0, 10) >= 8) && isFloatAllowed(currentTimeMs)) {
       break;
-    case START_FLICKER:
-      _currentStageDurationMs = random(START_FLICKER_MIN_DURATION_MS, START_FLICKER_MIN_DURATION_MS);
-      break;
-    case START_FLOAT:
-      _currentStageDurationMs = random(START_FLOAT_MIN_DURATION_MS, START_FLOAT_MAX_DURATION_MS);
-      break;
-    default: //should not happen, so just stay here for the remaining duration...
-      _currentStageDurationMs = getRemainingDuration(currentTimeMs);
+    }
+
+    //dark pause before the next flash
+    startStage(currentTimeMs, random(START_OFF_MIN_DURATION_MS, START_OFF_MAX_DURATION_MS));
+    LED_COROUTINE_WAIT_WHILE(_resumeState, isStageRunning(currentTimeMs), 0);
+    if ((random(0, 10) >= 8) && isFloatAllowed(currentTimeMs)) {
       break;
+    }
+
+    startStage(currentTimeMs, random(START_FLICKER_MIN_DURATION_MS, START_FLICKER_MAX_DURATION_MS));
   }
-}
 
-unsigned char FluorescentStartEffect::getBrightness( unsigned char const maxBrightness) {
-  unsigned long currentTimeMs = millis();
-  unsigned char brightness = 0;
+  //float at about a third of the brightness, then stay on
+  _isFloating = true;
+  startStage(currentTimeMs, random(START_FLOAT_MIN_DURATION_MS, START_FLOAT_MAX_DURATION_MS));
+  LED_COROUTINE_WAIT_WHILE(_resumeState, isStageRunning(currentTimeMs),
+                           (fullBrightness / 3) + ((fullBrightness / 10) * sin(2 * PI * (currentTimeMs % _stageDurationMs) / (float)_stageDurationMs)));
+  LED_COROUTINE_END(_resumeState);
 
-  if (getRemainingStartDelay(currentTimeMs)) {
-    return brightness;
-  }
+  return fullBrightness;
+}
 
-  if (_currentStage == START_UNINITIALIZED) {
-    _currentStage = START_FLICKER;
-    _currentStageStartTimeMs = currentTimeMs;
-    _currentStageDurationMs = random(START_FLICKER_MIN_DURATION_MS, START_FLICKER_MAX_DURATION_MS);
+unsigned int FluorescentStartEffect::getUpdateIntervalMs() const {
+  const unsigned long currentTimeMs = millis();
+  const unsigned long startTimeMs = _startMs + _startDelayMs;
+  if (startTimeMs > currentTimeMs) {
+    return startTimeMs - currentTimeMs;
   }
 
-  if (not getRemainingDuration(currentTimeMs)) {
-    //switch to solid on if the current effect duration has elapsed
-    _currentStage = START_ON;
+  //the stage of the previous execution is still set until the first call of getBrightness16() after the start delay
+  if ((_resumeState == LED_COROUTINE_START) || _isFloating) {
+    return 0;
   }
 
-  unsigned char stageTimeElaped = (currentTimeMs >= (_currentStageStartTimeMs + _currentStageDurationMs));
-  switch (_currentStage) {
-    case  START_OFF:
-      brightness = 0;
-      if (stageTimeElaped) {
-        setupNextStage(currentTimeMs);
-      }
-      break;
-    case START_FLICKER:
-      brightness = maxBrightness;
-      if (stageTimeElaped) {
-        setupNextStage(currentTimeMs);
-      }
-      break;
-    case  START_FLOAT:
-      {
-        float cycleProgressPercent = (currentTimeMs % _currentStageDurationMs) / (float)_currentStageDurationMs;
-        float rad = 2 * PI * cycleProgressPercent;
-        brightness = (maxBrightness / 3) +  ((maxBrightness / 10) * sin(rad));
-      }
-      if (stageTimeElaped) {
-        _currentStage = START_ON; //always go to on after float
-      }
-      break;
-    case START_ON:
-      //no stage time for this state
-      brightness = maxBrightness;
-      break;
-    default:
-      break;
+  //a stage that runs past the end of the effect is cut short, the light changes to solid on at the end
+  unsigned long changeTimeMs = _stageStartTimeMs + _stageDurationMs;
+  const unsigned long endTimeMs = startTimeMs + _currentDurationMs;
+  if (endTimeMs < changeTimeMs) {
+    changeTimeMs = endTimeMs;
   }
 
-  return brightness;
+  return (changeTimeMs > currentTimeMs) ? (changeTimeMs - currentTimeMs) : 0;
 }
 
 void FluorescentStartEffect::reset() {
   LEDOneShotEffect::reset(); // call parent implementation first
-  _currentStage = START_UNINITIALIZED;
+  LED_COROUTINE_RESET(_resumeState);
   _currentDurationMs = random(_minDurationMs, _durationMs);
 }
 
+/*
+   LEDCyclicEffect
+*/
+unsigned char LEDCyclicEffect::getBrightness( unsigned char const maxBrightness) {
+  const unsigned long currentTimeMs = millis();
+  unsigned char brightness;
+  getBrightnessBatch(&currentTimeMs, &maxBrightness, &brightness, 1);
+  return brightness;
+}
+
+void LEDCyclicEffect::getBrightnessBatch(unsigned long const * const, unsigned char const * const maxBrightness,
+    unsigned char * const brightness, unsigned char const count) {
+  //a steady light does not depend on time
+  for (unsigned char index = 0; index < count; index++) {
+    brightness[index] = maxBrightness[index];
+  }
+}
+
 /*
    BeaconEffect
 */
+///(1 - cos(angle)) / 2 scaled to 0..255 for 64 steps of a full turn, the extra entry simplifies the interpolation
+static const unsigned char raisedCosineTable[65] PROGMEM = {
+  0, 1, 2, 5, 10, 15, 21, 29, 37, 47, 57, 67, 79, 90, 103, 115,
+  127, 140, 152, 165, 176, 188, 198, 208, 218, 226, 234, 240, 245, 250, 253, 254,
+  255, 254, 253, 250, 245, 240, 234, 226, 218, 208, 198, 188, 176, 165, 152, 140,
+  128, 115, 103, 90, 79, 67, 57, 47, 37, 29, 21, 15, 10, 5, 2, 1,
+  0
+};
+
+/**
+  @brief returns (1 - cos(angle)) / 2 scaled to 0..255
+
+  @param angle angle with 65536 steps for a full turn
+  @return interpolated value from raisedCosineTable
+*/
+static unsigned char getRaisedCosine(unsigned short const angle) {
+  const unsigned char index = angle >> 10;
+  const unsigned char fraction = angle >> 2;
+  const int start = pgm_read_byte(&raisedCosineTable[index]);
+  const int end = pgm_read_byte(&raisedCosineTable[index + 1]);
+  return start + (((end - start) * fraction) >> 8);
+}
+
+//positions in the beacon cycle with 65536 steps per cycle
+#define BEACON_QUARTER_CYCLE 16384u
+#define BEACON_HALF_CYCLE 32768u
+#define BEACON_THREE_QUARTER_CYCLE 49152u
+//ramp angle of PI/10 with 65536 steps for a full turn
+#define BEACON_RAMP_ANGLE 3277u
+//multipliers with 16 fractional bits: ramp angle per quarter cycle (0.2) and flash angle per quarter cycle (3.6)
+#define BEACON_RAMP_SLOPE 13107ul
+#define BEACON_FLASH_SLOPE 235930ul
+
 BeaconEffect::BeaconEffect(unsigned int const cycleTimeMs):
   _cycleTimeMs(cycleTimeMs)
 {}
 
-unsigned char BeaconEffect::getBrightness( unsigned char const maxBrightness) {
-  const float rampupPercent = 0.1; //10 percent
-  const float cycleProgressPercent = (millis() % _cycleTimeMs) / (float)_cycleTimeMs;
+void BeaconEffect::getBrightnessBatch(unsigned long const * const timesMs, unsigned char const * const maxBrightness,
+                                      unsigned char * const brightness, unsigned char const count) {
+  //cycles per ms with 32 fractional bits, rounded up so exact cycle times like 1024ms stay exact
+  const unsigned long cyclesPerMs = (0xFFFFFFFFul / _cycleTimeMs) + 1;
 
-  float rad = 0;
-  if (cycleProgressPercent < 0.25) {
-    rad = PI * rampupPercent * cycleProgressPercent / 0.25; //linear ramp up from 0 to PI/10
+  for (unsigned char index = 0; index < count; index++) {
+    //the whole cycles overflow the 32 bit product, the upper 16 bits of the fraction are the position in the cycle
+    const unsigned short phase = (timesMs[index] * cyclesPerMs) >> 16;
+    getBrightnessForPhases(&phase, &maxBrightness[index], &brightness[index], 1);
   }
-  else if (cycleProgressPercent < 0.5) {
-    rad = PI * rampupPercent + (1 - rampupPercent) * (2 * PI * (cycleProgressPercent - 0.25) * 4); //*4 to squeeze the entire cosine into a quarter cycle.
+}
+
+void BeaconEffect::getBrightnessForPhases(unsigned short const * const phases, unsigned char const * const maxBrightness,
+    unsigned char * const brightness, unsigned char const count) {
+  for (unsigned char index = 0; index < count; index++) {
+    const unsigned short phase = phases[index];
+    unsigned short angle = 0;
+
+    if (phase < BEACON_QUARTER_CYCLE) {
+      //linear ramp up from 0 to PI/10
+      angle = (phase * BEACON_RAMP_SLOPE) >> 16;
+    }
+    else if (phase < BEACON_HALF_CYCLE) {
+      //the flash squeezes most of a full cosine turn into a quarter cycle
+      angle = BEACON_RAMP_ANGLE + (((phase - BEACON_QUARTER_CYCLE) * BEACON_FLASH_SLOPE) >> 16);
+    }
+    else if (phase < BEACON_THREE_QUARTER_CYCLE) {
+      //linear ramp down from PI/10 to 0
+      angle = ((BEACON_THREE_QUARTER_CYCLE - phase) * BEACON_RAMP_SLOPE) >> 16;
+    }
+
+    brightness[index] = ((unsigned int)getRaisedCosine(angle) * (maxBrightness[index] + 1)) >> 8;
+  }
+}
+
+unsigned int BeaconEffect::getUpdateIntervalMs() const {
+  const unsigned int intervalMs = _cycleTimeMs >> 8;
+  return intervalMs ? intervalMs : 1;
+}
+
+/*
+   LEDNoiseEffect
+*/
+///smoothstep 3x^2 - 2x^3 scaled to 0..255 for 64 steps between two lattice points
+static const unsigned char smoothstepTable[64] PROGMEM = {
+  0, 0, 1, 2, 3, 5, 6, 9, 11, 14, 17, 21, 24, 28, 32, 36,
+  41, 46, 51, 56, 61, 66, 72, 77, 83, 89, 94, 100, 106, 112, 118, 124,
+  131, 137, 143, 149, 155, 161, 166, 172, 178, 183, 189, 194, 199, 204, 209, 214,
+  219, 223, 227, 231, 234, 238, 241, 244, 246, 249, 250, 252, 253, 254, 255, 255
+};
+
+//distance between the seeds of two instances, the layers of an effect use the seeds in between
+#define NOISE_SEED_STEP 4
+//the update interval is the noise cell length shifted by this value
+#define NOISE_UPDATE_INTERVAL_SHIFT 5
+
+//welding: the arc burns while the slow noise is above the threshold and drops out below the dropout level
+#define WELDING_ENVELOPE_SHIFT 6
+#define WELDING_ARC_THRESHOLD 150
+#define WELDING_DROPOUT_LEVEL 24
+#define WELDING_UPDATE_INTERVAL_SHIFT 2
+
+//TV: a scene lasts for 16 noise cells
+#define TV_SCENE_SHIFT 4
+
+unsigned char LEDNoiseEffect::_nextSeed = 0;
+
+LEDNoiseEffect::LEDNoiseEffect(unsigned short const cellMs, unsigned char const intensity):
+  _cellMs((cellMs > 1) ? cellMs : 2),
+  _cellsPerMs(65536ul / _cellMs),
+  _intensity(intensity),
+  _seed(_nextSeed)
+{
+  _nextSeed += NOISE_SEED_STEP;
+}
+
+unsigned long LEDNoiseEffect::getPosition(unsigned long const timeMs) const {
+  //the product wraps around at the same time as the 16 bit lattice index, so the noise stays continuous
+  return timeMs * _cellsPerMs;
+}
+
+unsigned char LEDNoiseEffect::getLatticeValue(unsigned short const lattice, unsigned char const seed) {
+  //multiply and xorshift hash, every seed is a different offset into the same sequence
+  unsigned short value = (lattice + seed * 0x3C6Fu) * 0x9E37u;
+  value ^= value >> 7;
+  value *= 0x6A4Bu;
+  value ^= value >> 9;
+  return value >> 8;
+}
+
+unsigned char LEDNoiseEffect::getValueNoise(unsigned long const position, unsigned char const seed) {
+  const unsigned short lattice = position >> 16;
+  const unsigned char start = getLatticeValue(lattice, seed);
+  const unsigned char end = getLatticeValue(lattice + 1, seed);
+  const unsigned char weight = pgm_read_byte(&smoothstepTable[(position >> 10) & 0x3F]);
+
+  //unsigned products, 255 * 255 does not fit into a 16 bit int
+  if (end >= start) {
+    return start + (((unsigned int)(end - start) * weight) >> 8);
   }
-  else if (cycleProgressPercent < 0.75) {
-    rad = PI * rampupPercent * (0.75 - cycleProgressPercent) / 0.25; //linear ramp down from PI/10 to 0
+  return start - (((unsigned int)(start - end) * weight) >> 8);
+}
+
+unsigned char LEDNoiseEffect::applyFlicker(unsigned char const flicker, unsigned char const maxBrightness) const {
+  const unsigned char level = 255 - (((unsigned int)flicker * _intensity) >> 8);
+  return ((unsigned int)level * (maxBrightness + 1)) >> 8;
+}
+
+unsigned int LEDNoiseEffect::getUpdateIntervalMs() const {
+  const unsigned int intervalMs = _cellMs >> NOISE_UPDATE_INTERVAL_SHIFT;
+  return intervalMs ? intervalMs : 1;
+}
+
+/*
+   CandleEffect
+*/
+CandleEffect::CandleEffect(unsigned short const cellMs, unsigned char const intensity):
+  LEDNoiseEffect(cellMs, intensity)
+{}
+
+void CandleEffect::getBrightnessBatch(unsigned long const * const timesMs, unsigned char const * const maxBrightness,
+                                      unsigned char * const brightness, unsigned char const count) {
+  for (unsigned char index = 0; index < count; index++) {
+    const unsigned long position = getPosition(timesMs[index]);
+    const unsigned int noise = (3 * getValueNoise(position, _seed) + getValueNoise(position << 2, _seed + 1)) >> 2;
+    //squaring keeps the flame mostly steady with occasional dips
+    brightness[index] = applyFlicker((noise * noise) >> 8, maxBrightness[index]);
+  }
+}
+
+/*
+   FireEffect
+*/
+FireEffect::FireEffect(unsigned short const cellMs, unsigned char const intensity):
+  LEDNoiseEffect(cellMs, intensity)
+{}
+
+void FireEffect::getBrightnessBatch(unsigned long const * const timesMs, unsigned char const * const maxBrightness,
+                                    unsigned char * const brightness, unsigned char const count) {
+  for (unsigned char index = 0; index < count; index++) {
+    const unsigned long position = getPosition(timesMs[index]);
+    const unsigned int noise = 2 * getValueNoise(position, _seed)
+                                 + getValueNoise(position << 1, _seed + 1)
+                                 + getValueNoise(position << 2, _seed + 2);
+    brightness[index] = applyFlicker(noise >> 2, maxBrightness[index]);
+  }
+}
+
+/*
+   WeldingEffect
+*/
+WeldingEffect::WeldingEffect(unsigned short const cellMs, unsigned char const intensity):
+  LEDNoiseEffect(cellMs, intensity)
+{}
+
+void WeldingEffect::getBrightnessBatch(unsigned long const * const timesMs, unsigned char const * const maxBrightness,
+                                       unsigned char * const brightness, unsigned char const count) {
+  //the slow layer uses its own multiplier, so it wraps around together with its lattice index as well
+  const unsigned short envelopeCellsPerMs = (_cellsPerMs >> WELDING_ENVELOPE_SHIFT) | 1;
+
+  for (unsigned char index = 0; index < count; index++) {
+    brightness[index] = 0;
+    if (getValueNoise(timesMs[index] * envelopeCellsPerMs, _seed + 1) < WELDING_ARC_THRESHOLD) {
+      continue;
+    }
+
+    //the arc changes in steps without interpolation
+    const unsigned char arc = getLatticeValue(getPosition(timesMs[index]) >> 16, _seed);
+    if (arc >= WELDING_DROPOUT_LEVEL) {
+      brightness[index] = applyFlicker(arc, maxBrightness[index]);
+    }
+  }
+}
+
+unsigned int WeldingEffect::getUpdateIntervalMs() const {
+  const unsigned int intervalMs = _cellMs >> WELDING_UPDATE_INTERVAL_SHIFT;
+  return intervalMs ? intervalMs : 1;
+}
+
+/*
+   TVEffect
+*/
+TVEffect::TVEffect(unsigned short const cellMs, unsigned char const intensity):
+  LEDNoiseEffect(cellMs, intensity)
+{}
+
+void TVEffect::getBrightnessBatch(unsigned long const * const timesMs, unsigned char const * const maxBrightness,
+                                  unsigned char * const brightness, unsigned char const count) {
+  const unsigned short sceneCellsPerMs = (_cellsPerMs >> TV_SCENE_SHIFT) | 1;
+
+  for (unsigned char index = 0; index < count; index++) {
+    //scene cuts change the brightness in steps, the picture content varies smoothly within a scene
+    const unsigned char scene = getLatticeValue((timesMs[index] * sceneCellsPerMs) >> 16, _seed + 1);
+    const unsigned char content = getValueNoise(getPosition(timesMs[index]), _seed);
+    brightness[index] = applyFlicker((3 * scene + content) >> 2, maxBrightness[index]);
   }
-  rad -= PI;
-  double cosine = cos(rad) * 0.5   + 0.5;
-  return (cosine) * maxBrightness;
 }
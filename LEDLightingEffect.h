@@ -17,6 +17,11 @@
 #ifndef LEDLIGHTINGEFFECT_H
 #define LEDLIGHTINGEFFECT_H
 
+///Update interval in ms for effects and lights that do not change on their own
+#define LED_UPDATE_INTERVAL_STEADY_MS 1000
+///Update interval in ms for lights that need to watch inputs or other lights
+#define LED_UPDATE_INTERVAL_POLL_MS 100
+
 /**
    @brief Base class for all lighting effects
 */
@@ -31,6 +36,28 @@ class LEDLightingEffect {
       @return current output brightness
     */
     virtual unsigned char getBrightness( unsigned char const maxBrightness);
+
+    /**
+      @brief returns the current brightness for the output with 8 additional fractional bits
+
+      The high byte is the brightness returned by #getBrightness(), the low byte holds the fraction lost when rounding
+      down to 8 bits. Lights with dithering enabled use this value to show brightness levels between two PWM steps.
+      The default implementation returns the result of #getBrightness() without fraction.
+
+      @param maxBrightness max allowed brightness for the output
+      @return current output brightness in 8.8 fixed point
+    */
+    virtual unsigned short getBrightness16( unsigned char const maxBrightness);
+
+    /**
+      @brief returns how often the brightness of the effect changes
+
+      Lighting schedulers use this value to skip updates of lights that would not change.
+      The default implementation returns #LED_UPDATE_INTERVAL_STEADY_MS.
+
+      @return update interval in ms, 0 if the effect needs to be updated as often as possible
+    */
+    virtual unsigned int getUpdateIntervalMs() const;
 };
 
 /**
@@ -92,6 +119,13 @@ class LEDOneShotEffect : public LEDLightingEffect {
     */
     bool isFinished();
 
+    /**
+      @brief returns 0, transitions are updated as often as possible
+
+      @return 0
+    */
+    unsigned int getUpdateIntervalMs() const;
+
     /**
       @brief creates a new LEDOneShotEffect object
 
@@ -124,6 +158,7 @@ class FadeEffect : public LEDOneShotEffect {
     FadeEffect(unsigned short const durationMs, const FadeDirections fadeDirection, const unsigned short maxStartDelayMs = 0);
 
     unsigned char getBrightness( unsigned char const maxBrightness);
+    unsigned short getBrightness16( unsigned char const maxBrightness);
   private:
     ///direction of the fade effect, either FADE_IN or FADE_OUT
     const FadeDirections _fadeDirection;
@@ -134,50 +169,48 @@ class FadeEffect : public LEDOneShotEffect {
 */
 class FluorescentStartEffect : public LEDOneShotEffect {
   private:
-    ///Enumeration for the internal effect states
-    enum EffectStages {
-      ///Initial stage to randomly decide the start stage
-      START_UNINITIALIZED,
-      ///The light is off for a short period of time
-      START_OFF,
-      ///The light is on at full brightness for a short period of time
-      START_FLICKER,
-      ///The light floats at about half brightness
-      START_FLOAT,
-      ///The light is on at full brightness, no other stages are selected after this stage
-      START_ON
-    };
-
+    ///resume state of the coroutine in #getBrightness16(), see LEDCoroutine.h
+    unsigned short _resumeState;
     ///start time of the current stage in ms
-    unsigned long _currentStageStartTimeMs;
+    unsigned long _stageStartTimeMs;
     /**
       @brief duration of the current stage in ms
 
       The duration of the current stage extend beyond the total duration of the effect. The current stage will be cut short in this case.
     */
-    unsigned short _currentStageDurationMs;
-    ///type of the current effect stage
-    EffectStages _currentStage;
+    unsigned short _stageDurationMs;
     ///duration of the current execution cycle of the effect in ms
     unsigned short _currentDurationMs;
     ///minimum duration of the effect in ms
     const unsigned short _minDurationMs;
+    ///true during the last stage, when the brightness floats instead of staying constant
+    bool _isFloating;
 
     /**
-      @brief returns the next stage of the effects
+      @brief starts the next stage of the effect
+
+      @param currentTimeMs current time in ms as returned by millis()
+      @param durationMs duration of the stage in ms
+    */
+    void startStage(const unsigned long currentTimeMs, unsigned short const durationMs);
 
-      The permissible stages can vary depending on the amount of the effect has already been running.
-      The next stage is determined randomly out of the pool of permissible stages.
+    /**
+      @brief returns true until the duration of the current stage has elapsed
 
       @param currentTimeMs current time in ms as returned by millis()
-      @return the next stage to be executed
+      @return true while the stage is running
     */
-    EffectStages getNextStage(const unsigned long currentTimeMs);
+    bool isStageRunning(const unsigned long currentTimeMs) const;
 
     /**
-      @brief prepares the next stage execution
+      @brief returns true if the light may float at reduced brightness after the current stage
+
+      Floating is allowed once half of the duration of the current execution has elapsed.
+
+      @param currentTimeMs current time in ms as returned by millis()
+      @return true if floating is allowed
     */
-    void setupNextStage(const unsigned long currentTimeMs);
+    bool isFloatAllowed(const unsigned long currentTimeMs) const;
 
   protected:
     /**
@@ -203,6 +236,17 @@ class FluorescentStartEffect : public LEDOneShotEffect {
     */
     FluorescentStartEffect(unsigned short const minDurationMs, unsigned short const maxDurationMs, const unsigned short maxStartDelayMs = 0);
     unsigned char getBrightness( unsigned char const maxBrightness);
+    unsigned short getBrightness16( unsigned char const maxBrightness);
+
+    /**
+      @brief returns the time until the brightness changes
+
+      The flashes and dark pauses keep a constant brightness, so the light only needs to be updated at the end of the stage.
+      While the light floats at reduced brightness it is updated as often as possible.
+
+      @return time until the end of the start delay or the current flash or pause in ms, 0 while floating
+    */
+    unsigned int getUpdateIntervalMs() const;
 
     /**
       @brief resets the effect for the next effect execution cycle
@@ -214,9 +258,36 @@ class FluorescentStartEffect : public LEDOneShotEffect {
 
 /**
   @brief Base class for permanent light effects
+
+  Permanent effects do not depend on when the output was switched on, their brightness is a function of time only.
+  This allows evaluating the same effect for many lights at different times in one call of #getBrightnessBatch().
 */
 class LEDCyclicEffect : public LEDLightingEffect {
+  public:
+    /**
+      @brief returns the current brightness for the output
+
+      Calls #getBrightnessBatch() for the current time, so derived effects only implement the batch.
+
+      @param maxBrightness max allowed brightness for the output
+      @return current output brightness
+    */
+    unsigned char getBrightness( unsigned char const maxBrightness);
+
+    /**
+      @brief computes the brightness of the effect for several points in time
+
+      Lights sharing the same effect type with different phases can be evaluated in one call by passing
+      the current time shifted by the phase of each light. The default implementation is a steady light,
+      it copies \p maxBrightness for every point in time. Derived effects that change over time override it.
 
+      @param timesMs array of \p count times in ms as returned by millis()
+      @param maxBrightness array of \p count max allowed brightness values
+      @param brightness array of \p count output brightness values
+      @param count number of elements in each array
+    */
+    virtual void getBrightnessBatch(unsigned long const * const timesMs, unsigned char const * const maxBrightness,
+                                    unsigned char * const brightness, unsigned char const count);
 };
 
 /**
@@ -236,13 +307,246 @@ class BeaconEffect : public LEDCyclicEffect {
     BeaconEffect(unsigned int const cycleTimeMs);
 
     /**
-      @brief returns the current brightness for the output
+      @brief computes the beacon brightness for several points in time
+
+      The position in the cycle is computed with one multiplication per point in time, the reciprocal
+      of the cycle time is computed once per call.
+
+      @param timesMs array of \p count times in ms as returned by millis()
+      @param maxBrightness array of \p count max allowed brightness values
+      @param brightness array of \p count output brightness values
+      @param count number of elements in each array
+    */
+    void getBrightnessBatch(unsigned long const * const timesMs, unsigned char const * const maxBrightness,
+                            unsigned char * const brightness, unsigned char const count);
+
+    /**
+      @brief computes the beacon brightness for several positions in the beacon cycle
+
+      This method can be used for beacons with different cycle times, as the position in the cycle is passed directly.
+      It uses integer math and a lookup table only.
+
+      @param phases array of \p count positions in the beacon cycle, 0 is the start and 65535 the end of the cycle
+      @param maxBrightness array of \p count max allowed brightness values
+      @param brightness array of \p count output brightness values
+      @param count number of elements in each array
+    */
+    static void getBrightnessForPhases(unsigned short const * const phases, unsigned char const * const maxBrightness,
+                                       unsigned char * const brightness, unsigned char const count);
+
+    /**
+      @brief returns the update interval for a smooth rotation
+
+      @return 1/256 of the cycle time in ms
+    */
+    unsigned int getUpdateIntervalMs() const;
+};
+
+/**
+  @brief Base class for flicker effects based on value noise
+
+  The brightness follows random values placed on a lattice in time, with smooth transitions between
+  the lattice points. The random values are computed from the lattice index with an integer hash,
+  so the effect is a function of time only and can be evaluated for several lights with #getBrightnessBatch().
+  No float math and no division is used while the effect is running.
+
+  Each instance uses a different sequence of random values, so lights sharing the same parameters do not flicker in sync.
+*/
+class LEDNoiseEffect : public LEDCyclicEffect {
+  protected:
+    ///length of one noise cell in ms, the time between two random values
+    const unsigned short _cellMs;
+    ///noise cells per ms with 16 fractional bits
+    const unsigned short _cellsPerMs;
+    ///depth of the flicker, 0 for no flicker and 255 for flicker down to dark
+    const unsigned char _intensity;
+    ///selects the sequence of random values of this instance
+    const unsigned char _seed;
+
+    ///seed of the next instance
+    static unsigned char _nextSeed;
 
-      Computes the current brightness of the output based on \p maxBrightness and the current position in the beacon cycle.
+    /**
+      @brief converts a time into a noise position
+
+      @param timeMs time in ms as returned by millis()
+      @return position with the noise cell in the upper 16 bits and the position in the cell in the lower 16 bits
+    */
+    unsigned long getPosition(unsigned long const timeMs) const;
+
+    /**
+      @brief returns a random value for a lattice point
+
+      @param lattice index of the lattice point
+      @param seed sequence of random values
+      @return random value between 0 and 255
+    */
+    static unsigned char getLatticeValue(unsigned short const lattice, unsigned char const seed);
+
+    /**
+      @brief returns the value noise at a position
+
+      Interpolates between the random values of the surrounding lattice points with a smoothstep lookup table.
+
+      @param position position as returned by #getPosition()
+      @param seed sequence of random values
+      @return noise value between 0 and 255
+    */
+    static unsigned char getValueNoise(unsigned long const position, unsigned char const seed);
+
+    /**
+      @brief scales \p maxBrightness by the flicker
+
+      @param flicker flicker value between 0 and 255, 255 dims the output by #_intensity
       @param maxBrightness max allowed brightness for the output
-      @return current output brightness
+      @return output brightness
     */
-    unsigned char getBrightness( unsigned char const maxBrightness);
+    unsigned char applyFlicker(unsigned char const flicker, unsigned char const maxBrightness) const;
+
+  public:
+    /**
+      @brief creates a new LEDNoiseEffect instance
+
+      @param cellMs time between two random values in ms, smaller values result in faster flicker
+      @param intensity depth of the flicker, 0 for no flicker and 255 for flicker down to dark
+    */
+    LEDNoiseEffect(unsigned short const cellMs, unsigned char const intensity);
+
+    /**
+      @brief computes the flicker for several points in time, implemented by each flicker effect
+
+      @param timesMs array of \p count times in ms as returned by millis()
+      @param maxBrightness array of \p count max allowed brightness values
+      @param brightness array of \p count output brightness values
+      @param count number of elements in each array
+    */
+    virtual void getBrightnessBatch(unsigned long const * const timesMs, unsigned char const * const maxBrightness,
+                                    unsigned char * const brightness, unsigned char const count) = 0;
+
+    /**
+      @brief returns an update interval fast enough for smooth flicker
+
+      @return 1/32 of the noise cell length in ms
+    */
+    unsigned int getUpdateIntervalMs() const;
+};
+
+/**
+  @brief Cyclic effect class for emulating a candle
+
+  A slow gentle flicker with a small amount of faster flicker on top.
+*/
+class CandleEffect : public LEDNoiseEffect {
+  public:
+    /**
+      @brief creates a new CandleEffect instance
+
+      @param cellMs time between two random values in ms
+      @param intensity depth of the flicker, 0 for no flicker and 255 for flicker down to dark
+    */
+    CandleEffect(unsigned short const cellMs = 120, unsigned char const intensity = 80);
+
+    /**
+      @brief computes the candle brightness for several points in time
+
+      @param timesMs array of \p count times in ms as returned by millis()
+      @param maxBrightness array of \p count max allowed brightness values
+      @param brightness array of \p count output brightness values
+      @param count number of elements in each array
+    */
+    void getBrightnessBatch(unsigned long const * const timesMs, unsigned char const * const maxBrightness,
+                            unsigned char * const brightness, unsigned char const count);
+};
+
+/**
+  @brief Cyclic effect class for emulating a fireplace or a fire
+
+  Three layers of flicker with increasing speed, deeper and livelier than a candle.
+*/
+class FireEffect : public LEDNoiseEffect {
+  public:
+    /**
+      @brief creates a new FireEffect instance
+
+      @param cellMs time between two random values of the slowest layer in ms
+      @param intensity depth of the flicker, 0 for no flicker and 255 for flicker down to dark
+    */
+    FireEffect(unsigned short const cellMs = 200, unsigned char const intensity = 160);
+
+    /**
+      @brief computes the fire brightness for several points in time
+
+      @param timesMs array of \p count times in ms as returned by millis()
+      @param maxBrightness array of \p count max allowed brightness values
+      @param brightness array of \p count output brightness values
+      @param count number of elements in each array
+    */
+    void getBrightnessBatch(unsigned long const * const timesMs, unsigned char const * const maxBrightness,
+                            unsigned char * const brightness, unsigned char const count);
+};
+
+/**
+  @brief Cyclic effect class for emulating an arc welder
+
+  The arc is struck for a few seconds at random, then pauses. While the arc is burning
+  it flickers fast and drops out briefly from time to time.
+*/
+class WeldingEffect : public LEDNoiseEffect {
+  public:
+    /**
+      @brief creates a new WeldingEffect instance
+
+      @param cellMs time between two random values of the arc flicker in ms, the welding and pause periods are 64 times longer
+      @param intensity depth of the arc flicker, 0 for a steady arc and 255 for flicker down to dark
+    */
+    WeldingEffect(unsigned short const cellMs = 40, unsigned char const intensity = 192);
+
+    /**
+      @brief returns the update interval of the arc flicker
+
+      The arc flicker changes in steps, so fewer updates are needed than for the smooth flicker of the other effects.
+
+      @return 1/4 of the noise cell length in ms
+    */
+    unsigned int getUpdateIntervalMs() const;
+
+    /**
+      @brief computes the welding brightness for several points in time
+
+      @param timesMs array of \p count times in ms as returned by millis()
+      @param maxBrightness array of \p count max allowed brightness values
+      @param brightness array of \p count output brightness values
+      @param count number of elements in each array
+    */
+    void getBrightnessBatch(unsigned long const * const timesMs, unsigned char const * const maxBrightness,
+                            unsigned char * const brightness, unsigned char const count);
+};
+
+/**
+  @brief Cyclic effect class for emulating the light of a TV set
+
+  The brightness changes abruptly with every scene cut and varies slightly within a scene.
+*/
+class TVEffect : public LEDNoiseEffect {
+  public:
+    /**
+      @brief creates a new TVEffect instance
+
+      @param cellMs time between two random values of the variation within a scene in ms, scenes are 16 times longer
+      @param intensity difference between bright and dark scenes, 255 allows scenes down to dark
+    */
+    TVEffect(unsigned short const cellMs = 250, unsigned char const intensity = 192);
+
+    /**
+      @brief computes the TV brightness for several points in time
+
+      @param timesMs array of \p count times in ms as returned by millis()
+      @param maxBrightness array of \p count max allowed brightness values
+      @param brightness array of \p count output brightness values
+      @param count number of elements in each array
+    */
+    void getBrightnessBatch(unsigned long const * const timesMs, unsigned char const * const maxBrightness,
+                            unsigned char * const brightness, unsigned char const count);
 };
 
 #endif
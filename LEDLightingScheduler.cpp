@@ -0,0 +1,301 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "LEDLightingScheduler.h"
+#include <Arduino.h>
+
+#ifdef __AVR__
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+
+///millis() counter of the Arduino core, corrected after power down sleeps
+extern volatile unsigned long timer0_millis;
+///timer 0 overflows counted by the Arduino core for micros(), corrected after power down sleeps
+extern volatile unsigned long timer0_overflow_count;
+
+///time of one timer 0 overflow in us
+#define TIMER0_OVERFLOW_US clockCyclesToMicroseconds(64 * 256)
+
+///nominal watchdog periods in ms, the index is the watchdog prescaler setting
+static const unsigned int watchdogPeriodsMs[] = {16, 32, 64, 125, 250, 500, 1000, 2000, 4000, 8000};
+#define WATCHDOG_PERIOD_COUNT (sizeof(watchdogPeriodsMs) / sizeof(watchdogPeriodsMs[0]))
+
+///set by the watchdog interrupt to tell a watchdog wake up from other interrupts
+static volatile bool isWatchdogWakeUp = false;
+///time slept in power down that is not yet added to timer0_overflow_count in us
+static unsigned int sleptOverflowRemainderUs = 0;
+#endif
+
+//lowest quality level, update intervals are multiplied by up to 2^SCHEDULER_MAX_QUALITY_LEVEL
+#define SCHEDULER_MAX_QUALITY_LEVEL 3
+//number of calls within the frame budget before the quality is raised by one level
+#define SCHEDULER_RECOVERY_FRAMES 32
+
+volatile bool LEDLightingScheduler::_isWakeUpRequested = false;
+unsigned char LEDLightingScheduler::_powerDownBlockCount = 0;
+
+LEDLightingScheduler::LEDLightingScheduler(LEDStaticLighting * const * const lights, unsigned char const lightCount):
+  _lights(lights),
+  _lightCount(lightCount),
+  _nextUpdateMs(new unsigned long[lightCount]),
+  _earliestUpdateMs(millis()),
+  _sleepCount(0),
+  _frameBudgetUs(0),
+  _lastExecuteUs(0),
+  _overrunCount(0),
+  _qualityLevel(0),
+  _goodFrameCount(0),
+  _firstLightIndex(0)
+{
+  const unsigned long currentTimeMs = _earliestUpdateMs;
+  for (unsigned char lightIndex = 0; lightIndex < _lightCount; lightIndex++) {
+    _nextUpdateMs[lightIndex] = currentTimeMs;
+  }
+}
+
+void LEDLightingScheduler::execute() {
+  const unsigned long currentTimeMs = millis();
+  unsigned long earliestUpdateMs = currentTimeMs + LED_UPDATE_INTERVAL_STEADY_MS;
+
+  if (_frameBudgetUs) {
+    updateQualityLevel();
+  }
+
+  //at reduced quality only some of the due lights outside of transitions are executed per pass
+  unsigned char remainingSteadyCount = _qualityLevel ? ((_lightCount >> _qualityLevel) + 1) : _lightCount;
+  unsigned char nextFirstLightIndex = _firstLightIndex;
+  bool isLightSkipped = false;
+
+  unsigned char lightIndex = _firstLightIndex;
+  for (unsigned char lightCount = 0; lightCount < _lightCount; lightCount++, lightIndex = ((lightIndex + 1) < _lightCount) ? (lightIndex + 1) : 0) {
+    //wraparound safe check whether the update time has been reached, a requested update makes the light due at once
+    LEDStaticLighting * const light = _lights[lightIndex];
+    if (((long)(currentTimeMs - _nextUpdateMs[lightIndex]) < 0) && not light->isUpdateRequested()) {
+      if ((long)(_nextUpdateMs[lightIndex] - earliestUpdateMs) < 0) {
+        earliestUpdateMs = _nextUpdateMs[lightIndex];
+      }
+      continue;
+    }
+
+    if (not light->isInTransition()) {
+      if (not remainingSteadyCount) {
+        //the light stays due and is executed first on the next pass
+        if (not isLightSkipped) {
+          nextFirstLightIndex = lightIndex;
+          isLightSkipped = true;
+        }
+        earliestUpdateMs = currentTimeMs;
+        continue;
+      }
+      remainingSteadyCount--;
+    }
+
+    const LEDStaticLighting::CycleStates previousState = light->getState();
+    light->setUpdateRequested(false);
+    light->execute();
+
+    if (light->getState() != previousState) {
+      //write the first brightness of the new state on the next pass
+      _nextUpdateMs[lightIndex] = currentTimeMs;
+    }
+    else {
+      unsigned int intervalMs = light->getUpdateIntervalMs();
+      if (_qualityLevel && (intervalMs < LED_UPDATE_INTERVAL_POLL_MS) && not light->isInTransition()) {
+        //longer intervals are kept, they may be the time left until the next switch
+        intervalMs = (intervalMs ? intervalMs : 1) << _qualityLevel;
+        if (intervalMs > LED_UPDATE_INTERVAL_POLL_MS) {
+          intervalMs = LED_UPDATE_INTERVAL_POLL_MS;
+        }
+      }
+      _nextUpdateMs[lightIndex] = currentTimeMs + intervalMs;
+    }
+
+    if ((long)(_nextUpdateMs[lightIndex] - earliestUpdateMs) < 0) {
+      earliestUpdateMs = _nextUpdateMs[lightIndex];
+    }
+  }
+
+  _firstLightIndex = nextFirstLightIndex;
+  _earliestUpdateMs = earliestUpdateMs;
+}
+
+void LEDLightingScheduler::updateQualityLevel() {
+  const unsigned long currentTimeUs = micros();
+  const unsigned long framePeriodUs = currentTimeUs - _lastExecuteUs;
+  _lastExecuteUs = currentTimeUs;
+
+  if (framePeriodUs > _frameBudgetUs) {
+    _overrunCount++;
+    _goodFrameCount = 0;
+    if (_qualityLevel < SCHEDULER_MAX_QUALITY_LEVEL) {
+      _qualityLevel++;
+    }
+  }
+  else if (_qualityLevel && (++_goodFrameCount >= SCHEDULER_RECOVERY_FRAMES)) {
+    _goodFrameCount = 0;
+    _qualityLevel--;
+  }
+}
+
+void LEDLightingScheduler::setFrameBudget(unsigned int const frameBudgetUs) {
+  _frameBudgetUs = frameBudgetUs;
+  _lastExecuteUs = micros();
+  _qualityLevel = 0;
+  _goodFrameCount = 0;
+}
+
+unsigned char LEDLightingScheduler::getQualityLevel() const {
+  return _qualityLevel;
+}
+
+unsigned long LEDLightingScheduler::getOverrunCount() const {
+  return _overrunCount;
+}
+
+unsigned long LEDLightingScheduler::getNextUpdateMs() const {
+  //the earliest update time is collected by execute(), the steady interval keeps the result close to the current time
+  const unsigned long steadyUpdateMs = millis() + LED_UPDATE_INTERVAL_STEADY_MS;
+  if ((long)(_earliestUpdateMs - steadyUpdateMs) < 0) {
+    return _earliestUpdateMs;
+  }
+
+  return steadyUpdateMs;
+}
+
+bool LEDLightingScheduler::isPwmActive() const {
+  for (unsigned char lightIndex = 0; lightIndex < _lightCount; lightIndex++) {
+    const unsigned char pinBrightness = _lights[lightIndex]->getPinBrightness();
+    if (pinBrightness && (pinBrightness != 255)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool LEDLightingScheduler::sleepUntilNextUpdate(bool const allowPowerDown) {
+  const unsigned long nextUpdateMs = getNextUpdateMs();
+  if (((long)(nextUpdateMs - millis()) <= 0) || _isWakeUpRequested) {
+    _isWakeUpRequested = false;
+    return false;
+  }
+
+#ifdef __AVR__
+  _sleepCount++;
+
+  if (allowPowerDown && not _powerDownBlockCount && not isPwmActive()) {
+    long remainingMs = nextUpdateMs - millis();
+    while ((remainingMs >= watchdogPeriodsMs[0]) && not _isWakeUpRequested) {
+      //use the longest watchdog period that does not overshoot the next update
+      unsigned char prescaler = WATCHDOG_PERIOD_COUNT - 1;
+      while (watchdogPeriodsMs[prescaler] > remainingMs) {
+        prescaler--;
+      }
+
+      noInterrupts();
+      if (_isWakeUpRequested) {
+        //a wake up requested after the check of the loop condition would otherwise be lost for a whole watchdog period
+        interrupts();
+        break;
+      }
+      isWatchdogWakeUp = false;
+      wdt_reset();
+      MCUSR &= ~_BV(WDRF);
+      WDTCSR = _BV(WDCE) | _BV(WDE);
+      WDTCSR = _BV(WDIE) | (prescaler & 0x07) | ((prescaler & 0x08) ? _BV(WDP3) : 0);
+      set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+      sleep_enable();
+      //the instruction after sei() is executed before any interrupt, so no wake up can be missed
+      interrupts();
+      sleep_cpu();
+      sleep_disable();
+      wdt_disable();
+
+      if (not isWatchdogWakeUp) {
+        //woken up by another interrupt, the time slept is unknown
+        break;
+      }
+
+      //timer 0 is stopped in power down, so millis() and micros() need to be corrected by the same time
+      const unsigned long sleptUs = watchdogPeriodsMs[prescaler] * 1000ul + sleptOverflowRemainderUs;
+      noInterrupts();
+      timer0_millis += watchdogPeriodsMs[prescaler];
+      timer0_overflow_count += sleptUs / TIMER0_OVERFLOW_US;
+      interrupts();
+      sleptOverflowRemainderUs = sleptUs % TIMER0_OVERFLOW_US;
+
+      remainingMs = nextUpdateMs - millis();
+    }
+  }
+
+  //idle mode keeps timer 0 running, it wakes up the board every ms to update millis()
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  while (((long)(nextUpdateMs - millis()) > 0)) {
+    noInterrupts();
+    if (_isWakeUpRequested) {
+      interrupts();
+      break;
+    }
+    sleep_enable();
+    interrupts();
+    sleep_cpu();
+    sleep_disable();
+  }
+
+  //the sleep is not part of the frame measured for the frame budget
+  _lastExecuteUs = micros();
+  _isWakeUpRequested = false;
+  return true;
+#elif defined(ARDUINO_HOST_SIMULATOR)
+  (void)allowPowerDown;
+  _sleepCount++;
+
+  //the simulated clock jumps to the next update, or to a simulated interrupt that may call wakeUp()
+  while (((long)(nextUpdateMs - millis()) > 0) && not _isWakeUpRequested) {
+    hostSleep(nextUpdateMs);
+  }
+
+  _lastExecuteUs = micros();
+  _isWakeUpRequested = false;
+  return true;
+#else
+  (void)allowPowerDown;
+  return false;
+#endif
+}
+
+void LEDLightingScheduler::handleWatchdogInterrupt() {
+#ifdef __AVR__
+  isWatchdogWakeUp = true;
+#endif
+}
+
+void LEDLightingScheduler::wakeUp() {
+  _isWakeUpRequested = true;
+}
+
+void LEDLightingScheduler::setPowerDownBlocked(bool const isBlocked) {
+  if (isBlocked) {
+    _powerDownBlockCount++;
+  }
+  else if (_powerDownBlockCount) {
+    _powerDownBlockCount--;
+  }
+}
+
+unsigned long LEDLightingScheduler::getSleepCount() const {
+  return _sleepCount;
+}
@@ -0,0 +1,208 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef LEDLIGHTINGSCHEDULER_H
+#define LEDLIGHTINGSCHEDULER_H
+
+#include "LEDLightingCycle.h"
+
+/**
+  @brief Executes lights only when their update interval has elapsed.
+
+  Instead of calling execute() of every light in every pass of loop(), the scheduler asks each light
+  for its update interval with LEDStaticLighting::getUpdateIntervalMs() and skips the light until that
+  interval has elapsed. Transitions are executed on every pass, steady lights only a few times per second.
+
+  A light that changed its state during execute() is executed again on the next pass, so the first
+  brightness of the new state is written without delay. Lights that return true from
+  LEDStaticLighting::isUpdateRequested() are executed on the next pass regardless of their interval, e.g. after
+  a change from a serial console or when an LEDPowerBudget rescaled their output.
+
+  Since the scheduler knows when the next light needs to be executed, it can also put the board to sleep
+  until then with #sleepUntilNextUpdate().
+
+  If other code in loop() takes too long, a frame budget set with #setFrameBudget() lets the scheduler reduce
+  its own work while loop() overruns the budget. Transitions keep running at full rate, while steady lights and
+  fast cyclic effects like BeaconEffect are updated less often, see #getQualityLevel().
+*/
+class LEDLightingScheduler {
+  private:
+    ///lights handled by the scheduler
+    LEDStaticLighting * const * const _lights;
+    ///number of lights in #_lights
+    const unsigned char _lightCount;
+    ///time of the next update for each light in ms
+    unsigned long * const _nextUpdateMs;
+    ///earliest entry of #_nextUpdateMs, updated by #execute()
+    unsigned long _earliestUpdateMs;
+    ///number of times the board was put to sleep
+    unsigned long _sleepCount;
+    ///set by #wakeUp() to end the current sleep
+    static volatile bool _isWakeUpRequested;
+    ///number of drivers that need interrupts which can not wake the board from power down
+    static unsigned char _powerDownBlockCount;
+    ///target time between two calls of #execute() in us, 0 if the quality is never reduced
+    unsigned int _frameBudgetUs;
+    ///time of the last call of #execute() or of the end of the last sleep in us
+    unsigned long _lastExecuteUs;
+    ///number of calls of #execute() later than the frame budget
+    unsigned long _overrunCount;
+    ///current quality level, 0 is full quality
+    unsigned char _qualityLevel;
+    ///number of calls within the frame budget since the last change of #_qualityLevel
+    unsigned char _goodFrameCount;
+    ///light to start with on the next pass, lights skipped at reduced quality come first
+    unsigned char _firstLightIndex;
+
+    /**
+      @brief measures the time since the last call of #execute() or the last sleep and adjusts #_qualityLevel
+    */
+    void updateQualityLevel();
+
+    /**
+      @brief returns true if any output is dimmed by PWM
+
+      PWM outputs stop working in power down mode, only fully off or fully on outputs keep their state.
+
+      @return true if at least one output pin is dimmed
+    */
+    bool isPwmActive() const;
+
+  public:
+    /**
+      @brief creates a new LEDLightingScheduler instance
+
+      @param lights array of lights to be executed
+      @param lightCount number of lights in \p lights
+    */
+    LEDLightingScheduler(LEDStaticLighting * const * const lights, unsigned char const lightCount);
+
+    /**
+      @brief This method needs to be called in the loop() function of the sketch instead of executing the lights.
+
+      Executes all lights whose update interval has elapsed.
+    */
+    void execute();
+
+    /**
+      @brief returns the time at which the next light needs to be executed
+
+      The time is collected by #execute(), so calling this method does not loop over the lights.
+
+      @return time of the next update in ms
+    */
+    unsigned long getNextUpdateMs() const;
+
+    /**
+      @brief puts the board to sleep until the next light needs to be executed
+
+      Call this method in loop() after #execute(). On AVR boards the idle sleep mode is used, it keeps the timers,
+      the PWM outputs and USB running.
+
+      The power down mode is opt-in: the sketch has to define the watchdog interrupt with
+      #LED_SCHEDULER_WATCHDOG_ISR and pass true for \p allowPowerDown. It is only used while all outputs are
+      fully on or off, and the board wakes up with the watchdog timer. millis() and micros() are both advanced by
+      the nominal watchdog period after each wake up, so they stay consistent with each other, but the watchdog
+      oscillator may be off by about 10% against real time. Power down stops USB on boards like the Arduino Micro.
+
+      The sleep ends early when an interrupt service routine calls #wakeUp(). An interrupt ending a power down
+      sleep before the watchdog fires is not added to millis() and micros(). While a driver blocks power down with
+      #setPowerDownBlocked(), only the idle mode is used.
+
+      In the host simulator the simulated clock advances to the next update instead, see Tools/HostSimulator.
+      On other boards this method returns without sleeping.
+
+      @param allowPowerDown true to use the power down mode when possible, requires #LED_SCHEDULER_WATCHDOG_ISR
+      @return true if the board has been sleeping
+    */
+    bool sleepUntilNextUpdate(bool const allowPowerDown = false);
+
+    /**
+      @brief ends a power down sleep, called by the watchdog interrupt defined with #LED_SCHEDULER_WATCHDOG_ISR
+    */
+    static void handleWatchdogInterrupt();
+
+    /**
+      @brief ends the current sleep, e.g. when a trigger variable is changed by an interrupt
+
+      This method can be called from interrupt service routines.
+    */
+    static void wakeUp();
+
+    /**
+      @brief keeps #sleepUntilNextUpdate() from using the power down mode
+
+      Drivers call this method while they rely on interrupts that can not wake the board from power down,
+      e.g. pin change edges on INT0 and INT1 of an ATmega328P. Each call with true needs a call with false.
+
+      @param isBlocked true while the driver is active
+    */
+    static void setPowerDownBlocked(bool const isBlocked);
+
+    /**
+      @brief sets the target time between two calls of #execute()
+
+      Every call later than \p frameBudgetUs counts as overrun and lowers the quality level by one step,
+      after a series of calls within the budget the quality level rises again. At reduced quality
+
+      - lights in a transition are still executed on every pass,
+      - update intervals shorter than #LED_UPDATE_INTERVAL_POLL_MS are doubled per level, up to that limit,
+      - only a part of the other lights due for an update is executed per pass, the rest follows on the next passes.
+
+      Switch times that were missed while loop() was blocked are thus spread over several passes instead of
+      executing all of them at once. Time spent in #sleepUntilNextUpdate() does not count towards the frame.
+
+      @param frameBudgetUs target time between two calls in us, 0 to always run at full quality
+    */
+    void setFrameBudget(unsigned int const frameBudgetUs);
+
+    /**
+      @brief returns the current quality level
+
+      @return 0 for full quality, higher levels update fewer lights per pass
+    */
+    unsigned char getQualityLevel() const;
+
+    /**
+      @brief returns the number of calls of #execute() later than the frame budget
+
+      @return number of overruns
+    */
+    unsigned long getOverrunCount() const;
+
+    /**
+      @brief returns the number of sleep windows entered by #sleepUntilNextUpdate()
+
+      @return number of sleep windows
+    */
+    unsigned long getSleepCount() const;
+};
+
+#ifdef __AVR__
+/**
+  Defines the watchdog interrupt needed for power down sleeps. Place it once at file scope of a sketch that passes
+  true to LEDLightingScheduler::sleepUntilNextUpdate(), the library itself does not claim the watchdog vector.
+  Without it the watchdog interrupt resets the board.
+*/
+#define LED_SCHEDULER_WATCHDOG_ISR \
+  ISR(WDT_vect) { \
+    LEDLightingScheduler::handleWatchdogInterrupt(); \
+  }
+#else
+#define LED_SCHEDULER_WATCHDOG_ISR
+#endif
+
+#endif
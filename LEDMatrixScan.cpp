@@ -0,0 +1,317 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "LEDMatrixScan.h"
+#include <Arduino.h>
+
+//timer ticks of the shortest plane, 16us at 16MHz, the interrupt has to set the columns within 8us to keep it exact
+#define MATRIX_MIN_SLOT_TICKS 4
+//timer ticks kept between reading the timer and the compare value, so the compare match is never missed
+#define MATRIX_COMPARE_MARGIN_TICKS 2
+//brightness bits below the shown planes, rounded away when the planes are filled
+#define MATRIX_LEVEL_SHIFT (8 - LED_MATRIX_PLANE_COUNT)
+
+LEDMatrixScan * LEDMatrixScan::_instance = 0;
+
+//rows of a row/column matrix, none if the columns do not fit into a plane mask or the rows would flicker
+static unsigned char getMatrixRowCount(unsigned char const rowCount, unsigned char const columnCount) {
+  return ((rowCount <= LED_MATRIX_MAX_ROWS) && (columnCount <= LED_MATRIX_MAX_COLUMNS)) ? rowCount : 0;
+}
+
+//rows of a charlieplexed matrix, every pin is a row with the other pins as columns
+static unsigned char getCharlieplexRowCount(unsigned char const pinCount) {
+  return ((pinCount >= 2) && (pinCount <= LED_MATRIX_MAX_ROWS) && (pinCount <= LED_MATRIX_MAX_COLUMNS + 1)) ? pinCount : 0;
+}
+
+#if defined(__AVR__) && defined(TIMER2_COMPA_vect)
+ISR(TIMER2_COMPA_vect) {
+  LEDMatrixScan::handleTimerInterrupt();
+}
+#endif
+
+LEDMatrixScan::LEDMatrixScan(const unsigned char * const rowPins, unsigned char const rowCount, const unsigned char * const columnPins, unsigned char const columnCount,
+                             LEDStaticLighting * const * const lights, unsigned char const lightCount):
+  _rowPins(new ScanPin[getMatrixRowCount(rowCount, columnCount)]),
+  _columnPins(new ScanPin[getMatrixRowCount(rowCount, columnCount) ? columnCount : 0]),
+  _rowCount(getMatrixRowCount(rowCount, columnCount)),
+  _columnCount(_rowCount ? columnCount : 0),
+  _isCharlieplexed(false),
+  _lights(lights),
+  _lightCount(lightCount),
+  _planeMasks(new unsigned short[_rowCount * LED_MATRIX_PLANE_COUNT]),
+  _row(_rowCount - 1),
+  _plane(LED_MATRIX_PLANE_COUNT - 1),
+  _maxScanTicks(0),
+  _lastScanTicks(0)
+{
+  initPins(rowPins, columnPins);
+}
+
+LEDMatrixScan::LEDMatrixScan(const unsigned char * const pins, unsigned char const pinCount,
+                             LEDStaticLighting * const * const lights, unsigned char const lightCount):
+  _rowPins(new ScanPin[getCharlieplexRowCount(pinCount)]),
+  _columnPins(_rowPins),
+  _rowCount(getCharlieplexRowCount(pinCount)),
+  _columnCount(_rowCount ? _rowCount - 1 : 0),
+  _isCharlieplexed(true),
+  _lights(lights),
+  _lightCount(lightCount),
+  _planeMasks(new unsigned short[_rowCount * LED_MATRIX_PLANE_COUNT]),
+  _row(_rowCount - 1),
+  _plane(LED_MATRIX_PLANE_COUNT - 1),
+  _maxScanTicks(0),
+  _lastScanTicks(0)
+{
+  initPins(pins, 0);
+}
+
+void LEDMatrixScan::initPins(const unsigned char * const rowPins, const unsigned char * const columnPins) {
+  for (unsigned char rowIndex = 0; rowIndex < _rowCount; rowIndex++) {
+    const unsigned char pin = rowPins[rowIndex];
+#ifdef __AVR__
+    _rowPins[rowIndex].output = portOutputRegister(digitalPinToPort(pin));
+    _rowPins[rowIndex].mode = portModeRegister(digitalPinToPort(pin));
+    _rowPins[rowIndex].bitMask = digitalPinToBitMask(pin);
+#else
+    _rowPins[rowIndex].pin = pin;
+#endif
+    //charlieplexed pins float while they are off, LOW keeps the pull-up disabled
+    digitalWrite(pin, LOW);
+    pinMode(pin, _isCharlieplexed ? INPUT : OUTPUT);
+
+    for (unsigned char planeIndex = 0; planeIndex < LED_MATRIX_PLANE_COUNT; planeIndex++) {
+      _planeMasks[rowIndex * LED_MATRIX_PLANE_COUNT + planeIndex] = 0;
+    }
+  }
+
+  if (_isCharlieplexed) {
+    return;
+  }
+
+  for (unsigned char columnIndex = 0; columnIndex < _columnCount; columnIndex++) {
+    const unsigned char pin = columnPins[columnIndex];
+#ifdef __AVR__
+    _columnPins[columnIndex].output = portOutputRegister(digitalPinToPort(pin));
+    _columnPins[columnIndex].mode = portModeRegister(digitalPinToPort(pin));
+    _columnPins[columnIndex].bitMask = digitalPinToBitMask(pin);
+#else
+    _columnPins[columnIndex].pin = pin;
+#endif
+    digitalWrite(pin, HIGH);
+    pinMode(pin, OUTPUT);
+  }
+}
+
+bool LEDMatrixScan::begin(LEDStaticLighting * const * const pinLights, unsigned char const pinLightCount) {
+  if (not _rowCount) {
+    return false;
+  }
+
+  //analogWrite() on a pin of timer 2 would change the mode of the timer and stop the scan
+  for (unsigned char lightIndex = 0; lightIndex < pinLightCount; lightIndex++) {
+    const unsigned char pin = pinLights[lightIndex]->getPin();
+    if ((pin != LED_NO_PIN) && isScanTimerPin(pin)) {
+      return false;
+    }
+  }
+
+  _instance = this;
+#if defined(__AVR__) && defined(TIMER2_COMPA_vect)
+  //CTC mode with a tick of 64 CPU cycles, the compare value is set for every slot
+  TCCR2A = _BV(WGM21);
+  TCCR2B = _BV(CS22);
+  TCNT2 = 0;
+  OCR2A = MATRIX_MIN_SLOT_TICKS - 1;
+  TIFR2 = _BV(OCF2A);
+  TIMSK2 |= _BV(OCIE2A);
+#endif
+  return true;
+}
+
+bool LEDMatrixScan::isScanTimerPin(unsigned char const pin) {
+#if defined(TIMER2A) && defined(TIMER2B)
+  const unsigned char timer = digitalPinToTimer(pin);
+  return (timer == TIMER2A) || (timer == TIMER2B);
+#else
+  return ((void)pin, false);
+#endif
+}
+
+void LEDMatrixScan::end() {
+  if (not _rowCount) {
+    return;
+  }
+
+#if defined(__AVR__) && defined(TIMER2_COMPA_vect)
+  TIMSK2 &= ~_BV(OCIE2A);
+#endif
+  _instance = 0;
+
+  setColumns(0);
+  setRowActive(_row, false);
+}
+
+void LEDMatrixScan::execute() {
+  unsigned char lightIndex = 0;
+  for (unsigned char rowIndex = 0; rowIndex < _rowCount; rowIndex++) {
+    unsigned short masks[LED_MATRIX_PLANE_COUNT] = {0};
+
+    unsigned short columnBit = 1;
+    for (unsigned char columnIndex = 0; (columnIndex < _columnCount) && (lightIndex < _lightCount); columnIndex++) {
+      //brightness * (2^LED_MATRIX_PLANE_COUNT - 1) / 256 rounded, 255 is always on without a division
+      const unsigned char brightness = _lights[lightIndex]->getPinBrightness();
+      const unsigned char level = (brightness - (brightness >> LED_MATRIX_PLANE_COUNT) + (1 << MATRIX_LEVEL_SHIFT >> 1)) >> MATRIX_LEVEL_SHIFT;
+
+      for (unsigned char planeIndex = 0; planeIndex < LED_MATRIX_PLANE_COUNT; planeIndex++) {
+        if (level & (1 << planeIndex)) {
+          masks[planeIndex] |= columnBit;
+        }
+      }
+      columnBit <<= 1;
+      lightIndex++;
+    }
+
+    //the interrupt must not see half written masks
+    volatile unsigned short * const rowMasks = _planeMasks + rowIndex * LED_MATRIX_PLANE_COUNT;
+    noInterrupts();
+    for (unsigned char planeIndex = 0; planeIndex < LED_MATRIX_PLANE_COUNT; planeIndex++) {
+      rowMasks[planeIndex] = masks[planeIndex];
+    }
+    interrupts();
+  }
+}
+
+unsigned char LEDMatrixScan::scanStep() {
+  if (not _rowCount) {
+    return MATRIX_MIN_SLOT_TICKS;
+  }
+
+  if (++_plane >= LED_MATRIX_PLANE_COUNT) {
+    _plane = 0;
+    //blank before the row changes, otherwise the next row shows the columns of the previous row for a moment
+    setColumns(0);
+    setRowActive(_row, false);
+    if (++_row >= _rowCount) {
+      _row = 0;
+    }
+    setRowActive(_row, true);
+  }
+
+  setColumns(_planeMasks[_row * LED_MATRIX_PLANE_COUNT + _plane]);
+  return MATRIX_MIN_SLOT_TICKS << _plane;
+}
+
+void LEDMatrixScan::handleTimerInterrupt() {
+  if (not _instance) {
+    return;
+  }
+
+  const unsigned char slotTicks = _instance->scanStep();
+#if defined(__AVR__) && defined(TIMER2_COMPA_vect)
+  OCR2A = _instance->getCompareTicks(slotTicks, TCNT2);
+#else
+  (void)slotTicks;
+#endif
+}
+
+unsigned char LEDMatrixScan::getCompareTicks(unsigned char const slotTicks, unsigned char const scanTicks) {
+  if (scanTicks > _maxScanTicks) {
+    _maxScanTicks = scanTicks;
+  }
+
+  //the next interrupt replaces the plane after the same latency, so the period of the timer is the on time
+  unsigned short compareTicks = slotTicks - 1;
+  if (_plane) {
+    _lastScanTicks = scanTicks;
+  }
+  else if (scanTicks > _lastScanTicks) {
+    //the row change blanked the previous plane at the usual time but set the new columns later
+    compareTicks += scanTicks - _lastScanTicks;
+  }
+
+  //a compare value the timer has already passed would show the plane for a full timer cycle
+  if (compareTicks < scanTicks + MATRIX_COMPARE_MARGIN_TICKS) {
+    compareTicks = scanTicks + MATRIX_COMPARE_MARGIN_TICKS;
+  }
+  return (compareTicks > 0xFF) ? 0xFF : compareTicks;
+}
+
+unsigned char LEDMatrixScan::getMaxScanTicks() const {
+  return _maxScanTicks;
+}
+
+const LEDMatrixScan::ScanPin & LEDMatrixScan::getColumnPin(unsigned char const row, unsigned char const column) const {
+  if (_isCharlieplexed && (column >= row)) {
+    return _columnPins[column + 1];
+  }
+  return _columnPins[column];
+}
+
+void LEDMatrixScan::setRowActive(unsigned char const row, bool const isActive) {
+  const ScanPin & pin = _rowPins[row];
+  if (not _isCharlieplexed) {
+    writePin(pin, isActive);
+  }
+  else if (isActive) {
+    writePin(pin, true);
+    setPinOutput(pin, true);
+  }
+  else {
+    setPinOutput(pin, false);
+    writePin(pin, false);
+  }
+}
+
+void LEDMatrixScan::setColumns(unsigned short const mask) {
+  unsigned short columnBit = 1;
+  for (unsigned char columnIndex = 0; columnIndex < _columnCount; columnIndex++) {
+    const bool isOn = mask & columnBit;
+    if (_isCharlieplexed) {
+      //the level of charlieplexed columns is always LOW, they are only switched between sinking and floating
+      setPinOutput(getColumnPin(_row, columnIndex), isOn);
+    }
+    else {
+      writePin(_columnPins[columnIndex], not isOn);
+    }
+    columnBit <<= 1;
+  }
+}
+
+void LEDMatrixScan::writePin(const ScanPin & pin, bool const isHigh) {
+#ifdef __AVR__
+  if (isHigh) {
+    *pin.output |= pin.bitMask;
+  }
+  else {
+    *pin.output &= ~pin.bitMask;
+  }
+#else
+  digitalWrite(pin.pin, isHigh ? HIGH : LOW);
+#endif
+}
+
+void LEDMatrixScan::setPinOutput(const ScanPin & pin, bool const isOutput) {
+#ifdef __AVR__
+  if (isOutput) {
+    *pin.mode |= pin.bitMask;
+  }
+  else {
+    *pin.mode &= ~pin.bitMask;
+  }
+#else
+  pinMode(pin.pin, isOutput ? OUTPUT : INPUT);
+#endif
+}
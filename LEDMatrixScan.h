@@ -0,0 +1,242 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef LEDMATRIXSCAN_H
+#define LEDMATRIXSCAN_H
+
+#include "LEDLightingCycle.h"
+
+///number of bit planes shown per row, the brightness of a matrix LED has 2^LED_MATRIX_PLANE_COUNT levels
+#define LED_MATRIX_PLANE_COUNT 6
+///maximum number of columns, one bit of a plane mask per column
+#define LED_MATRIX_MAX_COLUMNS 16
+///maximum number of rows, each row is shown for 1008us, so 10 rows refresh at 99Hz. More rows flicker visibly,
+///e.g. a charlieplex of 17 pins would only refresh at 58Hz
+#define LED_MATRIX_MAX_ROWS 10
+
+/**
+  @brief Drives many LEDs from a few pins by scanning a multiplexed or charlieplexed matrix.
+
+  The LEDs are controlled by ordinary lighting objects created with LED_NO_PIN. #execute() copies their brightness
+  into bit planes, and the compare match A interrupt of timer 2 shows the planes one row at a time using bit angle
+  modulation: plane n of a row is shown for 2^n slots of 16us, so every row is active for 1008us and all rows are
+  refreshed every rowCount * 1008us (8 rows at 124Hz).
+
+  In a row/column matrix the row pins drive the anodes (active HIGH) and the column pins the cathodes
+  through the resistors (active LOW). Light n is at row n / columnCount and column n % columnCount.
+  With charlieplexing every pin has a resistor and n pins drive n * (n - 1) LEDs. The anode of light
+  n is pin n / (n - 1), its cathode is the (n % (n - 1))th of the remaining pins. Unused pins are switched to INPUT.
+
+  The interrupt costs are bounded: every interrupt writes each column pin once, the interrupt that switches rows
+  writes them twice. Before the row changes all columns are switched off, so the new row never shows the columns
+  of the previous row (ghosting).
+
+  A plane is shown until the next interrupt replaces it, so its on time is the timer period plus the difference of
+  the interrupt latencies. The timer restarts at each compare match and the period of a plane is its slot, so the
+  latency cancels out for all interrupts that take the same time to reach a pin. Only the interrupt that changes rows
+  sets the new columns later, this difference is added to the period of the first plane of the row. The remaining
+  error is up to one timer tick (4us) on the first plane of each row and the jitter of the interrupt entry, e.g. when
+  the millis() interrupt of timer 0 runs first. An interrupt that needs more than 8us to set the columns lengthens
+  its plane instead of missing the compare match. #getMaxScanTicks() returns the longest time from the compare match
+  until the outputs were set, check it on the board for matrices with many columns.
+
+  Every LED is only lit while its row is active, at most 1/rowCount of the time. The scan does not compensate this
+  duty cycle, a brightness of 255 lights the LED for its whole row slot and lower values for a share of it. To match
+  the brightness of a directly driven LED the resistors have to be chosen for rowCount times its current, within the
+  pulse rating of the LED and the pin current limits. With an LEDPowerBudget each matrix light draws its pulse
+  current / rowCount.
+
+  Timer 2 is no longer available for analogWrite() on its pins (3 and 11 on an Uno, 9 and 10 on a Mega) or tone(),
+  pass the lights driving their own pins to #begin() to have them checked. The timer keeps running in the idle
+  sleep mode only, so do not let the board enter power down while the matrix is active.
+  On other boards #scanStep() can be called from any timer that supports changing periods.
+*/
+class LEDMatrixScan {
+  private:
+    ///Output registers of a pin
+    struct ScanPin {
+#ifdef __AVR__
+      ///PORT register of the pin
+      volatile unsigned char * output;
+      ///DDR register of the pin
+      volatile unsigned char * mode;
+      ///bit of the pin in both registers
+      unsigned char bitMask;
+#else
+      ///pin number
+      unsigned char pin;
+#endif
+    };
+
+    ///row pins, all pins in a charlieplexed matrix
+    ScanPin * const _rowPins;
+    ///column pins, the same array as #_rowPins in a charlieplexed matrix
+    ScanPin * const _columnPins;
+    ///number of rows
+    const unsigned char _rowCount;
+    ///number of columns per row
+    const unsigned char _columnCount;
+    ///true if the matrix is charlieplexed
+    const bool _isCharlieplexed;
+    ///lights shown by the matrix, row by row
+    LEDStaticLighting * const * const _lights;
+    ///number of lights in #_lights
+    const unsigned char _lightCount;
+    ///column masks of all planes, LED_MATRIX_PLANE_COUNT masks per row
+    volatile unsigned short * const _planeMasks;
+
+    ///row currently shown
+    unsigned char _row;
+    ///plane currently shown
+    unsigned char _plane;
+    ///longest time from the compare match until the outputs were set in timer ticks
+    volatile unsigned char _maxScanTicks;
+    ///time from the compare match until the outputs were set by the last step without a row change in timer ticks
+    unsigned char _lastScanTicks;
+
+    ///matrix driven by the timer interrupt
+    static LEDMatrixScan * _instance;
+
+    /**
+      @brief initializes the pins, all rows and columns off
+    */
+    void initPins(const unsigned char * const rowPins, const unsigned char * const columnPins);
+
+    /**
+      @brief returns the column pin of a row
+
+      In a charlieplexed matrix the row pin is skipped.
+    */
+    const ScanPin & getColumnPin(unsigned char const row, unsigned char const column) const;
+
+    /**
+      @brief switches a row on or off
+    */
+    void setRowActive(unsigned char const row, bool const isActive);
+
+    /**
+      @brief switches the columns of the current row
+
+      @param mask one bit per column, set bits are switched on
+    */
+    void setColumns(unsigned short const mask);
+
+    /**
+      @brief writes the level of a pin
+    */
+    static void writePin(const ScanPin & pin, bool const isHigh);
+
+    /**
+      @brief switches a pin between OUTPUT and INPUT
+    */
+    static void setPinOutput(const ScanPin & pin, bool const isOutput);
+
+  public:
+    /**
+      @brief creates a new LEDMatrixScan instance for a row/column matrix
+
+      @param rowPins pins driving the anodes of the rows
+      @param rowCount number of entries in \p rowPins, at most LED_MATRIX_MAX_ROWS. With more rows the matrix has no rows
+             and leaves all pins untouched
+      @param columnPins pins driving the cathodes of the columns
+      @param columnCount number of entries in \p columnPins, at most LED_MATRIX_MAX_COLUMNS. With more columns the
+             matrix has no rows and leaves all pins untouched
+      @param lights lights shown by the matrix, created with LED_NO_PIN
+      @param lightCount number of lights in \p lights, lights beyond rowCount * columnCount are ignored
+    */
+    LEDMatrixScan(const unsigned char * const rowPins, unsigned char const rowCount, const unsigned char * const columnPins, unsigned char const columnCount,
+                  LEDStaticLighting * const * const lights, unsigned char const lightCount);
+
+    /**
+      @brief creates a new LEDMatrixScan instance for a charlieplexed matrix
+
+      @param pins pins of the matrix, each with its own resistor
+      @param pinCount number of entries in \p pins, from 2 to LED_MATRIX_MAX_ROWS. With other counts the
+             matrix has no rows and leaves all pins untouched
+      @param lights lights shown by the matrix, created with LED_NO_PIN
+      @param lightCount number of lights in \p lights, lights beyond pinCount * (pinCount - 1) are ignored
+    */
+    LEDMatrixScan(const unsigned char * const pins, unsigned char const pinCount,
+                  LEDStaticLighting * const * const lights, unsigned char const lightCount);
+
+    /**
+      @brief starts scanning with the timer interrupt
+
+      Only one matrix can be driven by the timer interrupt. The scan takes over timer 2, so analogWrite() does not
+      work on its pins anymore. The matrix does not start if one of \p pinLights uses such a pin.
+
+      @param pinLights lights driving their own pins, e.g. all other lights of the sketch
+      @param pinLightCount number of lights in \p pinLights
+      @return false if the matrix has no rows or one of \p pinLights uses a pin of timer 2
+    */
+    bool begin(LEDStaticLighting * const * const pinLights = 0, unsigned char const pinLightCount = 0);
+
+    /**
+      @brief returns true if analogWrite() on a pin uses the timer of the scan
+
+      @param pin pin number
+      @return true if the pin is an output of timer 2
+    */
+    static bool isScanTimerPin(unsigned char const pin);
+
+    /**
+      @brief stops scanning and switches all LEDs off
+    */
+    void end();
+
+    /**
+      @brief This method needs to be called in the loop() function of the sketch after the lights have been executed.
+
+      Copies the brightness of all lights into the bit planes.
+    */
+    void execute();
+
+    /**
+      @brief shows the next plane, switching to the next row after the last plane
+
+      Called by the timer interrupt, or directly to scan the matrix on a PC.
+
+      @return time the plane has to be shown in timer ticks of 64 CPU cycles (4us at 16MHz)
+    */
+    unsigned char scanStep();
+
+    /**
+      @brief returns the compare value of the timer for the plane shown by the last #scanStep()
+
+      Called by the timer interrupt, or by a timer emulation on a PC. Updates #getMaxScanTicks().
+
+      @param slotTicks time the plane has to be shown as returned by #scanStep()
+      @param scanTicks timer ticks since the compare match, read after #scanStep()
+      @return compare value for the timer, restarting at the compare match
+    */
+    unsigned char getCompareTicks(unsigned char const slotTicks, unsigned char const scanTicks);
+
+    /**
+      @brief forwards a timer interrupt to the matrix started with #begin()
+
+      Called by the interrupt service routine.
+    */
+    static void handleTimerInterrupt();
+
+    /**
+      @brief returns the longest time the interrupt needed to set the outputs
+
+      @return longest time from the compare match until the outputs were set in timer ticks of 64 CPU cycles
+    */
+    unsigned char getMaxScanTicks() const;
+};
+
+#endif
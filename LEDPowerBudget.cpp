@@ -0,0 +1,72 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "LEDPowerBudget.h"
+#include <Arduino.h>
+
+#define POWER_BUDGET_NO_SCALING 256
+
+LEDPowerBudget::LEDPowerBudget(unsigned int const limitMa, unsigned int const rampTimeMs):
+  _limitLoad(limitMa * 255ul),
+  _totalLoad(0),
+  _targetScale(POWER_BUDGET_NO_SCALING),
+  _scale(POWER_BUDGET_NO_SCALING),
+  _scaleStepPerMs(rampTimeMs ? (POWER_BUDGET_NO_SCALING / rampTimeMs) : POWER_BUDGET_NO_SCALING),
+  _lastExecuteMs(0)
+{
+  if (not _scaleStepPerMs) {
+    //ramp times above 256ms still need to move the scale factor
+    _scaleStepPerMs = 1;
+  }
+}
+
+void LEDPowerBudget::execute() {
+  const unsigned long currentTimeMs = millis();
+  const unsigned long elapsedMs = currentTimeMs - _lastExecuteMs;
+  if ( not elapsedMs ) {
+    return;
+  }
+  _lastExecuteMs = currentTimeMs;
+
+  //limit the step to the full range to avoid overflows after long pauses
+  const unsigned int step = (elapsedMs < POWER_BUDGET_NO_SCALING) ? elapsedMs * _scaleStepPerMs : POWER_BUDGET_NO_SCALING;
+  if (_scale > _targetScale) {
+    _scale = ((_scale - _targetScale) > step) ? (_scale - step) : _targetScale;
+  }
+  else if (_scale < _targetScale) {
+    _scale = ((_targetScale - _scale) > step) ? (_scale + step) : _targetScale;
+  }
+}
+
+void LEDPowerBudget::changeLoad(unsigned int const oldLoad, unsigned int const newLoad) {
+  _totalLoad = _totalLoad - oldLoad + newLoad;
+
+  if (_totalLoad <= _limitLoad) {
+    _targetScale = POWER_BUDGET_NO_SCALING;
+  }
+  else {
+    //one division per change, the total is never summed up again
+    _targetScale = (_limitLoad * POWER_BUDGET_NO_SCALING) / _totalLoad;
+  }
+}
+
+unsigned char LEDPowerBudget::scale(unsigned char const brightness) const {
+  return ((unsigned int)brightness * _scale) >> 8;
+}
+
+unsigned int LEDPowerBudget::getRequestedCurrentMa() const {
+  return _totalLoad / 255;
+}
@@ -0,0 +1,86 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef LEDPOWERBUDGET_H
+#define LEDPOWERBUDGET_H
+
+/**
+  @brief Limits the total current drawn by all outputs sharing one regulator.
+
+  Every output attached to the budget declares the current it draws at full brightness.
+  The budget keeps a running total of the requested load, which is only updated when the
+  requested brightness of an output changes, so the cost per change is constant and
+  independent of the number of outputs.
+
+  When the requested load exceeds the configured limit, all attached outputs are scaled down
+  by a common factor. The factor is moved towards its target in #execute() to avoid visible jumps.
+*/
+class LEDPowerBudget {
+  private:
+    ///configured current limit in mA multiplied by 255 to match the load units
+    const unsigned long _limitLoad;
+    ///sum of brightness * current in mA over all attached outputs
+    unsigned long _totalLoad;
+    ///scale factor the outputs should reach, 256 means no scaling
+    unsigned int _targetScale;
+    ///scale factor currently applied to the outputs, 256 means no scaling
+    unsigned int _scale;
+    ///maximum change of #_scale per ms in 1/256 steps
+    unsigned int _scaleStepPerMs;
+    ///time of the last call to #execute() in ms
+    unsigned long _lastExecuteMs;
+
+  public:
+    /**
+      @brief creates a new LEDPowerBudget instance
+
+      @param limitMa maximum total current in mA for all attached outputs
+      @param rampTimeMs time in ms the scale factor needs to move across its full range
+    */
+    LEDPowerBudget(unsigned int const limitMa, unsigned int const rampTimeMs = 100);
+
+    /**
+      @brief This method needs to be called in the loop() function of the sketch.
+
+      Moves the applied scale factor towards the scale factor required by the current load.
+    */
+    void execute();
+
+    /**
+      @brief updates the running total when the requested brightness of an output changes
+
+      @param oldLoad previous brightness * current in mA of the output
+      @param newLoad new brightness * current in mA of the output
+    */
+    void changeLoad(unsigned int const oldLoad, unsigned int const newLoad);
+
+    /**
+      @brief returns the brightness to write to an output after applying the budget
+
+      @param brightness requested brightness
+      @return scaled brightness
+    */
+    unsigned char scale(unsigned char const brightness) const;
+
+    /**
+      @brief returns the current requested by all attached outputs in mA
+
+      @return requested current in mA
+    */
+    unsigned int getRequestedCurrentMa() const;
+};
+
+#endif
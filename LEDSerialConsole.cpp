@@ -0,0 +1,240 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "LEDSerialConsole.h"
+
+LEDSerialConsole::LEDSerialConsole(Stream & stream, LEDStaticLighting * const * const lights, unsigned char const lightCount,
+                                   LEDCyclicEffect * const * const effects, unsigned char const effectCount):
+  _stream(stream),
+  _lights(lights),
+  _lightCount(lightCount),
+  _effects(effects),
+  _effectCount(effectCount),
+  _lineLength(0),
+  _isLineTooLong(false)
+{}
+
+void LEDSerialConsole::execute() {
+  //only the characters already received are read, so a partial line does not block
+  int available = _stream.available();
+  while (available-- > 0) {
+    const int character = _stream.read();
+    if (character < 0) {
+      break;
+    }
+
+    if ((character == '\n') || (character == '\r')) {
+      //empty lines, e.g. the second half of \r\n, are skipped
+      if (not _lineLength && not _isLineTooLong) {
+        continue;
+      }
+
+      if (_isLineTooLong) {
+        printError(F("line too long"));
+      }
+      else {
+        _line[_lineLength] = 0;
+        executeLine();
+      }
+      _lineLength = 0;
+      _isLineTooLong = false;
+      //one command per call keeps the time spent in loop() short
+      return;
+    }
+
+    if (_lineLength < LED_CONSOLE_LINE_LENGTH - 1) {
+      _line[_lineLength++] = character;
+    }
+    else {
+      _isLineTooLong = true;
+    }
+  }
+}
+
+char * LEDSerialConsole::readWord(char * & cursor) {
+  while (*cursor == ' ') {
+    cursor++;
+  }
+
+  char * const word = cursor;
+  while (*cursor && (*cursor != ' ')) {
+    cursor++;
+  }
+  if (*cursor) {
+    *cursor++ = 0;
+  }
+  return word;
+}
+
+bool LEDSerialConsole::readNumber(char * & cursor, unsigned long & value) {
+  const char * word = readWord(cursor);
+  if (not *word) {
+    return false;
+  }
+
+  value = 0;
+  for (; *word; word++) {
+    if ((*word < '0') || (*word > '9')) {
+      return false;
+    }
+    value = value * 10 + (*word - '0');
+  }
+  return true;
+}
+
+LEDStaticLighting * LEDSerialConsole::readLight(char * & cursor) {
+  unsigned long lightIndex;
+  if (not readNumber(cursor, lightIndex) || (lightIndex >= _lightCount)) {
+    printError(F("unknown light"));
+    return 0;
+  }
+  return _lights[lightIndex];
+}
+
+void LEDSerialConsole::printError(const __FlashStringHelper * const message) {
+  _stream.print(F("error: "));
+  _stream.println(message);
+}
+
+void LEDSerialConsole::printLight(unsigned char const lightIndex) {
+  LEDStaticLighting * const light = _lights[lightIndex];
+
+  _stream.print(lightIndex);
+  _stream.print(F(" pin "));
+  _stream.print(light->getPin());
+  _stream.print(F(" state "));
+  _stream.print((unsigned char)light->getState());
+  _stream.print(F(" bright "));
+  _stream.print(light->getBrightness());
+  _stream.print(F(" out "));
+  _stream.print(light->getPinBrightness());
+
+  for (unsigned char effectIndex = 0; effectIndex < _effectCount; effectIndex++) {
+    if (_effects[effectIndex] == light->getOnEffect()) {
+      _stream.print(F(" effect "));
+      _stream.print(effectIndex);
+    }
+  }
+  _stream.println();
+}
+
+void LEDSerialConsole::executeLine() {
+  char * cursor = _line;
+  const char * const command = readWord(cursor);
+
+  if (strcmp_P(command, PSTR("list")) == 0) {
+    for (unsigned char lightIndex = 0; lightIndex < _lightCount; lightIndex++) {
+      printLight(lightIndex);
+    }
+  }
+  else if (strcmp_P(command, PSTR("get")) == 0) {
+    unsigned long lightIndex;
+    if (not readNumber(cursor, lightIndex) || (lightIndex >= _lightCount)) {
+      printError(F("unknown light"));
+      return;
+    }
+
+    printLight(lightIndex);
+    LEDTimingRanges timingRanges;
+    if (_lights[lightIndex]->getTimingRanges(timingRanges)) {
+      _stream.print(F("range "));
+      _stream.print(timingRanges.switchOnMinMs);
+      _stream.print(' ');
+      _stream.print(timingRanges.switchOnMaxMs);
+      _stream.print(' ');
+      _stream.print(timingRanges.switchOffMinMs);
+      _stream.print(' ');
+      _stream.println(timingRanges.switchOffMaxMs);
+    }
+    _stream.print(F("interval "));
+    _stream.println(_lights[lightIndex]->getUpdateIntervalMs());
+  }
+  else if (strcmp_P(command, PSTR("state")) == 0) {
+    LEDStaticLighting * const light = readLight(cursor);
+    if (not light) {
+      return;
+    }
+
+    const char * const state = readWord(cursor);
+    if (strcmp_P(state, PSTR("off")) == 0) {
+      light->setState(LEDStaticLighting::CYCLE_OFF);
+    }
+    else if (strcmp_P(state, PSTR("on")) == 0) {
+      light->setState(LEDStaticLighting::CYCLE_ON);
+    }
+    else if (strcmp_P(state, PSTR("offtoon")) == 0) {
+      light->setState(LEDStaticLighting::CYCLE_OFF_TO_ON);
+    }
+    else if (strcmp_P(state, PSTR("ontooff")) == 0) {
+      light->setState(LEDStaticLighting::CYCLE_ON_TO_OFF);
+    }
+    else {
+      printError(F("unknown state"));
+      return;
+    }
+    _stream.println(F("ok"));
+  }
+  else if (strcmp_P(command, PSTR("bright")) == 0) {
+    LEDStaticLighting * const light = readLight(cursor);
+    unsigned long brightness;
+    if (not light) {
+      return;
+    }
+    if (not readNumber(cursor, brightness) || (brightness > 255)) {
+      printError(F("brightness must be 0 to 255"));
+      return;
+    }
+    light->setBrightness(brightness);
+    _stream.println(F("ok"));
+  }
+  else if (strcmp_P(command, PSTR("range")) == 0) {
+    LEDStaticLighting * const light = readLight(cursor);
+    LEDTimingRanges timingRanges;
+    if (not light) {
+      return;
+    }
+    if (not (readNumber(cursor, timingRanges.switchOnMinMs) && readNumber(cursor, timingRanges.switchOnMaxMs)
+             && readNumber(cursor, timingRanges.switchOffMinMs) && readNumber(cursor, timingRanges.switchOffMaxMs))
+        || (timingRanges.switchOnMinMs > timingRanges.switchOnMaxMs) || (timingRanges.switchOffMinMs > timingRanges.switchOffMaxMs)) {
+      printError(F("expected WAITONMIN WAITONMAX WAITOFFMIN WAITOFFMAX"));
+      return;
+    }
+    if (not light->setTimingRanges(timingRanges)) {
+      printError(F("ranges are read only"));
+      return;
+    }
+    _stream.println(F("ok"));
+  }
+  else if (strcmp_P(command, PSTR("effect")) == 0) {
+    LEDStaticLighting * const light = readLight(cursor);
+    unsigned long effectIndex;
+    if (not light) {
+      return;
+    }
+    if (not readNumber(cursor, effectIndex) || (effectIndex >= _effectCount)) {
+      printError(F("unknown effect"));
+      return;
+    }
+    light->setOnEffect(_effects[effectIndex]);
+    _stream.println(F("ok"));
+  }
+  else if (strcmp_P(command, PSTR("help")) == 0) {
+    _stream.println(F("list | get L | state L off|on|offtoon|ontooff | bright L V | range L WAITONMIN WAITONMAX WAITOFFMIN WAITOFFMAX | effect L E"));
+  }
+  else {
+    printError(F("unknown command, try help"));
+  }
+}
@@ -0,0 +1,135 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef LEDSERIALCONSOLE_H
+#define LEDSERIALCONSOLE_H
+
+#include "LEDLightingCycle.h"
+#include <Arduino.h>
+
+///maximum length of a command line including the terminating zero
+#define LED_CONSOLE_LINE_LENGTH 48
+
+/**
+  @brief Text commands to inspect and change lights at runtime.
+
+  Commands are read from any Stream, usually Serial, and end with a new line. Lights are addressed
+  by their index in the array passed to the constructor:
+  ```
+  list                                     lists all lights
+  get LIGHT                                shows the details of a light
+  state LIGHT off|on|offtoon|ontooff       forces the state of a light
+  bright LIGHT VALUE                       sets the brightness from 0 to 255
+  range LIGHT WAITONMIN WAITONMAX WAITOFFMIN WAITOFFMAX
+                                           sets the random wait in ms before switching on and before switching off
+  effect LIGHT EFFECT                      uses an effect from the effect table as on effect
+  help                                     lists the commands
+  ```
+  The waits follow LEDTimingRanges, so for an LEDRandomLightingCycle the wait before switching on is its off time
+  and the wait before switching off its on time. `get` prints the ranges in the same order.
+  Timing ranges can only be changed for lighting cycles created with times in ms, ranges in flash are read only.
+  Every change requests an update of the light, so lights run by an LEDLightingScheduler follow it on the next pass.
+
+  Characters are collected in a fixed buffer as they arrive, so #execute() never waits for input
+  and does not allocate any memory. Without input it only checks the number of available characters.
+*/
+class LEDSerialConsole {
+  private:
+    ///stream commands are read from and answers are written to
+    Stream & _stream;
+    ///lights accessible by the commands
+    LEDStaticLighting * const * const _lights;
+    ///number of lights in #_lights
+    const unsigned char _lightCount;
+    ///effects that can be selected as on effect
+    LEDCyclicEffect * const * const _effects;
+    ///number of effects in #_effects
+    const unsigned char _effectCount;
+    ///characters of the current line
+    char _line[LED_CONSOLE_LINE_LENGTH];
+    ///number of characters in #_line
+    unsigned char _lineLength;
+    ///true if the current line is longer than #_line
+    bool _isLineTooLong;
+
+    /**
+      @brief executes the command in #_line
+    */
+    void executeLine();
+
+    /**
+      @brief reads the next word of the line
+
+      @param cursor position in the line, advanced behind the word
+      @return start of the word, terminated by a zero
+    */
+    static char * readWord(char * & cursor);
+
+    /**
+      @brief reads the next word of the line as number
+
+      @param cursor position in the line, advanced behind the number
+      @param value receives the number
+      @return false if the word is no number
+    */
+    static bool readNumber(char * & cursor, unsigned long & value);
+
+    /**
+      @brief reads the index of a light
+
+      Prints an error if the index is missing or out of range.
+
+      @param cursor position in the line, advanced behind the index
+      @return light or 0
+    */
+    LEDStaticLighting * readLight(char * & cursor);
+
+    /**
+      @brief prints the details of a light
+
+      @param lightIndex index of the light
+    */
+    void printLight(unsigned char const lightIndex);
+
+    /**
+      @brief prints an error message
+
+      @param message error message
+    */
+    void printError(const __FlashStringHelper * const message);
+
+  public:
+    /**
+      @brief creates a new LEDSerialConsole instance
+
+      @param stream stream to read commands from, e.g. Serial
+      @param lights lights accessible by the commands
+      @param lightCount number of lights in \p lights
+      @param effects effects that can be selected with the effect command, created in setup()
+      @param effectCount number of effects in \p effects
+    */
+    LEDSerialConsole(Stream & stream, LEDStaticLighting * const * const lights, unsigned char const lightCount,
+                     LEDCyclicEffect * const * const effects = 0, unsigned char const effectCount = 0);
+
+    /**
+      @brief This method needs to be called in the loop() function of the sketch.
+
+      Reads the available characters and executes a command once its line is complete.
+    */
+    void execute();
+};
+
+#endif
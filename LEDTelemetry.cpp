@@ -0,0 +1,99 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "LEDTelemetry.h"
+
+//a byte on the serial line takes a start bit, 8 data bits and a stop bit
+#define TELEMETRY_BITS_PER_BYTE 10
+
+LEDTelemetry::LEDTelemetry(Print & stream, unsigned long const baudRate, LEDStaticLighting * const * const lights, unsigned char const lightCount):
+  _stream(stream),
+  _lights(lights),
+  _lightCount(lightCount),
+  _sentBrightness(new unsigned char[lightCount]),
+  _byteTimeUs((TELEMETRY_BITS_PER_BYTE * 1000000ul + baudRate - 1) / baudRate),
+  _nextPacketUs(micros()),
+  _lastRefreshMs(millis()),
+  _scanIndex(0),
+  _refreshIndex(0),
+  _isEnabled(true)
+{
+  memset(_sentBrightness, 0, lightCount);
+}
+
+void LEDTelemetry::execute() {
+  if (not _isEnabled) {
+    return;
+  }
+
+  const unsigned long currentTimeUs = micros();
+  if (((long)(currentTimeUs - _nextPacketUs) < 0) || (_stream.availableForWrite() < LED_TELEMETRY_MAX_PACKET_LENGTH)) {
+    //the previous packet is still being sent
+    return;
+  }
+
+  unsigned char packet[LED_TELEMETRY_MAX_PACKET_LENGTH];
+  unsigned char changeCount = 0;
+  unsigned char length = LED_TELEMETRY_HEADER_LENGTH;
+
+  unsigned char lightIndex = _scanIndex;
+  for (unsigned char lightCount = 0; (lightCount < _lightCount) && (changeCount < LED_TELEMETRY_MAX_CHANGES); lightCount++) {
+    const unsigned char pinBrightness = _lights[lightIndex]->getPinBrightness();
+    if (pinBrightness != _sentBrightness[lightIndex]) {
+      _sentBrightness[lightIndex] = pinBrightness;
+      packet[length++] = lightIndex;
+      packet[length++] = pinBrightness;
+      changeCount++;
+    }
+    lightIndex = ((lightIndex + 1) < _lightCount) ? (lightIndex + 1) : 0;
+  }
+  _scanIndex = lightIndex;
+
+  const unsigned long currentTimeMs = millis();
+  if ((changeCount < LED_TELEMETRY_MAX_CHANGES) && ((currentTimeMs - _lastRefreshMs) >= LED_TELEMETRY_REFRESH_MS) && _lightCount) {
+    _lastRefreshMs = currentTimeMs;
+    packet[length++] = _refreshIndex;
+    packet[length++] = _sentBrightness[_refreshIndex];
+    changeCount++;
+    _refreshIndex = ((_refreshIndex + 1) < _lightCount) ? (_refreshIndex + 1) : 0;
+  }
+
+  if (not changeCount) {
+    return;
+  }
+
+  packet[0] = LED_TELEMETRY_SYNC;
+  packet[1] = changeCount;
+  packet[length++] = currentTimeMs;
+  packet[length++] = currentTimeMs >> 8;
+
+  unsigned char checksum = 0;
+  for (unsigned char index = 1; index < length; index++) {
+    checksum += packet[index];
+  }
+  packet[length++] = checksum;
+
+  _stream.write(packet, length);
+  _nextPacketUs = currentTimeUs + (unsigned long)length * _byteTimeUs;
+}
+
+void LEDTelemetry::setEnabled(bool const isEnabled) {
+  if (isEnabled && not _isEnabled) {
+    //the last deadline may be so old that it looks like it is in the future after micros() wrapped
+    _nextPacketUs = micros();
+  }
+  _isEnabled = isEnabled;
+}
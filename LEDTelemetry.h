@@ -0,0 +1,121 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef LEDTELEMETRY_H
+#define LEDTELEMETRY_H
+
+#include "LEDLightingCycle.h"
+#include <Arduino.h>
+
+/*
+  Telemetry packet format, all values are single bytes unless noted:
+
+  LED_TELEMETRY_SYNC
+  number of changes N, 1 to LED_TELEMETRY_MAX_CHANGES
+  N times light index and pin brightness
+  millis() of the board as 16 bit value, low byte first
+  checksum, sum of all bytes from the number of changes to the time modulo 256
+*/
+
+///first byte of every telemetry packet
+#define LED_TELEMETRY_SYNC 0xA5
+///maximum number of changed lights in one packet
+#define LED_TELEMETRY_MAX_CHANGES 16
+///bytes before the changes: sync and number of changes
+#define LED_TELEMETRY_HEADER_LENGTH 2
+///bytes after the changes: time and checksum
+#define LED_TELEMETRY_TRAILER_LENGTH 3
+///length of a packet with #LED_TELEMETRY_MAX_CHANGES changes
+#define LED_TELEMETRY_MAX_PACKET_LENGTH (LED_TELEMETRY_HEADER_LENGTH + 2 * LED_TELEMETRY_MAX_CHANGES + LED_TELEMETRY_TRAILER_LENGTH)
+///time in ms after which one unchanged light is sent again, so a receiver started late learns all values
+#define LED_TELEMETRY_REFRESH_MS 100
+
+/**
+  @brief Sends the brightness of all lights to a PC for live viewing.
+
+  Each packet only contains the lights whose pin brightness changed since they were last sent.
+  Packets are only sent when the serial transmit buffer can take a full packet and the previous packets
+  had time to go out at the configured baud rate, so #execute() never waits for the serial port.
+  The format is described at the top of LEDTelemetry.h, `Tools/TelemetryDecoder` decodes and records it on the PC.
+  ```
+  LEDTelemetry * telemetry;
+
+  void setup() {
+    Serial.begin(115200);
+    ...
+    telemetry = new LEDTelemetry(Serial, 115200, ledSetups, LED_COUNT);
+  }
+
+  void loop() {
+    ...
+    telemetry->execute();
+  }
+  ```
+  The stream has to report its free buffer space with availableForWrite(), like HardwareSerial does.
+  A single call of #execute() compares each light once and writes at most one packet.
+*/
+class LEDTelemetry {
+  private:
+    ///stream the packets are written to
+    Print & _stream;
+    ///lights sent to the PC
+    LEDStaticLighting * const * const _lights;
+    ///number of lights in #_lights
+    const unsigned char _lightCount;
+    ///pin brightness last sent for each light
+    unsigned char * const _sentBrightness;
+    ///transmit time of one byte in us at the configured baud rate
+    const unsigned short _byteTimeUs;
+    ///time in us at which the previous packet has been transmitted
+    unsigned long _nextPacketUs;
+    ///time in ms of the last refresh of an unchanged light
+    unsigned long _lastRefreshMs;
+    ///light to check first for changes, lights behind a full packet come first in the next packet
+    unsigned char _scanIndex;
+    ///next light to be refreshed
+    unsigned char _refreshIndex;
+    ///false if #execute() should not send anything
+    bool _isEnabled;
+
+  public:
+    /**
+      @brief creates a new LEDTelemetry instance
+
+      @param stream stream to write the packets to, e.g. Serial
+      @param baudRate baud rate of \p stream, used to limit the packet rate
+      @param lights lights to send
+      @param lightCount number of lights in \p lights
+    */
+    LEDTelemetry(Print & stream, unsigned long const baudRate, LEDStaticLighting * const * const lights, unsigned char const lightCount);
+
+    /**
+      @brief This method needs to be called in the loop() function of the sketch.
+
+      Sends a packet with the changed lights if the serial port has room for it.
+    */
+    void execute();
+
+    /**
+      @brief enables or disables sending packets
+
+      While disabled #execute() returns immediately.
+
+      @param isEnabled true to send packets
+    */
+    void setEnabled(bool const isEnabled);
+};
+
+#endif
@@ -0,0 +1,148 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "LEDVoltageMonitor.h"
+#include <Arduino.h>
+
+#define VOLTAGE_MONITOR_ADC_COUNTS 1024
+//the filter keeps 16 times the ADC value, so the full range is 1024 * 16 = 2^14
+#define VOLTAGE_MONITOR_FILTER_SHIFT 4
+#define VOLTAGE_MONITOR_FULL_SCALE_SHIFT 14
+
+#ifdef __AVR__
+LEDVoltageMonitor * LEDVoltageMonitor::_adcOwner = 0;
+
+//reference selected with analogReference(), kept by the Arduino core for analogRead()
+extern "C" uint8_t analog_reference;
+#endif
+
+LEDVoltageMonitor::LEDVoltageMonitor(unsigned char const sensePin, float const referenceVoltage, float const senseFactor,
+                                     float const lowVoltage, unsigned char const lowPin, unsigned char const okPin,
+                                     float const highVoltage, unsigned char const highPin, float const hysteresisVoltage):
+  _sensePin(sensePin),
+  _lowPin(lowPin),
+  _okPin(okPin),
+  _highPin(highPin),
+  _fullScaleMv(referenceVoltage * senseFactor * 1000),
+  _lowThreshold(toFilterUnits(lowVoltage, referenceVoltage, senseFactor)),
+  _highThreshold(toFilterUnits(highVoltage, referenceVoltage, senseFactor)),
+  _hysteresis(limitHysteresis(toFilterUnits(hysteresisVoltage, referenceVoltage, senseFactor), _lowThreshold, _highThreshold)),
+  _filtered(0),
+  _state(VOLTAGE_UNKNOWN)
+{
+#ifdef __AVR__
+  //same mapping as analogRead(), pin numbers and channel numbers are both accepted
+  _channel = (sensePin >= A0) ? (sensePin - A0) : sensePin;
+#if defined(analogPinToChannel)
+  _channel = analogPinToChannel(_channel);
+#endif
+#endif
+
+  if (_lowPin != NO_PIN) {
+    pinMode(_lowPin, OUTPUT);
+  }
+  if (_okPin != NO_PIN) {
+    pinMode(_okPin, OUTPUT);
+  }
+  if (_highPin != NO_PIN) {
+    pinMode(_highPin, OUTPUT);
+  }
+}
+
+unsigned int LEDVoltageMonitor::toFilterUnits(float const voltage, float const referenceVoltage, float const senseFactor) {
+  return (voltage * VOLTAGE_MONITOR_ADC_COUNTS * (1 << VOLTAGE_MONITOR_FILTER_SHIFT)) / (referenceVoltage * senseFactor);
+}
+
+unsigned int LEDVoltageMonitor::limitHysteresis(unsigned int const hysteresis, unsigned int const lowThreshold, unsigned int const highThreshold) {
+  if (not highThreshold) {
+    return hysteresis;
+  }
+
+  //the high threshold minus the hysteresis must not wrap around
+  const unsigned int maxHysteresis = (highThreshold > lowThreshold) ? (highThreshold - lowThreshold) : 0;
+  return (hysteresis < maxHysteresis) ? hysteresis : maxHysteresis;
+}
+
+void LEDVoltageMonitor::execute() {
+#ifdef __AVR__
+  if (_adcOwner == this) {
+    if (bit_is_set(ADCSRA, ADSC)) {
+      //conversion is still running, check again in the next loop
+      return;
+    }
+
+    _adcOwner = 0;
+    addSample(ADCW);
+  }
+  else if (not _adcOwner) {
+    _adcOwner = this;
+    //the same register setup as analogRead(), without waiting for the result
+#if defined(MUX5)
+    ADCSRB = (ADCSRB & ~_BV(MUX5)) | ((_channel & 0x08) ? _BV(MUX5) : 0);
+#endif
+    ADMUX = (analog_reference << 6) | (_channel & 0x07);
+    ADCSRA |= _BV(ADSC);
+  }
+#else
+  addSample(analogRead(_sensePin));
+#endif
+}
+
+void LEDVoltageMonitor::addSample(unsigned int const sample) {
+  if (_state == VOLTAGE_UNKNOWN) {
+    _filtered = sample << VOLTAGE_MONITOR_FILTER_SHIFT;
+  }
+  else {
+    _filtered = _filtered - (_filtered >> VOLTAGE_MONITOR_FILTER_SHIFT) + sample;
+  }
+
+  //the threshold of the current state is moved by the hysteresis to leave the state
+  const unsigned int lowLimit = (_state == VOLTAGE_LOW) ? (_lowThreshold + _hysteresis) : _lowThreshold;
+  const unsigned int highLimit = (_state == VOLTAGE_HIGH) ? (_highThreshold - _hysteresis) : _highThreshold;
+
+  unsigned char nextState = VOLTAGE_OK;
+  if (_filtered < lowLimit) {
+    nextState = VOLTAGE_LOW;
+  }
+  else if (_highThreshold && (_filtered > highLimit)) {
+    nextState = VOLTAGE_HIGH;
+  }
+
+  if (nextState != _state) {
+    writeStatus(nextState);
+    _state = nextState;
+  }
+}
+
+void LEDVoltageMonitor::writeStatus(unsigned char const state) {
+  if (_lowPin != NO_PIN) {
+    digitalWrite(_lowPin, (state == VOLTAGE_LOW) ? HIGH : LOW);
+  }
+  if (_okPin != NO_PIN) {
+    digitalWrite(_okPin, (state == VOLTAGE_OK) ? HIGH : LOW);
+  }
+  if (_highPin != NO_PIN) {
+    digitalWrite(_highPin, (state == VOLTAGE_HIGH) ? HIGH : LOW);
+  }
+}
+
+LEDVoltageMonitor::VoltageStates LEDVoltageMonitor::getState() const {
+  return (VoltageStates)_state;
+}
+
+unsigned int LEDVoltageMonitor::getVoltageMv() const {
+  return ((unsigned long)_filtered * _fullScaleMv) >> VOLTAGE_MONITOR_FULL_SCALE_SHIFT;
+}
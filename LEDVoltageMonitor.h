@@ -0,0 +1,151 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef LEDVOLTAGEMONITOR_H
+#define LEDVOLTAGEMONITOR_H
+
+/**
+  @brief Monitors a supply voltage and indicates the measured range with status LEDs.
+
+  On AVR boards the ADC conversion is started in one call of #execute() and collected in a later call,
+  so the lighting loop never waits for the ADC. Several monitors share the ADC by taking turns.
+  The filter starts with the first finished conversion. Each conversion uses the reference selected with
+  analogReference() when it starts. The sketch should not call analogRead() itself while monitors are running.
+
+  The samples are filtered with integer math and the status LEDs are only written when the measured
+  voltage crosses a threshold. A hysteresis keeps the status LEDs from toggling around a threshold.
+*/
+class LEDVoltageMonitor {
+  public:
+    ///State enumeration for the measured voltage range
+    enum VoltageStates {
+      ///No measurement has been taken yet
+      VOLTAGE_UNKNOWN,
+      ///The voltage is below the low threshold
+      VOLTAGE_LOW,
+      ///The voltage is between the low and the high threshold
+      VOLTAGE_OK,
+      ///The voltage is above the high threshold
+      VOLTAGE_HIGH
+    };
+
+    ///Pin number to use for unused status outputs
+    static const unsigned char NO_PIN = 0xFF;
+
+    /**
+      @brief creates a new LEDVoltageMonitor instance
+
+      The voltage thresholds are converted to ADC counts once, the monitor itself does not use floating point math.
+      All used status pins will be configured as OUTPUT.
+
+      @param sensePin analog pin connected to the voltage divider
+      @param referenceVoltage ADC reference voltage in V
+      @param senseFactor factor of the voltage divider, e.g. 2.0 for two equal resistors
+      @param lowVoltage voltages below this value are indicated by \p lowPin
+      @param lowPin status output for VOLTAGE_LOW
+      @param okPin status output for VOLTAGE_OK
+      @param highVoltage voltages above this value are indicated by \p highPin, 0 disables VOLTAGE_HIGH
+      @param highPin status output for VOLTAGE_HIGH
+      @param hysteresisVoltage voltage that has to be crossed in addition to a threshold to leave a low or high state,
+             limited to the difference between \p highVoltage and \p lowVoltage
+    */
+    LEDVoltageMonitor(unsigned char const sensePin, float const referenceVoltage, float const senseFactor,
+                      float const lowVoltage, unsigned char const lowPin, unsigned char const okPin,
+                      float const highVoltage = 0, unsigned char const highPin = NO_PIN, float const hysteresisVoltage = 0.05);
+
+    /**
+      @brief This method needs to be called in the loop() function of the sketch.
+
+      Collects a finished conversion or starts a new one if the ADC is idle. This method never waits for the ADC.
+    */
+    void execute();
+
+    /**
+      @brief returns the range of the filtered voltage
+
+      @return current voltage state
+    */
+    VoltageStates getState() const;
+
+    /**
+      @brief returns the filtered voltage in mV
+
+      @return filtered voltage in mV
+    */
+    unsigned int getVoltageMv() const;
+
+  private:
+    ///analog pin connected to the voltage divider
+    const unsigned char _sensePin;
+    ///status output for VOLTAGE_LOW
+    const unsigned char _lowPin;
+    ///status output for VOLTAGE_OK
+    const unsigned char _okPin;
+    ///status output for VOLTAGE_HIGH
+    const unsigned char _highPin;
+    ///voltage at the full ADC range in mV
+    const unsigned int _fullScaleMv;
+    ///low threshold in filter units
+    const unsigned int _lowThreshold;
+    ///high threshold in filter units, 0 if disabled
+    const unsigned int _highThreshold;
+    ///hysteresis in filter units
+    const unsigned int _hysteresis;
+    ///filtered ADC value, scaled by 16
+    unsigned int _filtered;
+    ///current voltage state
+    unsigned char _state;
+#ifdef __AVR__
+    ///ADC input channel of the sense pin
+    unsigned char _channel;
+    ///monitor that currently owns the ADC conversion, 0 if the ADC is idle
+    static LEDVoltageMonitor * _adcOwner;
+#endif
+
+    /**
+      @brief converts a voltage into filter units
+
+      @param voltage voltage at the divider input in V
+      @param referenceVoltage ADC reference voltage in V
+      @param senseFactor factor of the voltage divider
+      @return voltage in filter units
+    */
+    static unsigned int toFilterUnits(float const voltage, float const referenceVoltage, float const senseFactor);
+
+    /**
+      @brief limits the hysteresis, so leaving the high state never requires a voltage below the low threshold
+
+      @param hysteresis hysteresis in filter units
+      @param lowThreshold low threshold in filter units
+      @param highThreshold high threshold in filter units, 0 if disabled
+      @return hysteresis in filter units
+    */
+    static unsigned int limitHysteresis(unsigned int const hysteresis, unsigned int const lowThreshold, unsigned int const highThreshold);
+
+    /**
+      @brief adds a new ADC sample to the filter and updates the status outputs
+
+      @param sample raw ADC value
+    */
+    void addSample(unsigned int const sample);
+
+    /**
+      @brief writes the status outputs for \p state
+    */
+    void writeStatus(unsigned char const state);
+};
+
+#endif
@@ -0,0 +1,207 @@
+#include <LEDLightingCycle.h>
+#include <LEDLightingScheduler.h>
+#include <LEDEffectStack.h>
+#include <avr/sleep.h>
+
+/*
+  Benchmark firmware for Tools/avr_report.sh.
+
+  Counts the CPU cycles of execute() and getBrightness() calls with timer 1 running at the CPU clock
+  and prints one table row per measurement on the serial port. The measurements work on real boards
+  as well as in simavr.
+*/
+
+//number of measured calls per row
+#define BENCHMARK_RUNS 200
+
+//define PWM capable pins, same as Yard_Office
+#define PWM_PIN0 3
+#define PWM_PIN1 5
+#define PWM_PIN2 6
+#define PWM_PIN3 9 //timer 1, analogWrite() only sets the compare output, the cycle counter keeps running
+#define PWM_PIN4 10 //timer 1
+#define PWM_PIN5 11
+
+//number of LEDs in the Yard_Office configuration
+#define LED_COUNT 6
+
+extern char * __brkval;
+extern char __heap_start;
+
+unsigned char trigger = 1;
+
+//cycles needed to read the timer twice
+unsigned int timerOverhead = 0;
+
+//Yard_Office configuration
+const LEDTimingRanges officeTiming PROGMEM = {5 * 60 * 1000ul, 10 * 60 * 1000ul, 5 * 60 * 1000ul, 10 * 60 * 1000ul};
+const LEDTimingRanges backOfficeTiming PROGMEM = {30 * 1000ul, 2 * 60 * 1000ul, 2 * 60 * 1000ul, 10 * 60 * 1000ul};
+LEDStaticLighting * ledSetups[LED_COUNT];
+
+struct BenchmarkResult {
+  unsigned int minCycles;
+  unsigned int maxCycles;
+  unsigned long totalCycles;
+};
+
+void startResult(BenchmarkResult & result) {
+  result.minCycles = 0xFFFF;
+  result.maxCycles = 0;
+  result.totalCycles = 0;
+}
+
+void addCycles(BenchmarkResult & result, unsigned int cycles) {
+  cycles = (cycles > timerOverhead) ? (cycles - timerOverhead) : 0;
+  if (cycles < result.minCycles) {
+    result.minCycles = cycles;
+  }
+  if (cycles > result.maxCycles) {
+    result.maxCycles = cycles;
+  }
+  result.totalCycles += cycles;
+}
+
+void printResult(const __FlashStringHelper * name, const __FlashStringHelper * method, BenchmarkResult & result) {
+  Serial.print(F("| "));
+  Serial.print(name);
+  Serial.print(F(" | "));
+  Serial.print(method);
+  Serial.print(F(" | "));
+  Serial.print(result.minCycles);
+  Serial.print(F(" | "));
+  Serial.print(result.totalCycles / BENCHMARK_RUNS);
+  Serial.print(F(" | "));
+  Serial.print(result.maxCycles);
+  Serial.println(F(" |"));
+}
+
+void benchmarkExecute(const __FlashStringHelper * name, LEDStaticLighting * light) {
+  BenchmarkResult result;
+  startResult(result);
+
+  for (unsigned int run = 0; run < BENCHMARK_RUNS; run++) {
+    noInterrupts();
+    const unsigned int startCycles = TCNT1;
+    light->execute();
+    const unsigned int endCycles = TCNT1;
+    interrupts();
+    addCycles(result, endCycles - startCycles);
+    delayMicroseconds(500); //let millis() advance between calls
+  }
+
+  printResult(name, F("execute()"), result);
+}
+
+void benchmarkBrightness(const __FlashStringHelper * name, LEDLightingEffect * effect) {
+  BenchmarkResult result;
+  startResult(result);
+
+  for (unsigned int run = 0; run < BENCHMARK_RUNS; run++) {
+    noInterrupts();
+    const unsigned int startCycles = TCNT1;
+    effect->getBrightness(255);
+    const unsigned int endCycles = TCNT1;
+    interrupts();
+    addCycles(result, endCycles - startCycles);
+    delayMicroseconds(500);
+  }
+
+  printResult(name, F("getBrightness()"), result);
+}
+
+void setup() {
+  Serial.begin(115200);
+
+  //timer 1 counts CPU cycles
+  TCCR1A = 0;
+  TCCR1B = _BV(CS10);
+  noInterrupts();
+  const unsigned int startCycles = TCNT1;
+  const unsigned int endCycles = TCNT1;
+  interrupts();
+  timerOverhead = endCycles - startCycles;
+
+  Serial.println(F("| Class | Method | Min cycles | Avg cycles | Max cycles |"));
+  Serial.println(F("|---|---|---|---|---|"));
+
+  //effects
+  LEDOneShotEffect * fadeEffect = new FadeEffect(1000, FadeEffect::FADE_IN);
+  fadeEffect->reset();
+  benchmarkBrightness(F("FadeEffect"), fadeEffect);
+
+  LEDOneShotEffect * fluorescentEffect = new FluorescentStartEffect(60000, 60000);
+  fluorescentEffect->reset();
+  benchmarkBrightness(F("FluorescentStartEffect"), fluorescentEffect);
+
+  benchmarkBrightness(F("LEDCyclicEffect"), new LEDCyclicEffect());
+  benchmarkBrightness(F("BeaconEffect"), new BeaconEffect(1500));
+  benchmarkBrightness(F("CandleEffect"), new CandleEffect());
+  benchmarkBrightness(F("FireEffect"), new FireEffect());
+  benchmarkBrightness(F("WeldingEffect"), new WeldingEffect());
+  benchmarkBrightness(F("TVEffect"), new TVEffect());
+  LEDEffectStack * effectStack = new LEDEffectStack(2);
+  effectStack->addLayer(new BeaconEffect(1500));
+  effectStack->addLayer(new CandleEffect(60, 40), LEDEffectStack::BLEND_MULTIPLY);
+  benchmarkBrightness(F("LEDEffectStack"), effectStack);
+
+  //lighting cycles in their steady on state
+  benchmarkExecute(F("LEDStaticLighting"), new LEDStaticLighting(PWM_PIN0, 255));
+  LEDStaticLighting * randomCycle = new LEDRandomLightingCycle(PWM_PIN1, 255, 60000, 60000, 1, 1);
+  randomCycle->execute();
+  randomCycle->execute();
+  benchmarkExecute(F("LEDRandomLightingCycle"), randomCycle);
+  benchmarkExecute(F("LEDTriggeredCycle"), new LEDTriggeredCycle(PWM_PIN2, 255, 1, 1, 1, 1, trigger));
+  benchmarkExecute(F("LEDChainedCycle"), new LEDChainedCycle(PWM_PIN5, 255, randomCycle, 1, 1, 60000, 60000));
+
+  //Yard_Office configuration
+  char * const heapStart = __brkval ? __brkval : &__heap_start;
+  ledSetups[0] = new LEDStaticLighting(PWM_PIN0, 255);
+  ledSetups[1] = new LEDStaticLighting(PWM_PIN1, 255);
+  ledSetups[2] = new LEDStaticLighting(PWM_PIN2, 255);
+  ledSetups[3] = new LEDRandomLightingCycle(PWM_PIN3, 255, &officeTiming, new LEDCyclicEffect(), new FluorescentStartEffect(500, 4000), new FadeEffect(50, FadeEffect::FADE_OUT));
+  ledSetups[4] = new LEDRandomLightingCycle(PWM_PIN4, 255, &officeTiming, new LEDCyclicEffect(), new FluorescentStartEffect(1000, 4000), new FadeEffect(50, FadeEffect::FADE_OUT));
+  ledSetups[5] = new LEDChainedCycle(PWM_PIN5, 255, ledSetups[4], &backOfficeTiming, new LEDCyclicEffect(), new FluorescentStartEffect(500, 2000), new FadeEffect(50, FadeEffect::FADE_OUT) );
+  char * const heapEnd = __brkval;
+  LEDLightingScheduler * scheduler = new LEDLightingScheduler(ledSetups, LED_COUNT);
+
+  BenchmarkResult result;
+  startResult(result);
+  for (unsigned int run = 0; run < BENCHMARK_RUNS; run++) {
+    noInterrupts();
+    const unsigned int startCycles = TCNT1;
+    for (unsigned char ledIndex = 0; ledIndex < LED_COUNT; ledIndex++) {
+      ledSetups[ledIndex]->execute();
+    }
+    const unsigned int endCycles = TCNT1;
+    interrupts();
+    addCycles(result, endCycles - startCycles);
+    delayMicroseconds(500);
+  }
+  printResult(F("Yard_Office"), F("loop()"), result);
+
+  startResult(result);
+  for (unsigned int run = 0; run < BENCHMARK_RUNS; run++) {
+    noInterrupts();
+    const unsigned int startCycles = TCNT1;
+    scheduler->execute();
+    const unsigned int endCycles = TCNT1;
+    interrupts();
+    addCycles(result, endCycles - startCycles);
+    delayMicroseconds(500);
+  }
+  printResult(F("Yard_Office"), F("LEDLightingScheduler::execute()"), result);
+
+  //heap of the Yard_Office lights and effects including the malloc overhead, kept out of the table
+  Serial.println();
+  Serial.print(F("heap bytes: "));
+  Serial.println(heapEnd - heapStart);
+
+  //stop the simulation
+  Serial.flush();
+  noInterrupts();
+  sleep_enable();
+  sleep_cpu();
+}
+
+void loop() {
+}
@@ -0,0 +1,137 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+/*
+  Minimal Arduino API for running the library on a PC.
+
+  All time, random and pin functions operate on the HostBoard of the calling thread,
+  so every thread can simulate a different board.
+*/
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+//set for library code that has a simulated path, e.g. for sleeping
+#define ARDUINO_HOST_SIMULATOR
+
+#define PI 3.1415926535897932384626433832795
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+#define LED_BUILTIN 13
+
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A4 18
+#define A5 19
+
+#define PROGMEM
+#define pgm_read_byte(address) (*(const uint8_t *)(address))
+#define pgm_read_word(address) (*(const uint16_t *)(address))
+#define pgm_read_dword(address) (*(const uint32_t *)(address))
+#define pgm_read_ptr(address) (*(void * const *)(address))
+#define memcpy_P memcpy
+#define strcmp_P strcmp
+#define PSTR(string) (string)
+
+class __FlashStringHelper;
+#define F(string) (reinterpret_cast<const __FlashStringHelper *>(string))
+
+typedef uint8_t byte;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+
+/**
+  @brief sleeps until \p untilMs or until the simulated interrupt of the board fires
+
+  Models sleep_cpu(): the interrupt handler set in the HostBoard runs at its time if that is earlier.
+*/
+void hostSleep(unsigned long untilMs);
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+void analogWrite(uint8_t pin, int value);
+int analogRead(uint8_t pin);
+
+void noInterrupts();
+void interrupts();
+
+//PWM timers of the pins as on an Uno, so checks for pins of a timer taken by the library can run on the host
+#define NOT_ON_TIMER 0
+#define TIMER0A 1
+#define TIMER0B 2
+#define TIMER1A 3
+#define TIMER1B 4
+#define TIMER2A 7
+#define TIMER2B 8
+#define digitalPinToTimer(pin) (((pin) == 3) ? TIMER2B : ((pin) == 5) ? TIMER0B : ((pin) == 6) ? TIMER0A : \
+                                ((pin) == 9) ? TIMER1A : ((pin) == 10) ? TIMER1B : ((pin) == 11) ? TIMER2A : NOT_ON_TIMER)
+
+//pin interrupts are never raised on the host, drivers are fed directly
+#define digitalPinToInterrupt(pin) (pin)
+void attachInterrupt(uint8_t interruptNumber, void (*handler)(), int mode);
+void detachInterrupt(uint8_t interruptNumber);
+
+/*
+  Text output as used by the library, numbers are printed in decimal only.
+*/
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t character) = 0;
+    virtual size_t write(const uint8_t * buffer, size_t size);
+    virtual int availableForWrite() { return 0; }
+    size_t print(const __FlashStringHelper * text);
+    size_t print(const char * text);
+    size_t print(char character);
+    size_t print(unsigned long value);
+    size_t print(long value);
+    size_t print(unsigned char value) { return print((unsigned long)value); }
+    size_t print(unsigned int value) { return print((unsigned long)value); }
+    size_t print(int value) { return print((long)value); }
+    size_t println();
+    template <typename T> size_t println(T value) { return print(value) + println(); }
+};
+
+class Stream : public Print {
+  public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
+
+#endif
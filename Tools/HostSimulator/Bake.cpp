@@ -0,0 +1,239 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "HostSimulator.h"
+#include "LEDBakedPlayer.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+/*
+  Runs one controller of a layout with a fixed seed and writes the output brightness of every frame
+  as token streams for LEDBakedPlayer. The header is written to stdout, statistics to stderr.
+*/
+
+/**
+  @brief Encoder state of one output.
+*/
+struct BakedStream {
+  ///encoded tokens
+  std::vector<unsigned char> tokens;
+  ///value of the last value token
+  unsigned char value;
+  ///frames the value has been held since the last token
+  unsigned long holdFrames;
+  ///brightness of every frame, used to verify the playback
+  std::vector<unsigned char> frames;
+};
+
+/**
+  @brief Collects the frames of all lights of the baked controller.
+*/
+struct BakeContext {
+  ///one stream per light
+  std::vector<BakedStream> streams;
+};
+
+static void flushHold(BakedStream & stream) {
+  while (stream.holdFrames) {
+    if (stream.holdFrames <= LED_BAKED_MAX_SHORT_HOLD) {
+      stream.tokens.push_back(stream.holdFrames - 1);
+      stream.holdFrames = 0;
+    }
+    else {
+      const unsigned long frames = (stream.holdFrames < LED_BAKED_MAX_LONG_HOLD) ? stream.holdFrames : LED_BAKED_MAX_LONG_HOLD;
+      stream.tokens.push_back(LED_BAKED_LONG_HOLD | ((frames - 1) >> 8));
+      stream.tokens.push_back((frames - 1) & 0xFF);
+      stream.holdFrames -= frames;
+    }
+  }
+}
+
+static void addFrame(BakedStream & stream, unsigned char const value) {
+  if (stream.frames.size() && (value == stream.value)) {
+    stream.holdFrames++;
+  }
+  else {
+    flushHold(stream);
+
+    const int delta = (int)value - (int)stream.value;
+    if (stream.frames.size() && (delta >= -LED_BAKED_MAX_DELTA) && (delta <= LED_BAKED_MAX_DELTA)) {
+      stream.tokens.push_back(LED_BAKED_DELTA_ZERO + delta);
+    }
+    else {
+      stream.tokens.push_back(LED_BAKED_SET_VALUE);
+      stream.tokens.push_back(value);
+    }
+    stream.value = value;
+  }
+
+  stream.frames.push_back(value);
+}
+
+static void bakeFrame(const HostSimulator & simulator, unsigned long frameEndMs, void * context) {
+  BakeContext & bake = *(BakeContext *)context;
+  const HostController & controller = simulator.getController(0);
+
+  for (unsigned char lightIndex = 0; lightIndex < controller.lightCount; lightIndex++) {
+    addFrame(bake.streams[lightIndex], controller.lights[lightIndex]->getPinBrightness());
+  }
+}
+
+/**
+  @brief plays the streams with LEDBakedPlayer and compares the pins with the recorded frames
+
+  @param channels channel table of the streams
+  @param streams recorded streams
+  @param frameMs frame duration in ms
+  @return number of mismatching frames
+*/
+static unsigned long verifyPlayback(const std::vector<LEDBakedChannel> & channels, const std::vector<BakedStream> & streams, unsigned long const frameMs) {
+  HostBoard board;
+  initBoard(board, 1);
+  setCurrentBoard(&board);
+
+  LEDBakedPlayer player(channels.data(), channels.size(), frameMs);
+  unsigned long mismatchCount = 0;
+  const unsigned long frameCount = streams[0].frames.size();
+
+  //play twice to check the loop
+  for (unsigned long frame = 0; frame < 2 * frameCount; frame++) {
+    board.timeMs = frame * frameMs;
+    player.execute();
+    for (unsigned char channelIndex = 0; channelIndex < channels.size(); channelIndex++) {
+      if (board.pinValues[channels[channelIndex].pin] != streams[channelIndex].frames[frame % frameCount]) {
+        mismatchCount++;
+      }
+    }
+  }
+
+  setCurrentBoard(0);
+  return mismatchCount;
+}
+
+static void printUsage(const char * const program) {
+  printf("usage: %s [options] > Show.h\n", program);
+  printf("  --layout NAME       sketch configuration to bake (default yard_office)\n");
+  printf("  --seed N            random seed (default 1)\n");
+  printf("  --minutes N         length of the show (default 60)\n");
+  printf("  --frame-ms N        frame length in ms (default 20)\n");
+  printf("  --name NAME         prefix of the generated names (default bakedShow)\n");
+}
+
+int main(int argc, char * argv[]) {
+  const char * layoutName = "yard_office";
+  unsigned long seed = 1;
+  unsigned long durationMs = 60ul * 60 * 1000;
+  unsigned long frameMs = 20;
+  const char * name = "bakedShow";
+
+  for (int argIndex = 1; argIndex < argc; argIndex++) {
+    const char * const option = argv[argIndex];
+    if ((strcmp(option, "--help") == 0) || (argIndex + 1 >= argc)) {
+      printUsage(argv[0]);
+      return (strcmp(option, "--help") == 0) ? 0 : 1;
+    }
+
+    const char * const value = argv[++argIndex];
+    if (strcmp(option, "--layout") == 0) {
+      layoutName = value;
+    }
+    else if (strcmp(option, "--seed") == 0) {
+      seed = strtoul(value, 0, 10);
+    }
+    else if (strcmp(option, "--minutes") == 0) {
+      durationMs = strtoul(value, 0, 10) * 60ul * 1000;
+    }
+    else if (strcmp(option, "--frame-ms") == 0) {
+      frameMs = strtoul(value, 0, 10);
+    }
+    else if (strcmp(option, "--name") == 0) {
+      name = value;
+    }
+    else {
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  const HostLayout * const layout = findLayout(layoutName);
+  if (not layout || not frameMs || (durationMs < frameMs)) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  HostSimulator simulator(*layout, 1, 1, frameMs, seed);
+  BakeContext bake;
+  bake.streams.resize(simulator.getController(0).lightCount);
+  for (unsigned char lightIndex = 0; lightIndex < bake.streams.size(); lightIndex++) {
+    bake.streams[lightIndex].value = 0;
+    bake.streams[lightIndex].holdFrames = 0;
+  }
+
+  //frame 0 is the state after setup(), the callback records the following frames
+  bakeFrame(simulator, 0, &bake);
+  simulator.setFrameCallback(bakeFrame, &bake);
+  simulator.run((durationMs / frameMs - 1) * frameMs);
+
+  const HostController & controller = simulator.getController(0);
+  std::vector<LEDBakedChannel> channels(bake.streams.size());
+  unsigned long totalBytes = 0;
+  for (unsigned char lightIndex = 0; lightIndex < bake.streams.size(); lightIndex++) {
+    flushHold(bake.streams[lightIndex]);
+    channels[lightIndex].pin = controller.lights[lightIndex]->getPin();
+    channels[lightIndex].stream = bake.streams[lightIndex].tokens.data();
+    channels[lightIndex].length = bake.streams[lightIndex].tokens.size();
+    totalBytes += bake.streams[lightIndex].tokens.size();
+    if (bake.streams[lightIndex].tokens.size() > 0xFFFF) {
+      fprintf(stderr, "stream %u is longer than 64kB, use a shorter show or longer frames\n", lightIndex);
+      return 1;
+    }
+  }
+
+  const unsigned long mismatchCount = verifyPlayback(channels, bake.streams, frameMs);
+  fprintf(stderr, "%s: %u channels, %lu frames, %lu bytes, %lu playback mismatches\n", layout->name, (unsigned int)channels.size(), (unsigned long)bake.streams[0].frames.size(), totalBytes, mismatchCount);
+  if (mismatchCount) {
+    return 1;
+  }
+
+  std::string upperName;
+  for (const char * character = name; *character; character++) {
+    upperName += toupper(*character);
+  }
+
+  printf("/*\n  Baked show generated by Tools/HostSimulator/bake\n  layout %s, seed %lu, %lu frames of %lu ms, %lu bytes\n*/\n", layout->name, seed, (unsigned long)bake.streams[0].frames.size(), frameMs, totalBytes);
+  printf("#ifndef %s_H\n#define %s_H\n\n#include <LEDBakedPlayer.h>\n\n", upperName.c_str(), upperName.c_str());
+  printf("#define %s_FRAME_MS %lu\n#define %s_CHANNEL_COUNT %u\n\n", upperName.c_str(), frameMs, upperName.c_str(), (unsigned int)channels.size());
+
+  for (unsigned char lightIndex = 0; lightIndex < bake.streams.size(); lightIndex++) {
+    const std::vector<unsigned char> & tokens = bake.streams[lightIndex].tokens;
+    printf("const unsigned char %sStream%u[] PROGMEM = {", name, lightIndex);
+    for (unsigned long tokenIndex = 0; tokenIndex < tokens.size(); tokenIndex++) {
+      printf("%s0x%02X", (tokenIndex % 16) ? ", " : (tokenIndex ? ",\n  " : "\n  "), tokens[tokenIndex]);
+    }
+    printf("\n};\n\n");
+  }
+
+  printf("const LEDBakedChannel %sChannels[%s_CHANNEL_COUNT] PROGMEM = {\n", name, upperName.c_str());
+  for (unsigned char lightIndex = 0; lightIndex < channels.size(); lightIndex++) {
+    printf("  {%u, %sStream%u, sizeof(%sStream%u)}%s\n", channels[lightIndex].pin, name, lightIndex, name, lightIndex, (lightIndex + 1u < channels.size()) ? "," : "");
+  }
+  printf("};\n\n#endif\n");
+  return 0;
+}
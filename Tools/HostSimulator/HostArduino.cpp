@@ -0,0 +1,192 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "Arduino.h"
+#include "HostBoard.h"
+
+static thread_local HostBoard * currentBoard = 0;
+
+void initBoard(HostBoard & board, uint32_t const seed) {
+  board.timeMs = 0;
+  board.randomState = seed ? seed : 1;
+  memset(board.pinValues, 0, sizeof(board.pinValues));
+  memset(board.pinModes, INPUT, sizeof(board.pinModes));
+  board.pinChangeCount = 0;
+  board.interruptHandler = 0;
+  board.interruptTimeMs = 0;
+  board.pinHandler = 0;
+}
+
+void setCurrentBoard(HostBoard * const board) {
+  currentBoard = board;
+}
+
+HostBoard * getCurrentBoard() {
+  return currentBoard;
+}
+
+unsigned long millis() {
+  return currentBoard->timeMs;
+}
+
+unsigned long micros() {
+  return currentBoard->timeMs * 1000;
+}
+
+void delay(unsigned long ms) {
+  currentBoard->timeMs += ms;
+}
+
+void hostSleep(unsigned long untilMs) {
+  HostBoard & board = *currentBoard;
+  if (board.interruptHandler && ((long)(board.interruptTimeMs - untilMs) < 0)) {
+    if ((long)(board.interruptTimeMs - board.timeMs) > 0) {
+      board.timeMs = board.interruptTimeMs;
+    }
+
+    //the interrupt fires once, like a single edge on a pin
+    void (* const handler)() = board.interruptHandler;
+    board.interruptHandler = 0;
+    handler();
+    return;
+  }
+
+  if ((long)(untilMs - board.timeMs) > 0) {
+    board.timeMs = untilMs;
+  }
+}
+
+long random(long howbig) {
+  if (howbig <= 0) {
+    return 0;
+  }
+
+  //xorshift32, each board has its own sequence
+  uint32_t state = currentBoard->randomState;
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  currentBoard->randomState = state;
+  return state % howbig;
+}
+
+long random(long howsmall, long howbig) {
+  if (howsmall >= howbig) {
+    return howsmall;
+  }
+
+  return random(howbig - howsmall) + howsmall;
+}
+
+void randomSeed(unsigned long seed) {
+  currentBoard->randomState = seed ? seed : 1;
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  currentBoard->pinModes[pin] = mode;
+  if (currentBoard->pinHandler) {
+    currentBoard->pinHandler(pin);
+  }
+}
+
+static void writePin(uint8_t const pin, unsigned char const value) {
+  if (currentBoard->pinValues[pin] != value) {
+    currentBoard->pinValues[pin] = value;
+    currentBoard->pinChangeCount++;
+  }
+  if (currentBoard->pinHandler) {
+    currentBoard->pinHandler(pin);
+  }
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  writePin(pin, value ? 255 : 0);
+}
+
+int digitalRead(uint8_t pin) {
+  return currentBoard->pinValues[pin] ? HIGH : LOW;
+}
+
+void analogWrite(uint8_t pin, int value) {
+  writePin(pin, value);
+}
+
+int analogRead(uint8_t pin) {
+  //nominal supply voltages on all analog inputs
+  return 512;
+}
+
+void noInterrupts() {
+}
+
+void interrupts() {
+}
+
+void attachInterrupt(uint8_t interruptNumber, void (*handler)(), int mode) {
+}
+
+void detachInterrupt(uint8_t interruptNumber) {
+}
+
+size_t Print::write(const uint8_t * buffer, size_t size) {
+  size_t count = 0;
+  while (size--) {
+    count += write(*buffer++);
+  }
+  return count;
+}
+
+size_t Print::print(const __FlashStringHelper * text) {
+  return print(reinterpret_cast<const char *>(text));
+}
+
+size_t Print::print(const char * text) {
+  size_t count = 0;
+  while (*text) {
+    count += write(*text++);
+  }
+  return count;
+}
+
+size_t Print::print(char character) {
+  return write(character);
+}
+
+size_t Print::print(unsigned long value) {
+  char digits[11];
+  unsigned char digitCount = 0;
+  do {
+    digits[digitCount++] = '0' + value % 10;
+    value /= 10;
+  } while (value);
+
+  size_t count = 0;
+  while (digitCount) {
+    count += write(digits[--digitCount]);
+  }
+  return count;
+}
+
+size_t Print::print(long value) {
+  if (value < 0) {
+    return write('-') + print(0ul - (unsigned long)value);
+  }
+  return print((unsigned long)value);
+}
+
+size_t Print::println() {
+  return write('\r') + write('\n');
+}
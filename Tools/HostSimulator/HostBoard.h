@@ -0,0 +1,72 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef HOSTBOARD_H
+#define HOSTBOARD_H
+
+#include <stdint.h>
+
+///number of pins of a simulated board
+#define HOST_PIN_COUNT 256
+
+/**
+  @brief State of one simulated board.
+
+  The Arduino functions of the host simulator read and write the board assigned to the calling thread
+  with setCurrentBoard().
+*/
+struct HostBoard {
+  ///simulated millis() value
+  unsigned long timeMs;
+  ///state of the random number generator
+  uint32_t randomState;
+  ///last value written to each pin, digital HIGH is stored as 255
+  unsigned char pinValues[HOST_PIN_COUNT];
+  ///mode set by pinMode() for each pin
+  unsigned char pinModes[HOST_PIN_COUNT];
+  ///number of writes that changed the value of a pin
+  unsigned long pinChangeCount;
+  ///interrupt raised once when hostSleep() reaches #interruptTimeMs, 0 for none
+  void (*interruptHandler)();
+  ///time of the simulated interrupt in ms
+  unsigned long interruptTimeMs;
+  ///called after every pinMode(), digitalWrite() and analogWrite() with the pin number, 0 for none
+  void (*pinHandler)(uint8_t pin);
+};
+
+/**
+  @brief resets \p board to time 0 with all pins off
+
+  @param board board to reset
+  @param seed seed of the random number generator
+*/
+void initBoard(HostBoard & board, uint32_t const seed);
+
+/**
+  @brief assigns \p board to the calling thread
+
+  @param board board used by the Arduino functions called from this thread
+*/
+void setCurrentBoard(HostBoard * const board);
+
+/**
+  @brief returns the board of the calling thread
+
+  @return current board
+*/
+HostBoard * getCurrentBoard();
+
+#endif
@@ -0,0 +1,62 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "HostLayouts.h"
+#include <Arduino.h>
+#include <string.h>
+
+//timing ranges of the Yard_Office example
+const LEDTimingRanges officeTiming PROGMEM = {5*60*1000ul, 10*60*1000ul, 5*60*1000ul, 10*60*1000ul};
+const LEDTimingRanges backOfficeTiming PROGMEM = {30*1000ul, 2*60*1000ul, 2*60*1000ul, 10*60*1000ul};
+
+//same lights as Examples/Yard_Office without the voltage monitors
+static unsigned char setupYardOffice(LEDStaticLighting ** const lights) {
+  lights[0] = new LEDStaticLighting(3, 255);
+  lights[1] = new LEDStaticLighting(5, 255);
+  lights[2] = new LEDStaticLighting(6, 255);
+  lights[3] = new LEDRandomLightingCycle(9, 255, &officeTiming, new LEDCyclicEffect(), new FluorescentStartEffect(500, 4000), new FadeEffect(50, FadeEffect::FADE_OUT));
+  lights[4] = new LEDRandomLightingCycle(10, 255, &officeTiming, new LEDCyclicEffect(), new FluorescentStartEffect(1000, 4000), new FadeEffect(50, FadeEffect::FADE_OUT));
+  lights[5] = new LEDChainedCycle(11, 255, lights[4], &backOfficeTiming, new LEDCyclicEffect(), new FluorescentStartEffect(500, 2000), new FadeEffect(50, FadeEffect::FADE_OUT));
+  return 6;
+}
+
+//same lights as Examples/Arduino_Nano_Simple
+static unsigned char setupNanoSimple(LEDStaticLighting ** const lights) {
+  lights[0] = new LEDRandomLightingCycle(3, 255, 5*60*1000ul, 10*60*1000ul, 5*60*1000ul, 10*60*1000ul, new LEDCyclicEffect(), new FadeEffect(500, FadeEffect::FADE_IN), new FadeEffect(500, FadeEffect::FADE_OUT));
+  lights[1] = new LEDChainedCycle(5, 255, lights[0], 30*1000ul, 2*60*1000ul, 2*60*1000ul, 10*60*1000ul, new LEDCyclicEffect(), new FadeEffect(500, FadeEffect::FADE_IN), new FadeEffect(500, FadeEffect::FADE_OUT));
+  lights[2] = new LEDChainedCycle(6, 255, lights[0], 30*1000ul, 2*60*1000ul, 2*60*1000ul, 10*60*1000ul, new LEDCyclicEffect(), new FadeEffect(500, FadeEffect::FADE_IN), new FadeEffect(500, FadeEffect::FADE_OUT));
+  return 3;
+}
+
+static const HostLayout layouts[] = {
+  {"yard_office", 6, setupYardOffice},
+  {"nano_simple", 3, setupNanoSimple}
+};
+
+const HostLayout * findLayout(const char * const name) {
+  for (unsigned char layoutIndex = 0; layoutIndex < sizeof(layouts) / sizeof(layouts[0]); layoutIndex++) {
+    if (strcmp(layouts[layoutIndex].name, name) == 0) {
+      return &layouts[layoutIndex];
+    }
+  }
+
+  return 0;
+}
+
+const HostLayout * getLayouts(unsigned char & layoutCount) {
+  layoutCount = sizeof(layouts) / sizeof(layouts[0]);
+  return layouts;
+}
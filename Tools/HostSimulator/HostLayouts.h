@@ -0,0 +1,58 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef HOSTLAYOUTS_H
+#define HOSTLAYOUTS_H
+
+#include "LEDLightingCycle.h"
+
+/**
+  @brief Creates the lights of one controller, like the setup() function of a sketch.
+
+  @param lights array receiving the created lights
+  @return number of lights created
+*/
+typedef unsigned char (*HostLayoutSetup)(LEDStaticLighting ** const lights);
+
+/**
+  @brief Sketch configuration that can be simulated on many controllers.
+*/
+struct HostLayout {
+  ///name used on the command line
+  const char * name;
+  ///number of lights created by #setup
+  unsigned char lightCount;
+  ///creates the lights
+  HostLayoutSetup setup;
+};
+
+/**
+  @brief returns the layout with the name \p name
+
+  @param name name of the layout
+  @return layout or 0 if there is no layout with this name
+*/
+const HostLayout * findLayout(const char * const name);
+
+/**
+  @brief returns all layouts
+
+  @param layoutCount receives the number of layouts
+  @return array of layouts
+*/
+const HostLayout * getLayouts(unsigned char & layoutCount);
+
+#endif
@@ -0,0 +1,190 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "HostSimulator.h"
+#include <thread>
+#include <vector>
+
+///number of checks of the barrier before the thread yields
+#define BARRIER_SPIN_COUNT 64
+
+HostSimulator::HostSimulator(const HostLayout & layout, unsigned int const controllerCount, unsigned int const threadCount, unsigned long const frameMs, unsigned long const seed):
+  _controllers(new HostController[controllerCount]),
+  _controllerCount(controllerCount),
+  _threadCount(threadCount ? threadCount : 1),
+  _workers(new Worker[_threadCount]),
+  _frameMs(frameMs ? frameMs : 1),
+  _frameEndMs(0),
+  _isFinished(false),
+  _barrierCount(0),
+  _barrierGeneration(0),
+  _frameCallback(0),
+  _frameCallbackContext(0)
+{
+  for (unsigned int controllerIndex = 0; controllerIndex < _controllerCount; controllerIndex++) {
+    HostController & controller = _controllers[controllerIndex];
+    initBoard(controller.board, seed + controllerIndex);
+
+    //the constructors of the lights access the pins of the current board
+    setCurrentBoard(&controller.board);
+    controller.lights = new LEDStaticLighting * [layout.lightCount];
+    controller.lightCount = layout.setup(controller.lights);
+    controller.scheduler = new LEDLightingScheduler(controller.lights, controller.lightCount);
+  }
+  setCurrentBoard(0);
+}
+
+HostSimulator::~HostSimulator() {
+  //the effects are owned by the lights, which have no destructors, so only the arrays are freed
+  for (unsigned int controllerIndex = 0; controllerIndex < _controllerCount; controllerIndex++) {
+    delete _controllers[controllerIndex].scheduler;
+    delete [] _controllers[controllerIndex].lights;
+  }
+  delete [] _controllers;
+  delete [] _workers;
+}
+
+void HostSimulator::setFrameCallback(FrameCallback const callback, void * const context) {
+  _frameCallback = callback;
+  _frameCallbackContext = context;
+}
+
+void HostSimulator::waitForFrameBoundary() {
+  const unsigned long generation = _barrierGeneration.load(std::memory_order_acquire);
+
+  if (_barrierCount.fetch_add(1, std::memory_order_acq_rel) + 1 == _threadCount) {
+    //last thread to arrive releases all others
+    _barrierCount.store(0, std::memory_order_relaxed);
+    _barrierGeneration.store(generation + 1, std::memory_order_release);
+    return;
+  }
+
+  unsigned int spinCount = 0;
+  while (_barrierGeneration.load(std::memory_order_acquire) == generation) {
+    if (++spinCount > BARRIER_SPIN_COUNT) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+void HostSimulator::runController(HostController & controller) {
+  setCurrentBoard(&controller.board);
+  HostBoard & board = controller.board;
+
+  while ((long)(board.timeMs - _frameEndMs) < 0) {
+    controller.scheduler->execute();
+
+    //jump to the next update, but make progress even if a light is due immediately again
+    unsigned long nextUpdateMs = controller.scheduler->getNextUpdateMs();
+    if ((long)(nextUpdateMs - board.timeMs) <= 0) {
+      nextUpdateMs = board.timeMs + 1;
+    }
+    board.timeMs = ((long)(nextUpdateMs - _frameEndMs) < 0) ? nextUpdateMs : _frameEndMs;
+  }
+}
+
+void HostSimulator::runFrame(unsigned int const workerIndex) {
+  const unsigned int chunkCount = (_controllerCount + HOST_CHUNK_CONTROLLERS - 1) / HOST_CHUNK_CONTROLLERS;
+
+  //own chunks first, then steal from the other workers
+  for (unsigned int offset = 0; offset < _threadCount; offset++) {
+    Worker & worker = _workers[(workerIndex + offset) % _threadCount];
+
+    while (true) {
+      const unsigned int chunk = worker.nextChunk.fetch_add(1, std::memory_order_relaxed);
+      if ((chunk >= worker.endChunk) || (chunk >= chunkCount)) {
+        break;
+      }
+      if (offset) {
+        _workers[workerIndex].stealCount++;
+      }
+
+      const unsigned int firstController = chunk * HOST_CHUNK_CONTROLLERS;
+      const unsigned int lastController = (firstController + HOST_CHUNK_CONTROLLERS < _controllerCount) ? firstController + HOST_CHUNK_CONTROLLERS : _controllerCount;
+      for (unsigned int controllerIndex = firstController; controllerIndex < lastController; controllerIndex++) {
+        runController(_controllers[controllerIndex]);
+      }
+    }
+  }
+}
+
+void HostSimulator::runWorker(unsigned int const workerIndex) {
+  while (true) {
+    //wait for the frame to be prepared
+    waitForFrameBoundary();
+    if (_isFinished) {
+      break;
+    }
+
+    runFrame(workerIndex);
+    waitForFrameBoundary();
+  }
+}
+
+void HostSimulator::run(unsigned long const durationMs) {
+  const unsigned int chunkCount = (_controllerCount + HOST_CHUNK_CONTROLLERS - 1) / HOST_CHUNK_CONTROLLERS;
+  const unsigned long startMs = _frameEndMs;
+
+  for (unsigned int workerIndex = 0; workerIndex < _threadCount; workerIndex++) {
+    _workers[workerIndex].stealCount = 0;
+  }
+
+  _isFinished = false;
+  std::vector<std::thread> threads;
+  for (unsigned int workerIndex = 1; workerIndex < _threadCount; workerIndex++) {
+    threads.emplace_back(&HostSimulator::runWorker, this, workerIndex);
+  }
+
+  while ((long)(_frameEndMs - startMs) < (long)durationMs) {
+    //only this thread runs between two frames, so the queues can be refilled without locking
+    _frameEndMs += _frameMs;
+    for (unsigned int workerIndex = 0; workerIndex < _threadCount; workerIndex++) {
+      _workers[workerIndex].nextChunk.store(workerIndex * chunkCount / _threadCount, std::memory_order_relaxed);
+      _workers[workerIndex].endChunk = (workerIndex + 1) * chunkCount / _threadCount;
+    }
+
+    waitForFrameBoundary();
+    runFrame(0);
+    waitForFrameBoundary();
+
+    if (_frameCallback) {
+      _frameCallback(*this, _frameEndMs, _frameCallbackContext);
+    }
+  }
+
+  _isFinished = true;
+  waitForFrameBoundary();
+  for (unsigned int threadIndex = 0; threadIndex < threads.size(); threadIndex++) {
+    threads[threadIndex].join();
+  }
+  setCurrentBoard(0);
+}
+
+unsigned int HostSimulator::getControllerCount() const {
+  return _controllerCount;
+}
+
+const HostController & HostSimulator::getController(unsigned int const controllerIndex) const {
+  return _controllers[controllerIndex];
+}
+
+unsigned long HostSimulator::getStealCount() const {
+  unsigned long stealCount = 0;
+  for (unsigned int workerIndex = 0; workerIndex < _threadCount; workerIndex++) {
+    stealCount += _workers[workerIndex].stealCount;
+  }
+  return stealCount;
+}
@@ -0,0 +1,178 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef HOSTSIMULATOR_H
+#define HOSTSIMULATOR_H
+
+#include "HostBoard.h"
+#include "HostLayouts.h"
+#include "LEDLightingScheduler.h"
+#include <atomic>
+
+///number of controllers taken from a work queue at once
+#define HOST_CHUNK_CONTROLLERS 8
+
+/**
+  @brief One simulated board running one sketch configuration.
+*/
+struct HostController {
+  ///pins, clock and random state of the board
+  HostBoard board;
+  ///lights created by the layout
+  LEDStaticLighting ** lights;
+  ///number of lights in #lights
+  unsigned char lightCount;
+  ///executes the lights like loop() of a sketch
+  LEDLightingScheduler * scheduler;
+};
+
+/**
+  @brief Simulates many controllers in parallel on the host.
+
+  A controller is the unit of work: all lights of a controller are executed by the same thread,
+  so LEDChainedCycle objects and their master always run together, just like on the real board.
+  A master on another controller is not possible, since the chain is a pointer within one sketch.
+
+  The simulated time is split into frames. Within a frame each controller runs event driven: its clock
+  jumps to the next update time reported by its LEDLightingScheduler, so idle lights cost nothing.
+  The controllers are split into chunks and each thread owns a contiguous range of chunks. A thread that
+  has finished its own range steals the remaining chunks of the other threads. All threads meet only at the
+  frame boundaries, where all controllers have reached the same simulated time.
+*/
+class HostSimulator {
+  public:
+    /**
+      @brief called by the first thread at every frame boundary while all other threads wait
+
+      @param simulator simulator whose controllers all reached \p frameEndMs
+      @param frameEndMs simulated time at the end of the frame
+      @param context pointer passed to #setFrameCallback()
+    */
+    typedef void (*FrameCallback)(const HostSimulator & simulator, unsigned long frameEndMs, void * context);
+
+  private:
+    ///work queue of one thread, aligned to avoid sharing cache lines between threads
+    struct alignas(64) Worker {
+      ///next chunk to be executed
+      std::atomic<unsigned int> nextChunk;
+      ///first chunk not owned by this worker
+      unsigned int endChunk;
+      ///number of chunks taken from other workers
+      unsigned long stealCount;
+    };
+
+    ///simulated controllers
+    HostController * const _controllers;
+    ///number of controllers in #_controllers
+    const unsigned int _controllerCount;
+    ///number of threads including the calling thread
+    const unsigned int _threadCount;
+    ///work queues, one per thread
+    Worker * const _workers;
+    ///length of a frame in ms
+    const unsigned long _frameMs;
+    ///simulated time at the end of the current frame
+    unsigned long _frameEndMs;
+    ///set when all frames have been executed
+    bool _isFinished;
+    ///threads waiting at the frame boundary
+    std::atomic<unsigned int> _barrierCount;
+    ///incremented each time all threads reached the frame boundary
+    std::atomic<unsigned long> _barrierGeneration;
+    ///called at every frame boundary
+    FrameCallback _frameCallback;
+    ///passed to #_frameCallback
+    void * _frameCallbackContext;
+
+    /**
+      @brief waits until all threads reached the frame boundary
+    */
+    void waitForFrameBoundary();
+
+    /**
+      @brief executes chunks until no chunk of the current frame is left
+
+      @param workerIndex index of the calling thread
+    */
+    void runFrame(unsigned int const workerIndex);
+
+    /**
+      @brief thread function of the additional threads
+
+      @param workerIndex index of the thread
+    */
+    void runWorker(unsigned int const workerIndex);
+
+    /**
+      @brief executes a controller until the end of the current frame
+
+      @param controller controller to be executed
+    */
+    void runController(HostController & controller);
+
+  public:
+    /**
+      @brief creates all controllers
+
+      @param layout sketch configuration of each controller
+      @param controllerCount number of controllers
+      @param threadCount number of threads used by #run()
+      @param frameMs length of a frame in ms
+      @param seed random seed, controller n uses seed + n
+    */
+    HostSimulator(const HostLayout & layout, unsigned int const controllerCount, unsigned int const threadCount, unsigned long const frameMs, unsigned long const seed);
+
+    ~HostSimulator();
+
+    /**
+      @brief sets a function called at every frame boundary
+
+      @param callback function to be called or 0
+      @param context pointer passed to \p callback
+    */
+    void setFrameCallback(FrameCallback const callback, void * const context);
+
+    /**
+      @brief simulates all controllers for \p durationMs
+
+      @param durationMs simulated time in ms, rounded up to whole frames
+    */
+    void run(unsigned long const durationMs);
+
+    /**
+      @brief returns the number of controllers
+
+      @return number of controllers
+    */
+    unsigned int getControllerCount() const;
+
+    /**
+      @brief returns a controller
+
+      @param controllerIndex index of the controller
+      @return controller
+    */
+    const HostController & getController(unsigned int const controllerIndex) const;
+
+    /**
+      @brief returns the number of chunks executed by another thread than their owner
+
+      @return number of stolen chunks
+    */
+    unsigned long getStealCount() const;
+};
+
+#endif
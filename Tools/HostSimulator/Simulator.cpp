@@ -0,0 +1,175 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "HostSimulator.h"
+#include "TraceWriter.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+/**
+  @brief Collects the output brightness of all lights at each frame boundary.
+*/
+struct TraceContext {
+  ///trace file
+  TraceWriter writer;
+  ///brightness of all lights in the current frame
+  std::vector<unsigned char> values;
+  ///false after a write error
+  bool isWritten;
+};
+
+static void traceFrame(const HostSimulator & simulator, unsigned long frameEndMs, void * context) {
+  TraceContext & trace = *(TraceContext *)context;
+  unsigned int channel = 0;
+
+  for (unsigned int controllerIndex = 0; controllerIndex < simulator.getControllerCount(); controllerIndex++) {
+    const HostController & controller = simulator.getController(controllerIndex);
+    for (unsigned char lightIndex = 0; lightIndex < controller.lightCount; lightIndex++) {
+      trace.values[channel++] = controller.lights[lightIndex]->getPinBrightness();
+    }
+  }
+
+  if (trace.isWritten) {
+    trace.isWritten = trace.writer.addFrame(trace.values.data());
+  }
+}
+
+static void printUsage(const char * const program) {
+  unsigned char layoutCount;
+  const HostLayout * const layouts = getLayouts(layoutCount);
+
+  printf("usage: %s [options]\n", program);
+  printf("  --layout NAME       sketch configuration of each controller (default yard_office)\n");
+  printf("  --controllers N     number of simulated controllers (default 1667, about 10000 lights)\n");
+  printf("  --threads N         number of threads (default: number of cores)\n");
+  printf("  --days N            simulated days (default 1)\n");
+  printf("  --hours N           simulated hours, replaces --days\n");
+  printf("  --frame-ms N        frame length in simulated ms (default 1000)\n");
+  printf("  --seed N            random seed (default 1)\n");
+  printf("  --trace FILE        write the brightness of all lights at each frame to FILE\n");
+  printf("layouts:");
+  for (unsigned char layoutIndex = 0; layoutIndex < layoutCount; layoutIndex++) {
+    printf(" %s", layouts[layoutIndex].name);
+  }
+  printf("\n");
+}
+
+int main(int argc, char * argv[]) {
+  const char * layoutName = "yard_office";
+  unsigned long controllerCount = 1667;
+  unsigned long threadCount = std::thread::hardware_concurrency();
+  unsigned long durationMs = 24ul * 60 * 60 * 1000;
+  unsigned long frameMs = 1000;
+  unsigned long seed = 1;
+  const char * tracePath = 0;
+
+  for (int argIndex = 1; argIndex < argc; argIndex++) {
+    const char * const option = argv[argIndex];
+    if ((strcmp(option, "--help") == 0) || (argIndex + 1 >= argc)) {
+      printUsage(argv[0]);
+      return (strcmp(option, "--help") == 0) ? 0 : 1;
+    }
+
+    const char * const value = argv[++argIndex];
+    if (strcmp(option, "--layout") == 0) {
+      layoutName = value;
+    }
+    else if (strcmp(option, "--controllers") == 0) {
+      controllerCount = strtoul(value, 0, 10);
+    }
+    else if (strcmp(option, "--threads") == 0) {
+      threadCount = strtoul(value, 0, 10);
+    }
+    else if (strcmp(option, "--days") == 0) {
+      durationMs = strtoul(value, 0, 10) * 24ul * 60 * 60 * 1000;
+    }
+    else if (strcmp(option, "--hours") == 0) {
+      durationMs = strtoul(value, 0, 10) * 60ul * 60 * 1000;
+    }
+    else if (strcmp(option, "--frame-ms") == 0) {
+      frameMs = strtoul(value, 0, 10);
+    }
+    else if (strcmp(option, "--seed") == 0) {
+      seed = strtoul(value, 0, 10);
+    }
+    else if (strcmp(option, "--trace") == 0) {
+      tracePath = value;
+    }
+    else {
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  const HostLayout * const layout = findLayout(layoutName);
+  if (not layout) {
+    fprintf(stderr, "unknown layout %s\n", layoutName);
+    printUsage(argv[0]);
+    return 1;
+  }
+  if (not threadCount) {
+    threadCount = 1;
+  }
+
+  HostSimulator simulator(*layout, controllerCount, threadCount, frameMs, seed);
+  printf("layout %s, %lu controllers, %lu lights, %lu threads, %lu ms frames\n", layout->name, controllerCount, controllerCount * layout->lightCount, threadCount, frameMs);
+
+  TraceContext trace;
+  if (tracePath) {
+    trace.values.resize(controllerCount * layout->lightCount);
+    trace.isWritten = trace.writer.open(tracePath, trace.values.size(), layout->lightCount, frameMs);
+    if (not trace.isWritten) {
+      fprintf(stderr, "can not create %s\n", tracePath);
+      return 1;
+    }
+    //the state after setup() is frame 0
+    traceFrame(simulator, 0, &trace);
+    simulator.setFrameCallback(traceFrame, &trace);
+  }
+
+  const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+  simulator.run(durationMs);
+  const double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+  if (tracePath) {
+    if (not (trace.writer.close() && trace.isWritten)) {
+      fprintf(stderr, "writing %s failed\n", tracePath);
+      return 1;
+    }
+    printf("trace %s: %llu bytes\n", tracePath, (unsigned long long)trace.writer.getSize());
+  }
+
+  unsigned long pinChangeCount = 0;
+  unsigned long lightsOnCount = 0;
+  for (unsigned int controllerIndex = 0; controllerIndex < simulator.getControllerCount(); controllerIndex++) {
+    const HostController & controller = simulator.getController(controllerIndex);
+    pinChangeCount += controller.board.pinChangeCount;
+    for (unsigned char lightIndex = 0; lightIndex < controller.lightCount; lightIndex++) {
+      if (controller.lights[lightIndex]->getPinBrightness()) {
+        lightsOnCount++;
+      }
+    }
+  }
+
+  const double simulatedSeconds = durationMs / 1000.0;
+  printf("simulated %.0f s in %.2f s (%.0fx real time)\n", simulatedSeconds, wallSeconds, simulatedSeconds / wallSeconds);
+  printf("%lu pin changes, %lu lights on at the end, %lu chunks stolen\n", pinChangeCount, lightsOnCount, simulator.getStealCount());
+  return 0;
+}
@@ -0,0 +1,73 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef BUFFERSTREAM_H
+#define BUFFERSTREAM_H
+
+#include "Arduino.h"
+#include <string>
+
+/**
+  @brief Stream for the host tests that reads from and writes to strings.
+*/
+class BufferStream : public Stream {
+  public:
+    ///characters not read yet
+    std::string input;
+    ///characters written so far
+    std::string output;
+
+    size_t write(uint8_t const character) {
+      output += (char)character;
+      return 1;
+    }
+
+    int availableForWrite() {
+      //same size as the transmit buffer of HardwareSerial
+      return 64;
+    }
+
+    int available() {
+      return input.size();
+    }
+
+    int read() {
+      if (input.empty()) {
+        return -1;
+      }
+
+      const unsigned char character = input[0];
+      input.erase(0, 1);
+      return character;
+    }
+
+    int peek() {
+      return input.empty() ? -1 : (unsigned char)input[0];
+    }
+
+    /**
+      @brief returns and clears the output written so far
+
+      @return output
+    */
+    std::string takeOutput() {
+      std::string result;
+      result.swap(output);
+      return result;
+    }
+};
+
+#endif
@@ -0,0 +1,91 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "HostTest.h"
+#include "HostBoard.h"
+#include <LEDLightingEffect.h>
+#include <LEDEffectStack.h>
+
+/*
+  Checks the batch evaluation of cyclic effects against the single light API and the exact beacon phase.
+*/
+
+#define BATCH_SIZE 64
+
+int main() {
+  HostBoard board;
+  initBoard(board, 1);
+  setCurrentBoard(&board);
+
+  unsigned long timesMs[BATCH_SIZE];
+  unsigned char maxBrightness[BATCH_SIZE];
+  unsigned char brightness[BATCH_SIZE];
+
+  //the steady base effect copies the max brightness for any time
+  LEDCyclicEffect steady;
+  for (unsigned char index = 0; index < BATCH_SIZE; index++) {
+    timesMs[index] = index * 12345ul;
+    maxBrightness[index] = index * 4;
+  }
+  steady.getBrightnessBatch(timesMs, maxBrightness, brightness, BATCH_SIZE);
+  for (unsigned char index = 0; index < BATCH_SIZE; index++) {
+    HOST_CHECK(brightness[index] == maxBrightness[index]);
+  }
+
+  //the beacon phase from the reciprocal stays within one brightness step of the exact phase
+  const unsigned int cycleTimesMs[] = {1, 7, 1024, 1500, 4999, 65535};
+  unsigned int worstError = 0;
+  for (unsigned char cycleIndex = 0; cycleIndex < sizeof(cycleTimesMs) / sizeof(cycleTimesMs[0]); cycleIndex++) {
+    const unsigned int cycleTimeMs = cycleTimesMs[cycleIndex];
+    BeaconEffect beacon(cycleTimeMs);
+    for (unsigned long startMs = 0; startMs < 200000; startMs += BATCH_SIZE * 37) {
+      unsigned short exactPhases[BATCH_SIZE];
+      unsigned char exactBrightness[BATCH_SIZE];
+      for (unsigned char index = 0; index < BATCH_SIZE; index++) {
+        timesMs[index] = startMs + index * 37;
+        maxBrightness[index] = 255;
+        exactPhases[index] = ((unsigned long long)(timesMs[index] % cycleTimeMs) << 16) / cycleTimeMs;
+      }
+      beacon.getBrightnessBatch(timesMs, maxBrightness, brightness, BATCH_SIZE);
+      BeaconEffect::getBrightnessForPhases(exactPhases, maxBrightness, exactBrightness, BATCH_SIZE);
+      for (unsigned char index = 0; index < BATCH_SIZE; index++) {
+        const unsigned int error = (brightness[index] > exactBrightness[index]) ? (brightness[index] - exactBrightness[index])
+                                   : (exactBrightness[index] - brightness[index]);
+        worstError = (error > worstError) ? error : worstError;
+      }
+    }
+  }
+  HOST_CHECK(worstError <= 1);
+
+  //the single light API returns the batch result for the current time
+  BeaconEffect beacon(1500);
+  CandleEffect candle;
+  LEDEffectStack stack(2);
+  stack.addLayer(new BeaconEffect(1500));
+  stack.addLayer(new FireEffect(), LEDEffectStack::BLEND_MULTIPLY);
+  LEDCyclicEffect * const effects[] = {&steady, &beacon, &candle, &stack};
+  for (board.timeMs = 0; board.timeMs < 10000; board.timeMs += 13) {
+    for (unsigned char effectIndex = 0; effectIndex < sizeof(effects) / sizeof(effects[0]); effectIndex++) {
+      const unsigned long currentTimeMs = board.timeMs;
+      const unsigned char fullBrightness = 200;
+      unsigned char batchBrightness;
+      effects[effectIndex]->getBrightnessBatch(&currentTimeMs, &fullBrightness, &batchBrightness, 1);
+      HOST_CHECK(effects[effectIndex]->getBrightness(fullBrightness) == batchBrightness);
+    }
+  }
+
+  return hostTestResult("CyclicEffectTest");
+}
@@ -0,0 +1,156 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "HostTest.h"
+#include "Arduino.h"
+#include "HostBoard.h"
+#include <LEDDccDecoder.h>
+#include <LEDLightingScheduler.h>
+
+/*
+  Feeds synthesized DCC signals to LEDDccDecoder::addEdge() and checks the trigger variables
+  and the reaction of scheduled lights.
+*/
+
+//half bit durations in us, the edges get a jitter of up to 4us and the 4us resolution of micros()
+#define ONE_HALF_BIT_US 58
+#define ZERO_HALF_BIT_US 100
+
+static LEDDccDecoder decoder(2, 5);
+static unsigned long signalTimeUs = 0;
+
+static void sendHalfBit(unsigned short const durationUs) {
+  signalTimeUs += durationUs + (random(9) - 4);
+  decoder.addEdge((signalTimeUs >> 2) << 2);
+}
+
+static void sendBit(unsigned char const bit) {
+  sendHalfBit(bit ? ONE_HALF_BIT_US : ZERO_HALF_BIT_US);
+  sendHalfBit(bit ? ONE_HALF_BIT_US : ZERO_HALF_BIT_US);
+}
+
+static void sendPacket(const unsigned char * const bytes, unsigned char const length) {
+  unsigned char checksum = 0;
+  for (unsigned char bitIndex = 0; bitIndex < 14; bitIndex++) {
+    sendBit(1);
+  }
+  for (unsigned char byteIndex = 0; byteIndex <= length; byteIndex++) {
+    const unsigned char value = (byteIndex < length) ? bytes[byteIndex] : checksum;
+    checksum ^= value;
+    sendBit(0);
+    for (signed char bitIndex = 7; bitIndex >= 0; bitIndex--) {
+      sendBit((value >> bitIndex) & 1);
+    }
+  }
+  sendBit(1);
+}
+
+static void sendIdle() {
+  static const unsigned char idlePacket[] = {0xFF, 0x00};
+  sendPacket(idlePacket, 2);
+}
+
+static void sendAccessory(unsigned short const address, unsigned char const value, bool const isActivated) {
+  const unsigned short decoderAddress = ((address - 1) >> 2) + 1;
+  const unsigned char bytes[] = {
+    (unsigned char)(0x80 | (decoderAddress & 0x3F)),
+    (unsigned char)(0x80 | ((~(decoderAddress >> 6) & 0x07) << 4) | (isActivated ? 0x08 : 0) | (((address - 1) & 0x03) << 1) | value)
+  };
+  sendPacket(bytes, 2);
+}
+
+static unsigned char stationTrigger = 0;
+
+static void receiveStationCommand() {
+  sendAccessory(100, 1, true);
+  sendIdle();
+}
+
+int main() {
+  HostBoard board;
+  initBoard(board, 1);
+  setCurrentBoard(&board);
+
+  unsigned char triggers[4] = {9, 9, 9, 9};
+  static const unsigned short addresses[4] = {1, 5, 2044, 100};
+  for (unsigned char index = 0; index < 4; index++) {
+    HOST_CHECK(decoder.addTrigger(addresses[index], triggers[index]));
+  }
+  HOST_CHECK(decoder.addTrigger(100, stationTrigger));
+  HOST_CHECK(not decoder.addTrigger(7, stationTrigger));
+  decoder.begin();
+
+  //commands between idle, locomotive and noise packets, only the activating command switches
+  for (unsigned char round = 0; round < 8; round++) {
+    const unsigned char index = round & 0x03;
+    const unsigned char value = (round >> 2) ^ (index & 1);
+    static const unsigned char speedPacket[] = {0x03, 0x3F, 0x10};
+    sendIdle();
+    decoder.execute();
+    sendPacket(speedPacket, 3);
+    decoder.execute();
+    sendHalfBit(7);
+    sendHalfBit(3000);
+    sendAccessory(addresses[index], value, true);
+    decoder.execute();
+    HOST_CHECK(triggers[index] == value);
+    sendAccessory(addresses[index], value ^ 1, false);
+    decoder.execute();
+    HOST_CHECK(triggers[index] == value);
+  }
+  HOST_CHECK(stationTrigger == triggers[3]);
+
+  //a corrupted checksum is ignored
+  const unsigned char previousTrigger = triggers[0];
+  const unsigned char corruptPacket[] = {0x81, (unsigned char)(0xF8 | (previousTrigger ^ 1)), 0x00};
+  sendPacket(corruptPacket, 3);
+  decoder.execute();
+  HOST_CHECK(triggers[0] == previousTrigger);
+
+  //a scheduled light without delay switches on the pass after the command
+  stationTrigger = 0;
+  LEDStaticLighting * lights[1];
+  lights[0] = new LEDTriggeredCycle(3, 255, 0, 0, 0, 0, stationTrigger);
+  LEDLightingScheduler scheduler(lights, 1);
+  for (unsigned char pass = 0; pass < 10; pass++) {
+    scheduler.sleepUntilNextUpdate();
+    decoder.execute();
+    scheduler.execute();
+  }
+  HOST_CHECK(board.pinValues[3] == 0);
+
+  //the command arrives while the board sleeps
+  board.interruptTimeMs = board.timeMs + 20;
+  board.interruptHandler = receiveStationCommand;
+  HOST_CHECK(scheduler.sleepUntilNextUpdate());
+  HOST_CHECK(board.timeMs == board.interruptTimeMs);
+  decoder.execute();
+  HOST_CHECK(stationTrigger == 1);
+  //one ms for the delay of 0 to elapse, then the transition state writes the output
+  const unsigned long commandMs = board.timeMs;
+  for (unsigned char pass = 0; pass < 10; pass++) {
+    scheduler.execute();
+    if (board.pinValues[3] == 255) {
+      break;
+    }
+    board.timeMs = scheduler.getNextUpdateMs();
+  }
+  HOST_CHECK(board.pinValues[3] == 255);
+  HOST_CHECK(board.timeMs - commandMs <= 2);
+
+  decoder.end();
+  return hostTestResult("DccDecoderTest");
+}
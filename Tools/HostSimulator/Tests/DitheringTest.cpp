@@ -0,0 +1,118 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "HostTest.h"
+#include "Arduino.h"
+#include "HostBoard.h"
+#include <LEDLightingCycle.h>
+
+/*
+  Measures the time averaged output error of dithered and plain outputs.
+*/
+
+/**
+  @brief cyclic effect with a fixed brightness including 8 fractional bits
+*/
+class FixedLevelEffect : public LEDCyclicEffect {
+  public:
+    ///brightness in 1/256 PWM steps
+    unsigned short level;
+
+    unsigned char getBrightness(unsigned char const) {
+      return level >> 8;
+    }
+
+    unsigned short getBrightness16(unsigned char const) {
+      return level;
+    }
+};
+
+int main() {
+  HostBoard board;
+  initBoard(board, 1);
+  setCurrentBoard(&board);
+
+  //constant fractional levels averaged over 256 executions
+  double worstDitheredError = 0;
+  double worstPlainError = 0;
+  FixedLevelEffect levelEffect;
+  for (unsigned long level = 0; level <= 0xFF00; level += 37) {
+    levelEffect.level = level;
+    LEDStaticLighting dithered(3, 255, LEDStaticLighting::CYCLE_ON, &levelEffect);
+    LEDStaticLighting plain(5, 255, LEDStaticLighting::CYCLE_ON, &levelEffect);
+    dithered.setDithering(true);
+
+    unsigned long ditheredSum = 0;
+    unsigned long plainSum = 0;
+    for (unsigned short frame = 0; frame < 256; frame++) {
+      dithered.execute();
+      plain.execute();
+      ditheredSum += board.pinValues[3];
+      plainSum += board.pinValues[5];
+    }
+
+    const double ditheredError = fabs(ditheredSum / 256.0 - level / 256.0);
+    const double plainError = fabs(plainSum / 256.0 - level / 256.0);
+    worstDitheredError = (ditheredError > worstDitheredError) ? ditheredError : worstDitheredError;
+    worstPlainError = (plainError > worstPlainError) ? plainError : worstPlainError;
+  }
+  printf("constant level, worst error of the average over 256 frames: dithered %.4f, plain %.4f PWM steps\n",
+         worstDitheredError, worstPlainError);
+  HOST_CHECK(worstDitheredError < 1 / 256.0);
+  HOST_CHECK(worstPlainError > 0.9);
+
+  //slow fade from 0 to 40 over 60s executed every ms, error of 16 frame averages
+  FadeEffect fade(60000, FadeEffect::FADE_IN);
+  fade.reset();
+  LEDStaticLighting dithered(3, 40, LEDStaticLighting::CYCLE_ON, &levelEffect);
+  LEDStaticLighting plain(5, 40, LEDStaticLighting::CYCLE_ON, &levelEffect);
+  dithered.setDithering(true);
+
+  double ditheredSquareSum = 0;
+  double plainSquareSum = 0;
+  double ditheredWindow = 0;
+  double plainWindow = 0;
+  double targetWindow = 0;
+  unsigned long windowCount = 0;
+  for (unsigned long timeMs = 0; timeMs < 60000; timeMs++) {
+    board.timeMs = timeMs;
+    levelEffect.level = fade.getBrightness16(40);
+    dithered.execute();
+    plain.execute();
+
+    ditheredWindow += board.pinValues[3];
+    plainWindow += board.pinValues[5];
+    targetWindow += levelEffect.level / 256.0;
+    if ((timeMs & 15) == 15) {
+      ditheredSquareSum += (ditheredWindow - targetWindow) * (ditheredWindow - targetWindow) / 256;
+      plainSquareSum += (plainWindow - targetWindow) * (plainWindow - targetWindow) / 256;
+      ditheredWindow = 0;
+      plainWindow = 0;
+      targetWindow = 0;
+      windowCount++;
+    }
+  }
+  const double ditheredRms = sqrt(ditheredSquareSum / windowCount);
+  const double plainRms = sqrt(plainSquareSum / windowCount);
+  printf("fade 0 to 40 over 60s, rms error of 16 frame averages: dithered %.4f, plain %.4f PWM steps\n", ditheredRms, plainRms);
+  HOST_CHECK(ditheredRms < 0.1);
+  HOST_CHECK(ditheredRms * 10 < plainRms);
+
+  //the fraction keeps the light executing on every pass
+  HOST_CHECK(dithered.getUpdateIntervalMs() == 0);
+
+  return hostTestResult("DitheringTest");
+}
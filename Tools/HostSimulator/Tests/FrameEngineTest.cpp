@@ -0,0 +1,93 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "HostTest.h"
+#include "Arduino.h"
+#include "HostBoard.h"
+#include <LEDFrameEngine.h>
+
+/*
+  Drives LEDFrameEngine with simulated timer interrupts and checks that the interrupt only marks frames as due,
+  that frames are executed by execute() and that late frames are counted as missed.
+*/
+
+#define FRAME_INTERVAL_TICKS 5
+
+/**
+  @brief cyclic effect counting its executions
+*/
+class CountingEffect : public LEDCyclicEffect {
+  public:
+    ///number of calls of getBrightness()
+    unsigned int executionCount = 0;
+
+    unsigned char getBrightness(unsigned char const maxBrightness) {
+      executionCount++;
+      return maxBrightness;
+    }
+};
+
+static void raiseTicks(unsigned char const tickCount) {
+  for (unsigned char tick = 0; tick < tickCount; tick++) {
+    LEDFrameEngine::handleTimerInterrupt();
+  }
+}
+
+int main() {
+  HostBoard board;
+  initBoard(board, 1);
+  setCurrentBoard(&board);
+
+  CountingEffect effects[2];
+  LEDStaticLighting * lights[2];
+  lights[0] = new LEDStaticLighting(3, 200, LEDStaticLighting::CYCLE_ON, &effects[0]);
+  lights[1] = new LEDStaticLighting(5, 100, LEDStaticLighting::CYCLE_ON, &effects[1]);
+  LEDFrameEngine engine(lights, 2, FRAME_INTERVAL_TICKS);
+  engine.begin();
+
+  //no frame is due before the interval has elapsed
+  raiseTicks(FRAME_INTERVAL_TICKS - 1);
+  HOST_CHECK(not engine.execute());
+  HOST_CHECK(effects[0].executionCount == 0);
+
+  //the interrupt does not touch the lights or the pins, the frame runs in execute()
+  raiseTicks(1);
+  HOST_CHECK(effects[0].executionCount == 0);
+  HOST_CHECK(board.pinValues[3] == 0);
+  HOST_CHECK(engine.execute());
+  HOST_CHECK((effects[0].executionCount == 1) && (effects[1].executionCount == 1));
+  HOST_CHECK((board.pinValues[3] == 200) && (board.pinValues[5] == 100));
+  HOST_CHECK(not engine.execute());
+  HOST_CHECK(engine.getMissedFrames() == 0);
+
+  //three frames become due while loop() is busy, the two late ones are missed and one frame is executed
+  raiseTicks(3 * FRAME_INTERVAL_TICKS);
+  HOST_CHECK(effects[0].executionCount == 1);
+  HOST_CHECK(engine.getMissedFrames() == 2);
+  HOST_CHECK(engine.execute());
+  HOST_CHECK(not engine.execute());
+  HOST_CHECK(effects[0].executionCount == 2);
+
+  //after end() the ticks are ignored and the lights write their pins again
+  engine.end();
+  raiseTicks(FRAME_INTERVAL_TICKS);
+  HOST_CHECK(not engine.execute());
+  lights[0]->setBrightness(50);
+  lights[0]->execute();
+  HOST_CHECK(board.pinValues[3] == 50);
+
+  return hostTestResult("FrameEngineTest");
+}
@@ -0,0 +1,118 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "HostTest.h"
+#include "Arduino.h"
+#include "HostBoard.h"
+#include <LEDGroup.h>
+
+/*
+  Checks that the members of an LEDGroup take the output path of the leader: deferred outputs are only written by
+  updateOutput() and dithered outputs pass the dithered brightness on to the members.
+*/
+
+#define LEADER_PIN 3
+#define EARLY_MEMBER_PIN 5
+#define LATE_MEMBER_PIN 6
+#define LATE_MEMBER_OFFSET_MS 100
+#define FRAME_MS 5
+#define FRAME_COUNT 256
+
+/**
+  @brief cyclic effect with a fixed brightness including 8 fractional bits
+*/
+class FixedLevelEffect : public LEDCyclicEffect {
+  public:
+    ///brightness in 1/256 PWM steps
+    unsigned short level;
+
+    unsigned char getBrightness(unsigned char const) {
+      return level >> 8;
+    }
+
+    unsigned short getBrightness16(unsigned char const) {
+      return level;
+    }
+};
+
+int main() {
+  HostBoard board;
+  initBoard(board, 1);
+  setCurrentBoard(&board);
+
+  //16.5 PWM steps, the dithered leader alternates between 16 and 17
+  FixedLevelEffect levelEffect;
+  levelEffect.level = 0x1080;
+
+  LEDGroup group(LEADER_PIN, 255, 2, 600000, 600000, 600000, 600000, &levelEffect);
+  group.addMember(EARLY_MEMBER_PIN, 0);
+  group.addMember(LATE_MEMBER_PIN, LATE_MEMBER_OFFSET_MS);
+  group.setDithering(true);
+  group.setOutputDeferred(true);
+  group.setState(LEDStaticLighting::CYCLE_ON);
+
+  bool isDeferred = true;
+  bool isFollowing = true;
+  bool isLateMemberWaiting = true;
+  unsigned long leaderSum = 0;
+  unsigned long earlySum = 0;
+  unsigned long lateSum = 0;
+  unsigned short lateFrameCount = 0;
+  for (unsigned short frame = 0; frame < FRAME_COUNT; frame++) {
+    const unsigned char leaderValue = board.pinValues[LEADER_PIN];
+    const unsigned char earlyValue = board.pinValues[EARLY_MEMBER_PIN];
+    const unsigned char lateValue = board.pinValues[LATE_MEMBER_PIN];
+
+    //execute only renders the frame, no pin changes until the output is updated
+    group.execute();
+    isDeferred = isDeferred && (board.pinValues[LEADER_PIN] == leaderValue) &&
+                 (board.pinValues[EARLY_MEMBER_PIN] == earlyValue) && (board.pinValues[LATE_MEMBER_PIN] == lateValue);
+
+    group.updateOutput();
+    isFollowing = isFollowing && (board.pinValues[EARLY_MEMBER_PIN] == board.pinValues[LEADER_PIN]);
+    if (board.timeMs < LATE_MEMBER_OFFSET_MS) {
+      isLateMemberWaiting = isLateMemberWaiting && (board.pinValues[LATE_MEMBER_PIN] == 0);
+    }
+    else {
+      isFollowing = isFollowing && (board.pinValues[LATE_MEMBER_PIN] == board.pinValues[LEADER_PIN]);
+      lateSum += board.pinValues[LATE_MEMBER_PIN];
+      lateFrameCount++;
+    }
+    leaderSum += board.pinValues[LEADER_PIN];
+    earlySum += board.pinValues[EARLY_MEMBER_PIN];
+
+    board.timeMs += FRAME_MS;
+  }
+
+  printf("dithered group over %u frames: leader %.3f, early member %.3f, late member %.3f PWM steps\n",
+         FRAME_COUNT, leaderSum / (double)FRAME_COUNT, earlySum / (double)FRAME_COUNT, lateSum / (double)lateFrameCount);
+  HOST_CHECK(isDeferred);
+  HOST_CHECK(isFollowing);
+  HOST_CHECK(isLateMemberWaiting);
+  HOST_CHECK(earlySum == leaderSum);
+  HOST_CHECK((earlySum * 2 > 33 * FRAME_COUNT - 2) && (earlySum * 2 < 33 * FRAME_COUNT + 2));
+
+  //without deferral the members are written by execute() right away
+  group.setOutputDeferred(false);
+  for (unsigned short frame = 0; frame < 4; frame++) {
+    group.execute();
+    HOST_CHECK(board.pinValues[EARLY_MEMBER_PIN] == board.pinValues[LEADER_PIN]);
+    HOST_CHECK(board.pinValues[LATE_MEMBER_PIN] == board.pinValues[LEADER_PIN]);
+    board.timeMs += FRAME_MS;
+  }
+
+  return hostTestResult("GroupTest");
+}
@@ -0,0 +1,50 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef HOSTTEST_H
+#define HOSTTEST_H
+
+#include <stdio.h>
+
+/*
+  Minimal checks for the host tests. Every test is a program of its own that returns 0 if all checks passed,
+  `make test` builds and runs all of them.
+*/
+
+///number of failed checks of the test program
+static int hostTestFailures = 0;
+
+///counts and prints a failed check without stopping the test
+#define HOST_CHECK(condition) \
+  do { \
+    if (not (condition)) { \
+      printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+      hostTestFailures++; \
+    } \
+  } while (0)
+
+/**
+  @brief prints the result of the test program
+
+  @param name name of the test
+  @return exit code of the test program
+*/
+static inline int hostTestResult(const char * const name) {
+  printf("%s: %s\n", name, hostTestFailures ? "FAILED" : "passed");
+  return hostTestFailures ? 1 : 0;
+}
+
+#endif
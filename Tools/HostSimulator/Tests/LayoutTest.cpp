@@ -0,0 +1,135 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+//pin map of an Arduino Uno, so the pin check of the layout is active on the host
+#define NUM_DIGITAL_PINS 20
+#define digitalPinHasPWM(p) (((p) == 3) || ((p) == 5) || ((p) == 6) || ((p) == 9) || ((p) == 10) || ((p) == 11))
+
+#include "HostTest.h"
+#include "Arduino.h"
+#include "HostBoard.h"
+#include <LEDLayout.h>
+#include <cstdlib>
+#include <new>
+
+/*
+  Compiles layout tables with LED_LAYOUT_CHECK, checks that the compile time checks reject broken tables and that
+  LEDLayout::create() places all objects into the static storage without heap allocations.
+*/
+
+constexpr LEDLightDefinition yardOffice[] PROGMEM = {
+  LEDLayout::staticLight(3, 255),
+  LEDLayout::staticLight(13, 255),
+  LEDLayout::randomCycle(9, 255, 5 * 60 * 1000ul, 10 * 60 * 1000ul, 5 * 60 * 1000ul, 10 * 60 * 1000ul,
+                         LEDLayout::fluorescentStart(500, 4000), LEDLayout::fade(50)),
+  LEDLayout::chainedCycle(10, 255, 2, 30 * 1000ul, 2 * 60 * 1000ul, 2 * 60 * 1000ul, 10 * 60 * 1000ul,
+                          LEDLayout::fluorescentStart(500, 2000), LEDLayout::fade(50))
+};
+LED_LAYOUT_CHECK(yardOffice);
+
+//broken tables, each one fails exactly one check
+constexpr LEDLightDefinition dimmedDigitalPin[] = {LEDLayout::staticLight(13, 128)};
+constexpr LEDLightDefinition missingPin[] = {LEDLayout::staticLight(20, 255)};
+constexpr LEDLightDefinition reversedRange[] = {LEDLayout::randomCycle(9, 255, 2000, 1000, 1000, 2000)};
+constexpr LEDLightDefinition reversedTransition[] = {LEDLayout::randomCycle(9, 255, 1000, 2000, 1000, 2000, LEDLayout::fluorescentStart(900, 500))};
+constexpr LEDLightDefinition masterAfterChain[] = {
+  LEDLayout::chainedCycle(10, 255, 1, 1000, 2000, 1000, 2000),
+  LEDLayout::randomCycle(9, 255, 1000, 2000, 1000, 2000)
+};
+static_assert(not LEDLayout::hasValidPins(dimmedDigitalPin), "dimmed light on a pin without PWM");
+static_assert(not LEDLayout::hasValidPins(missingPin), "pin that does not exist");
+static_assert(not LEDLayout::hasValidRanges(reversedRange), "min > max");
+static_assert(not LEDLayout::hasValidRanges(reversedTransition), "min > max of a transition");
+static_assert(not LEDLayout::hasValidChains(masterAfterChain), "chained cycle before its master");
+static_assert(LEDLayout::hasValidPins(masterAfterChain) && LEDLayout::hasValidRanges(masterAfterChain), "only the chain is broken");
+
+///number of heap allocations since the start of the test
+static unsigned int allocationCount = 0;
+
+void * operator new(std::size_t size) {
+  allocationCount++;
+  void * const memory = malloc(size ? size : 1);
+  if (not memory) {
+    throw std::bad_alloc();
+  }
+  return memory;
+}
+
+void operator delete(void * memory) noexcept {
+  free(memory);
+}
+
+void operator delete(void * memory, std::size_t) noexcept {
+  free(memory);
+}
+
+static LEDStaticLighting * ledSetups[LED_LAYOUT_SIZE(yardOffice)];
+static LED_LAYOUT_STORAGE(yardOffice) yardOfficeStorage;
+
+static bool isInStorage(const void * const object) {
+  const unsigned char * const bytes = (const unsigned char *)object;
+  return (bytes >= yardOfficeStorage.bytes) && (bytes < yardOfficeStorage.bytes + sizeof(yardOfficeStorage.bytes));
+}
+
+int main() {
+  HostBoard board;
+  initBoard(board, 1);
+  setCurrentBoard(&board);
+
+  //two static lights and two cycles with two transitions each
+  HOST_CHECK(sizeof(yardOfficeStorage.bytes) == 2 * LEDLayout::getObjectSize(sizeof(LEDStaticLighting))
+             + LEDLayout::getObjectSize(sizeof(LEDRandomLightingCycle)) + LEDLayout::getObjectSize(sizeof(LEDChainedCycle))
+             + 2 * (LEDLayout::getObjectSize(sizeof(FluorescentStartEffect)) + LEDLayout::getObjectSize(sizeof(FadeEffect))));
+
+  const unsigned int allocationsBefore = allocationCount;
+  LEDLayout::create(yardOffice, ledSetups, yardOfficeStorage);
+  HOST_CHECK(allocationCount == allocationsBefore);
+
+  for (unsigned char lightIndex = 0; lightIndex < LED_LAYOUT_SIZE(yardOffice); lightIndex++) {
+    HOST_CHECK(isInStorage(ledSetups[lightIndex]));
+    HOST_CHECK(board.pinModes[pgm_read_byte(&yardOffice[lightIndex].pin)] == OUTPUT);
+  }
+  HOST_CHECK(dynamic_cast<LEDRandomLightingCycle *>(ledSetups[2]) != 0);
+  HOST_CHECK(dynamic_cast<LEDChainedCycle *>(ledSetups[3]) != 0);
+
+  //the lights run from the storage, the chained cycle only switches on while its master is on
+  bool isChainCorrect = true;
+  unsigned int masterSwitchCount = 0;
+  unsigned int chainSwitchOnCount = 0;
+  bool wasMasterActive = ledSetups[2]->isOutputActive();
+  bool wasChainActive = ledSetups[3]->isOutputActive();
+  for (board.timeMs = 0; board.timeMs < 2 * 60 * 60 * 1000ul; board.timeMs += 10) {
+    for (unsigned char lightIndex = 0; lightIndex < LED_LAYOUT_SIZE(yardOffice); lightIndex++) {
+      ledSetups[lightIndex]->execute();
+    }
+    const bool isMasterActive = ledSetups[2]->isOutputActive();
+    masterSwitchCount += (isMasterActive != wasMasterActive) ? 1 : 0;
+    wasMasterActive = isMasterActive;
+    const bool isChainActive = ledSetups[3]->isOutputActive();
+    if (isChainActive and not wasChainActive) {
+      chainSwitchOnCount++;
+      isChainCorrect = isChainCorrect && isMasterActive;
+    }
+    wasChainActive = isChainActive;
+  }
+  HOST_CHECK(board.pinValues[3] == 255);
+  HOST_CHECK(board.pinValues[13] == 255);
+  HOST_CHECK(masterSwitchCount >= 6);
+  HOST_CHECK(chainSwitchOnCount > 0);
+  HOST_CHECK(isChainCorrect);
+
+  return hostTestResult("LayoutTest");
+}
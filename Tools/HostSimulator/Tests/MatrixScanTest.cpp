@@ -0,0 +1,237 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "HostTest.h"
+#include "Arduino.h"
+#include "HostBoard.h"
+#include <LEDMatrixScan.h>
+
+/*
+  Emulates timer 2 for LEDMatrixScan and follows every pin write, checks that each step lights exactly the LEDs
+  of the current row and plane, that no unlit LED glows while the rows change and that every LED is on for
+  its level times the shortest plane.
+*/
+
+//cost model of the interrupt in CPU cycles, entry with saving the registers and one pin register access
+#define ENTRY_CYCLES 48
+#define PIN_CYCLES 12
+//CPU cycles per timer tick and timer ticks of the shortest plane
+#define TICK_CYCLES 64
+#define MIN_SLOT_TICKS 4
+//frames measured after the first frame
+#define FRAME_COUNT 3
+#define MAX_LIGHTS 64
+
+static const unsigned char * anodePins[MAX_LIGHTS];
+static const unsigned char * cathodePins[MAX_LIGHTS];
+static unsigned char lightRows[MAX_LIGHTS];
+static unsigned char lightLevels[MAX_LIGHTS];
+static unsigned char lightCount = 0;
+
+static bool isLit[MAX_LIGHTS];
+static unsigned long litSinceCycles[MAX_LIGHTS];
+static unsigned long litCycles[MAX_LIGHTS];
+static unsigned long windowStartCycles = 0;
+static unsigned long windowEndCycles = 0;
+static unsigned long cycleTime = 0;
+static unsigned short pinCallCount = 0;
+static unsigned long ghostCount = 0;
+
+static bool isLightOn(unsigned char const lightIndex) {
+  const HostBoard * const board = getCurrentBoard();
+  const unsigned char anode = *anodePins[lightIndex];
+  const unsigned char cathode = *cathodePins[lightIndex];
+  return (board->pinModes[anode] == OUTPUT) && board->pinValues[anode]
+         && (board->pinModes[cathode] == OUTPUT) && not board->pinValues[cathode];
+}
+
+static void addLitTime(unsigned char const lightIndex, unsigned long const endCycles) {
+  const unsigned long fromCycles = (litSinceCycles[lightIndex] > windowStartCycles) ? litSinceCycles[lightIndex] : windowStartCycles;
+  const unsigned long toCycles = (endCycles < windowEndCycles) ? endCycles : windowEndCycles;
+  if (toCycles > fromCycles) {
+    litCycles[lightIndex] += toCycles - fromCycles;
+  }
+}
+
+static void onPinWrite(uint8_t) {
+  cycleTime += PIN_CYCLES;
+  pinCallCount++;
+  for (unsigned char lightIndex = 0; lightIndex < lightCount; lightIndex++) {
+    const bool isOn = isLightOn(lightIndex);
+    if (isOn == isLit[lightIndex]) {
+      continue;
+    }
+    isLit[lightIndex] = isOn;
+    if (isOn) {
+      litSinceCycles[lightIndex] = cycleTime;
+      if (not lightLevels[lightIndex]) {
+        ghostCount++;
+      }
+    }
+    else {
+      addLitTime(lightIndex, cycleTime);
+    }
+  }
+}
+
+//neighbouring rows and columns alternate between dark and lit LEDs, so mixing two rows lights a dark LED
+static LEDStaticLighting ** createLights(unsigned char const rowCount, unsigned char const columnCount) {
+  lightCount = rowCount * columnCount;
+  LEDStaticLighting ** const lights = new LEDStaticLighting *[lightCount];
+  for (unsigned char lightIndex = 0; lightIndex < lightCount; lightIndex++) {
+    const unsigned char row = lightIndex / columnCount;
+    const unsigned char level = ((row + lightIndex % columnCount) & 1) ? 0 : ((lightIndex * 23 + 5) % 63) + 1;
+    lightRows[lightIndex] = row;
+    lightLevels[lightIndex] = level;
+    lights[lightIndex] = new LEDStaticLighting(LED_NO_PIN, (level * 255 + 31) / 63);
+    lights[lightIndex]->execute();
+    isLit[lightIndex] = false;
+    litCycles[lightIndex] = 0;
+  }
+  return lights;
+}
+
+static void scanFrames(LEDMatrixScan & matrix, unsigned char const rowCount, unsigned char const columnCount, const char * const name) {
+  HostBoard * const board = getCurrentBoard();
+  matrix.execute();
+  board->pinHandler = onPinWrite;
+  matrix.begin();
+
+  const unsigned short stepsPerFrame = rowCount * LED_MATRIX_PLANE_COUNT;
+  const unsigned short lastStep = (1 + FRAME_COUNT) * stepsPerFrame;
+  unsigned long matchCycles = 0;
+  windowStartCycles = windowEndCycles = (unsigned long)-1;
+  for (unsigned short step = 0; step <= lastStep; step++) {
+    if (step == stepsPerFrame) {
+      windowStartCycles = matchCycles;
+    }
+    if (step == lastStep) {
+      windowEndCycles = matchCycles;
+    }
+
+    cycleTime = matchCycles + ENTRY_CYCLES;
+    pinCallCount = 0;
+    const unsigned char slotTicks = matrix.scanStep();
+    const unsigned char compareTicks = matrix.getCompareTicks(slotTicks, (cycleTime - matchCycles) / TICK_CYCLES);
+    matchCycles += (compareTicks + 1) * TICK_CYCLES;
+
+    //every column once, twice and the row pins when the row changes
+    const unsigned char plane = step % LED_MATRIX_PLANE_COUNT;
+    HOST_CHECK(pinCallCount <= (plane ? columnCount : 2 * columnCount + 4));
+    HOST_CHECK(slotTicks == (MIN_SLOT_TICKS << plane));
+
+    const unsigned char row = (step / LED_MATRIX_PLANE_COUNT) % rowCount;
+    for (unsigned char lightIndex = 0; lightIndex < lightCount; lightIndex++) {
+      HOST_CHECK(isLightOn(lightIndex) == ((lightRows[lightIndex] == row) && (lightLevels[lightIndex] & (1 << plane))));
+    }
+  }
+  for (unsigned char lightIndex = 0; lightIndex < lightCount; lightIndex++) {
+    if (isLit[lightIndex]) {
+      addLitTime(lightIndex, cycleTime);
+    }
+  }
+
+  //the compensation of the row change is rounded to whole timer ticks
+  unsigned long maxErrorCycles = 0;
+  for (unsigned char lightIndex = 0; lightIndex < lightCount; lightIndex++) {
+    const unsigned long expectedCycles = (unsigned long)FRAME_COUNT * lightLevels[lightIndex] * MIN_SLOT_TICKS * TICK_CYCLES;
+    const unsigned long errorCycles = (litCycles[lightIndex] > expectedCycles) ? (litCycles[lightIndex] - expectedCycles) : (expectedCycles - litCycles[lightIndex]);
+    if (errorCycles > maxErrorCycles) {
+      maxErrorCycles = errorCycles;
+    }
+  }
+  HOST_CHECK(ghostCount == 0);
+  HOST_CHECK(maxErrorCycles <= FRAME_COUNT * TICK_CYCLES);
+  HOST_CHECK(matrix.getMaxScanTicks() < MIN_SLOT_TICKS);
+  printf("%s: max on time error %.2fus per frame, shortest plane 16us, max scan ticks %u\n", name,
+         maxErrorCycles / 16.0 / FRAME_COUNT, matrix.getMaxScanTicks());
+
+  matrix.end();
+  board->pinHandler = 0;
+  for (unsigned char lightIndex = 0; lightIndex < lightCount; lightIndex++) {
+    HOST_CHECK(not isLightOn(lightIndex));
+  }
+}
+
+int main() {
+  HostBoard board;
+
+  //row/column matrix, anodes on the rows, cathodes on the columns
+  initBoard(board, 1);
+  setCurrentBoard(&board);
+  static const unsigned char rowPins[] = {2, 3, 4, 5};
+  static const unsigned char columnPins[] = {6, 7, 8, 9, 10, 11};
+  LEDStaticLighting ** lights = createLights(4, 6);
+  for (unsigned char lightIndex = 0; lightIndex < lightCount; lightIndex++) {
+    anodePins[lightIndex] = &rowPins[lightIndex / 6];
+    cathodePins[lightIndex] = &columnPins[lightIndex % 6];
+  }
+  LEDMatrixScan matrix(rowPins, 4, columnPins, 6, lights, lightCount);
+  for (unsigned char index = 0; index < 4; index++) {
+    HOST_CHECK((board.pinModes[rowPins[index]] == OUTPUT) && (board.pinValues[rowPins[index]] == 0));
+  }
+  for (unsigned char index = 0; index < 6; index++) {
+    HOST_CHECK((board.pinModes[columnPins[index]] == OUTPUT) && (board.pinValues[columnPins[index]] == 255));
+  }
+  scanFrames(matrix, 4, 6, "row/column matrix");
+
+  //charlieplexed matrix, the anode of light n is pin n / 4, the cathode the (n % 4)th of the other pins
+  initBoard(board, 1);
+  static const unsigned char charlieplexPins[] = {2, 4, 7, 8, 12};
+  lights = createLights(5, 4);
+  for (unsigned char lightIndex = 0; lightIndex < lightCount; lightIndex++) {
+    const unsigned char anodeIndex = lightIndex / 4;
+    const unsigned char cathodeIndex = lightIndex % 4;
+    anodePins[lightIndex] = &charlieplexPins[anodeIndex];
+    cathodePins[lightIndex] = &charlieplexPins[(cathodeIndex >= anodeIndex) ? cathodeIndex + 1 : cathodeIndex];
+  }
+  LEDMatrixScan charlieplex(charlieplexPins, 5, lights, lightCount);
+  for (unsigned char index = 0; index < 5; index++) {
+    HOST_CHECK((board.pinModes[charlieplexPins[index]] == INPUT) && (board.pinValues[charlieplexPins[index]] == 0));
+  }
+  scanFrames(charlieplex, 5, 4, "charlieplexed matrix");
+
+  //more columns than a plane mask holds or more rows than refresh without flicker leave all pins untouched
+  initBoard(board, 1);
+  static const unsigned char widePins[] = {20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37};
+  LEDMatrixScan wide(rowPins, 4, widePins, 17, lights, lightCount);
+  LEDMatrixScan wideCharlieplex(widePins, 18, lights, lightCount);
+  LEDMatrixScan singlePin(widePins, 1, lights, lightCount);
+  LEDMatrixScan tall(widePins, LED_MATRIX_MAX_ROWS + 1, columnPins, 6, lights, lightCount);
+  LEDMatrixScan tallCharlieplex(widePins, LED_MATRIX_MAX_ROWS + 1, lights, lightCount);
+  LEDMatrixScan * const rejected[] = {&wide, &wideCharlieplex, &singlePin, &tall, &tallCharlieplex};
+  for (unsigned char index = 0; index < 5; index++) {
+    HOST_CHECK(not rejected[index]->begin());
+    rejected[index]->execute();
+    rejected[index]->scanStep();
+    rejected[index]->end();
+  }
+  HOST_CHECK(board.pinChangeCount == 0);
+  for (unsigned char pin = 0; pin < 40; pin++) {
+    HOST_CHECK(board.pinModes[pin] == INPUT);
+  }
+
+  //analogWrite() on a pin of timer 2 would stop the scan, so lights on these pins keep the matrix from starting
+  HOST_CHECK(LEDMatrixScan::isScanTimerPin(3) && LEDMatrixScan::isScanTimerPin(11));
+  HOST_CHECK(not LEDMatrixScan::isScanTimerPin(5) && not LEDMatrixScan::isScanTimerPin(LED_NO_PIN));
+  LEDMatrixScan largest(widePins, LED_MATRIX_MAX_ROWS, lights, lightCount);
+  LEDStaticLighting * const pinLights[] = {new LEDStaticLighting(5, 255), new LEDStaticLighting(LED_NO_PIN, 255), new LEDStaticLighting(11, 128)};
+  HOST_CHECK(not largest.begin(pinLights, 3));
+  HOST_CHECK(largest.begin(pinLights, 2));
+  largest.end();
+
+  return hostTestResult("MatrixScanTest");
+}
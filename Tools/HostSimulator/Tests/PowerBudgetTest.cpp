@@ -0,0 +1,125 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "HostTest.h"
+#include "Arduino.h"
+#include "HostBoard.h"
+#include <LEDLightingCycle.h>
+#include <LEDPowerBudget.h>
+
+/*
+  Runs four lights of 100mA against a budget of 200mA and checks the scaling, the ramps and the load accounting.
+*/
+
+#define LIGHT_COUNT 4
+#define LIGHT_CURRENT_MA 100
+#define LIMIT_MA 200
+#define RAMP_TIME_MS 100
+
+static LEDStaticLighting * lights[LIGHT_COUNT];
+
+//runs one ms of the budget and the lights, returns the largest change of a pin
+static unsigned char runMs(LEDPowerBudget & budget) {
+  const HostBoard * const board = getCurrentBoard();
+  getCurrentBoard()->timeMs++;
+  budget.execute();
+
+  unsigned char largestStep = 0;
+  for (unsigned char lightIndex = 0; lightIndex < LIGHT_COUNT; lightIndex++) {
+    const unsigned char pin = lights[lightIndex]->getPin();
+    const unsigned char oldValue = board->pinValues[pin];
+    lights[lightIndex]->execute();
+    const unsigned char newValue = board->pinValues[pin];
+    const unsigned char step = (newValue > oldValue) ? (newValue - oldValue) : (oldValue - newValue);
+    largestStep = (step > largestStep) ? step : largestStep;
+  }
+  return largestStep;
+}
+
+//current drawn by the pins of all lights in mA
+static unsigned long getPinCurrentMa() {
+  unsigned long load = 0;
+  for (unsigned char lightIndex = 0; lightIndex < LIGHT_COUNT; lightIndex++) {
+    load += (unsigned long)getCurrentBoard()->pinValues[lights[lightIndex]->getPin()] * LIGHT_CURRENT_MA;
+  }
+  return load / 255;
+}
+
+int main() {
+  HostBoard board;
+  initBoard(board, 1);
+  setCurrentBoard(&board);
+
+  LEDPowerBudget budget(LIMIT_MA, RAMP_TIME_MS);
+  for (unsigned char lightIndex = 0; lightIndex < LIGHT_COUNT; lightIndex++) {
+    lights[lightIndex] = new LEDStaticLighting(3 + lightIndex, 255);
+    lights[lightIndex]->setPowerBudget(&budget, LIGHT_CURRENT_MA);
+    HOST_CHECK(budget.getRequestedCurrentMa() == 0);
+  }
+
+  //the first execution requests 400mA, the outputs start at full brightness and ramp down
+  for (unsigned char lightIndex = 0; lightIndex < LIGHT_COUNT; lightIndex++) {
+    lights[lightIndex]->execute();
+  }
+  HOST_CHECK(budget.getRequestedCurrentMa() == LIGHT_COUNT * LIGHT_CURRENT_MA);
+  HOST_CHECK(board.pinValues[3] == 255);
+
+  unsigned char largestStep = 0;
+  unsigned short rampMs = 0;
+  while ((getPinCurrentMa() > LIMIT_MA) && (rampMs < 10 * RAMP_TIME_MS)) {
+    const unsigned char step = runMs(budget);
+    largestStep = (step > largestStep) ? step : largestStep;
+    rampMs++;
+  }
+  printf("ramp down to %lumA in %ums, largest step %u\n", getPinCurrentMa(), rampMs, largestStep);
+  HOST_CHECK(getPinCurrentMa() <= LIMIT_MA);
+  HOST_CHECK(rampMs <= RAMP_TIME_MS);
+  HOST_CHECK(rampMs >= RAMP_TIME_MS / 4);
+  HOST_CHECK(largestStep <= 2);
+
+  //the scale settles at half brightness and stays there
+  for (unsigned short ms = 0; ms < RAMP_TIME_MS; ms++) {
+    runMs(budget);
+  }
+  for (unsigned char lightIndex = 0; lightIndex < LIGHT_COUNT; lightIndex++) {
+    HOST_CHECK(board.pinValues[3 + lightIndex] == 127);
+    HOST_CHECK(lights[lightIndex]->getOutputBrightness() == 255);
+  }
+
+  //lightOff() goes through setOutput(0), so switching two lights off removes their load
+  lights[2]->setState(LEDStaticLighting::CYCLE_OFF);
+  lights[3]->setState(LEDStaticLighting::CYCLE_OFF);
+  largestStep = 0;
+  rampMs = 0;
+  runMs(budget);
+  HOST_CHECK(budget.getRequestedCurrentMa() == LIMIT_MA);
+  HOST_CHECK((board.pinValues[5] == 0) && (board.pinValues[6] == 0));
+  while ((board.pinValues[3] < 255) && (rampMs < 10 * RAMP_TIME_MS)) {
+    const unsigned char step = runMs(budget);
+    largestStep = (step > largestStep) ? step : largestStep;
+    rampMs++;
+  }
+  printf("ramp up to %lumA in %ums, largest step %u\n", getPinCurrentMa(), rampMs, largestStep);
+  HOST_CHECK((board.pinValues[3] == 255) && (board.pinValues[4] == 255));
+  HOST_CHECK(rampMs <= RAMP_TIME_MS);
+  HOST_CHECK(largestStep <= 2);
+
+  //a light removed from the budget takes its load along
+  lights[0]->setPowerBudget(0, 0);
+  HOST_CHECK(budget.getRequestedCurrentMa() == LIGHT_CURRENT_MA);
+
+  return hostTestResult("PowerBudgetTest");
+}
@@ -0,0 +1,108 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "HostTest.h"
+#include "HostBoard.h"
+#include <LEDLightingScheduler.h>
+
+/*
+  Runs a scheduler with sleepUntilNextUpdate() against the simulated clock and checks the sleep windows.
+*/
+
+#define LIGHT_COUNT 2
+
+//declared like in a sketch using power down, empty on the host
+LED_SCHEDULER_WATCHDOG_ISR
+
+static unsigned char trigger = 0;
+
+static void raiseTrigger() {
+  trigger = 1;
+  LEDLightingScheduler::wakeUp();
+}
+
+int main() {
+  HostBoard board;
+  initBoard(board, 1);
+  setCurrentBoard(&board);
+
+  LEDStaticLighting * lights[LIGHT_COUNT];
+  lights[0] = new LEDStaticLighting(3, 255);
+  lights[1] = new LEDRandomLightingCycle(5, 255, 5000, 5000, 5000, 5000);
+  LEDLightingScheduler scheduler(lights, LIGHT_COUNT);
+
+  //every window ends exactly at the next update and is never longer than the steady interval
+  unsigned long windowCount = 0;
+  unsigned long stateChangeCount = 0;
+  LEDStaticLighting::CycleStates lastState = lights[1]->getState();
+  while (board.timeMs < 60000) {
+    scheduler.execute();
+    if (lights[1]->getState() != lastState) {
+      lastState = lights[1]->getState();
+      stateChangeCount++;
+    }
+
+    const unsigned long startMs = board.timeMs;
+    const unsigned long nextUpdateMs = scheduler.getNextUpdateMs();
+    if (scheduler.sleepUntilNextUpdate()) {
+      windowCount++;
+      HOST_CHECK(board.timeMs == nextUpdateMs);
+      HOST_CHECK(board.timeMs - startMs <= LED_UPDATE_INTERVAL_STEADY_MS);
+    }
+    else {
+      HOST_CHECK(nextUpdateMs == startMs);
+    }
+  }
+  HOST_CHECK(scheduler.getSleepCount() == windowCount);
+  //at most one window per steady interval of each light and one per state change
+  HOST_CHECK(windowCount >= 60);
+  HOST_CHECK(windowCount <= LIGHT_COUNT * 60 + stateChangeCount);
+  //a switch every 5 seconds, each through a transition state
+  HOST_CHECK(stateChangeCount >= 22);
+
+  //a simulated interrupt ends the window early
+  scheduler.execute();
+  const unsigned long interruptMs = board.timeMs + 10;
+  board.interruptTimeMs = interruptMs;
+  board.interruptHandler = raiseTrigger;
+  HOST_CHECK(scheduler.sleepUntilNextUpdate());
+  HOST_CHECK(trigger == 1);
+  HOST_CHECK(board.timeMs == interruptMs);
+
+  //a wake up requested before the sleep skips the window
+  const unsigned long sleepCount = scheduler.getSleepCount();
+  scheduler.execute();
+  LEDLightingScheduler::wakeUp();
+  HOST_CHECK(not scheduler.sleepUntilNextUpdate());
+  HOST_CHECK(scheduler.getSleepCount() == sleepCount);
+  HOST_CHECK(board.timeMs == interruptMs);
+
+  //sleeping longer than the frame budget is no overrun, blocking loop() is
+  scheduler.setFrameBudget(5000);
+  const unsigned long budgetEndMs = board.timeMs + 10000;
+  while ((long)(board.timeMs - budgetEndMs) < 0) {
+    scheduler.execute();
+    scheduler.sleepUntilNextUpdate();
+  }
+  HOST_CHECK(scheduler.getOverrunCount() == 0);
+  HOST_CHECK(scheduler.getQualityLevel() == 0);
+  scheduler.execute();
+  board.timeMs += 20;
+  scheduler.execute();
+  HOST_CHECK(scheduler.getOverrunCount() == 1);
+
+  return hostTestResult("SchedulerSleepTest");
+}
@@ -0,0 +1,115 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "HostTest.h"
+#include "HostBoard.h"
+#include "BufferStream.h"
+#include <LEDSerialConsole.h>
+
+/*
+  Feeds command lines to an LEDSerialConsole and checks the answers and the changed lights.
+*/
+
+#define LIGHT_COUNT 3
+
+static const LEDTimingRanges flashRanges PROGMEM = {1000, 2000, 3000, 4000};
+
+/**
+  @brief sends \p line to the console and returns its answer
+*/
+static std::string sendLine(LEDSerialConsole & console, BufferStream & stream, const char * const line) {
+  stream.input += line;
+  console.execute();
+  return stream.takeOutput();
+}
+
+int main() {
+  HostBoard board;
+  initBoard(board, 1);
+  setCurrentBoard(&board);
+
+  LEDStaticLighting * lights[LIGHT_COUNT];
+  lights[0] = new LEDRandomLightingCycle(3, 255, 5000, 6000, 7000, 8000);
+  lights[1] = new LEDStaticLighting(5, 255);
+  lights[2] = new LEDRandomLightingCycle(6, 255, &flashRanges);
+  LEDCyclicEffect * effects[] = {new LEDCyclicEffect(), new CandleEffect()};
+  BufferStream stream;
+  LEDSerialConsole console(stream, lights, LIGHT_COUNT, effects, 2);
+
+  //the waits follow LEDTimingRanges, for a random cycle the wait before switching on is the off time
+  LEDTimingRanges ranges;
+  HOST_CHECK(sendLine(console, stream, "range 0 100 200 300 400\n") == "ok\r\n");
+  HOST_CHECK(lights[0]->getTimingRanges(ranges));
+  HOST_CHECK(ranges.switchOnMinMs == 100 && ranges.switchOnMaxMs == 200);
+  HOST_CHECK(ranges.switchOffMinMs == 300 && ranges.switchOffMaxMs == 400);
+  HOST_CHECK(sendLine(console, stream, "get 0\n").find("range 100 200 300 400\r\n") != std::string::npos);
+
+  //a random cycle with a fixed wait of 100ms before switching on stays off for 100ms
+  HOST_CHECK(sendLine(console, stream, "range 0 100 100 300 300\n") == "ok\r\n");
+  HOST_CHECK(sendLine(console, stream, "state 0 ontooff\n") == "ok\r\n");
+  lights[0]->execute();
+  HOST_CHECK(lights[0]->getState() == LEDStaticLighting::CYCLE_OFF);
+  board.timeMs += 100;
+  lights[0]->execute();
+  HOST_CHECK(lights[0]->getState() == LEDStaticLighting::CYCLE_OFF);
+  board.timeMs += 1;
+  lights[0]->execute();
+  HOST_CHECK(lights[0]->getState() == LEDStaticLighting::CYCLE_OFF_TO_ON);
+
+  //invalid ranges are rejected and keep the old ranges
+  HOST_CHECK(sendLine(console, stream, "range 0 200 100 300 400\n") == "error: expected WAITONMIN WAITONMAX WAITOFFMIN WAITOFFMAX\r\n");
+  HOST_CHECK(sendLine(console, stream, "range 0 100 200 300\n") == "error: expected WAITONMIN WAITONMAX WAITOFFMIN WAITOFFMAX\r\n");
+  HOST_CHECK(sendLine(console, stream, "range 0 1 2 x 4\n") == "error: expected WAITONMIN WAITONMAX WAITOFFMIN WAITOFFMAX\r\n");
+  HOST_CHECK(lights[0]->getTimingRanges(ranges));
+  HOST_CHECK(ranges.switchOnMinMs == 100 && ranges.switchOffMaxMs == 300);
+  HOST_CHECK(sendLine(console, stream, "range 1 1 2 3 4\n") == "error: ranges are read only\r\n");
+  HOST_CHECK(sendLine(console, stream, "range 2 1 2 3 4\n") == "error: ranges are read only\r\n");
+
+  //out of range arguments
+  HOST_CHECK(sendLine(console, stream, "range 3 1 2 3 4\n") == "error: unknown light\r\n");
+  HOST_CHECK(sendLine(console, stream, "get 3\n") == "error: unknown light\r\n");
+  HOST_CHECK(sendLine(console, stream, "bright 1 256\n") == "error: brightness must be 0 to 255\r\n");
+  HOST_CHECK(sendLine(console, stream, "bright 1 -1\n") == "error: brightness must be 0 to 255\r\n");
+  HOST_CHECK(lights[1]->getBrightness() == 255);
+  HOST_CHECK(sendLine(console, stream, "bright 1 128\n") == "ok\r\n");
+  HOST_CHECK(lights[1]->getBrightness() == 128);
+  HOST_CHECK(sendLine(console, stream, "effect 1 2\n") == "error: unknown effect\r\n");
+  HOST_CHECK(sendLine(console, stream, "effect 1 1\n") == "ok\r\n");
+  HOST_CHECK(lights[1]->getOnEffect() == effects[1]);
+  HOST_CHECK(sendLine(console, stream, "state 1 dim\n") == "error: unknown state\r\n");
+  HOST_CHECK(sendLine(console, stream, "state 1 off\n") == "ok\r\n");
+  HOST_CHECK(lights[1]->getState() == LEDStaticLighting::CYCLE_OFF);
+  HOST_CHECK(sendLine(console, stream, "blink 1\n") == "error: unknown command, try help\r\n");
+
+  //a line longer than the buffer is reported once and the next line works again
+  std::string longLine = "bright 1 ";
+  longLine.append(LED_CONSOLE_LINE_LENGTH, '0');
+  longLine += "7\n";
+  HOST_CHECK(sendLine(console, stream, longLine.c_str()) == "error: line too long\r\n");
+  HOST_CHECK(lights[1]->getBrightness() == 128);
+  HOST_CHECK(sendLine(console, stream, "bright 1 64\n") == "ok\r\n");
+  HOST_CHECK(lights[1]->getBrightness() == 64);
+
+  //partial lines wait for the rest, one command is executed per call
+  HOST_CHECK(sendLine(console, stream, "bright 1 3").empty());
+  HOST_CHECK(sendLine(console, stream, "2\r\nbright 1 16\n") == "ok\r\n");
+  HOST_CHECK(lights[1]->getBrightness() == 32);
+  console.execute();
+  HOST_CHECK(stream.takeOutput() == "ok\r\n");
+  HOST_CHECK(lights[1]->getBrightness() == 16);
+
+  return hostTestResult("SerialConsoleTest");
+}
@@ -0,0 +1,158 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "HostTest.h"
+#include "Arduino.h"
+#include "HostBoard.h"
+#include "BufferStream.h"
+#include <LEDTelemetry.h>
+#include <TelemetryParser.h>
+#include <vector>
+
+/*
+  Sends the lights with LEDTelemetry into a buffer and decodes the bytes with the parser of Tools/TelemetryDecoder.
+  Checks that packets only carry changed lights, that unchanged lights are refreshed one at a time in order and
+  that packets with a wrong checksum are dropped.
+*/
+
+#define LIGHT_COUNT 20
+#define FIRST_PIN 20
+
+/**
+  @brief parser recording the order of the decoded changes
+*/
+class RecordingParser : public TelemetryParser {
+  protected:
+    void handleChange(uint64_t const, int const lightIndex, int const) {
+      changedLights.push_back(lightIndex);
+    }
+
+  public:
+    ///light indexes in the order of their changes
+    std::vector<int> changedLights;
+
+    /**
+      @brief adds all bytes of \p bytes
+
+      @param bytes received bytes
+    */
+    void addBytes(const std::string & bytes) {
+      for (std::string::size_type index = 0; index < bytes.size(); index++) {
+        addByte(bytes[index]);
+      }
+    }
+};
+
+///@return number of bytes of a packet with \p changeCount changes
+static unsigned int getPacketLength(unsigned char const changeCount) {
+  return LED_TELEMETRY_HEADER_LENGTH + 2 * changeCount + LED_TELEMETRY_TRAILER_LENGTH;
+}
+
+static void setBrightness(LEDStaticLighting * const light, unsigned char const brightness) {
+  light->setBrightness(brightness);
+  light->execute();
+}
+
+int main() {
+  HostBoard board;
+  initBoard(board, 1);
+  setCurrentBoard(&board);
+
+  LEDStaticLighting * lights[LIGHT_COUNT];
+  for (unsigned char lightIndex = 0; lightIndex < LIGHT_COUNT; lightIndex++) {
+    lights[lightIndex] = new LEDStaticLighting(FIRST_PIN + lightIndex, 0);
+    lights[lightIndex]->execute();
+  }
+
+  BufferStream stream;
+  LEDTelemetry telemetry(stream, 115200, lights, LIGHT_COUNT);
+  RecordingParser parser;
+
+  //nothing changed and the refresh time has not elapsed
+  board.timeMs = 1;
+  telemetry.execute();
+  HOST_CHECK(stream.output.empty());
+
+  //changes only: one packet with the two changed lights
+  setBrightness(lights[3], 120);
+  setBrightness(lights[7], 255);
+  board.timeMs = 2;
+  telemetry.execute();
+  std::string bytes = stream.takeOutput();
+  HOST_CHECK(bytes.size() == getPacketLength(2));
+  parser.addBytes(bytes);
+  HOST_CHECK(parser.getPacketCount() == 1);
+  HOST_CHECK(parser.getBrightness(3) == 120);
+  HOST_CHECK(parser.getBrightness(7) == 255);
+  HOST_CHECK(parser.getBrightness(0) == -1);
+  HOST_CHECK(parser.getTimeMs() == 2);
+
+  board.timeMs = 3;
+  telemetry.execute();
+  HOST_CHECK(stream.output.empty());
+
+  //refresh: one unchanged light per LED_TELEMETRY_REFRESH_MS, round robin from light 0 on
+  bool isOneLightPerPacket = true;
+  for (unsigned char refresh = 0; refresh < LIGHT_COUNT; refresh++) {
+    board.timeMs = (refresh + 1) * LED_TELEMETRY_REFRESH_MS;
+    telemetry.execute();
+    bytes = stream.takeOutput();
+    isOneLightPerPacket = isOneLightPerPacket && (bytes.size() == getPacketLength(1)) && ((unsigned char)bytes[2] == refresh);
+    parser.addBytes(bytes);
+
+    //no second refresh before the refresh time has elapsed again
+    board.timeMs += LED_TELEMETRY_REFRESH_MS / 2;
+    telemetry.execute();
+    isOneLightPerPacket = isOneLightPerPacket && stream.output.empty();
+  }
+  HOST_CHECK(isOneLightPerPacket);
+  HOST_CHECK(parser.getPacketCount() == 1 + LIGHT_COUNT);
+  HOST_CHECK(parser.getMaxLightIndex() == LIGHT_COUNT - 1);
+  //3 and 7 came first with their change, the refresh sends the others in ascending order
+  std::vector<int> expectedLights = {3, 7};
+  for (int lightIndex = 0; lightIndex < LIGHT_COUNT; lightIndex++) {
+    if ((lightIndex != 3) && (lightIndex != 7)) {
+      expectedLights.push_back(lightIndex);
+    }
+  }
+  bool isRoundRobin = (parser.changedLights == expectedLights);
+  for (int lightIndex = 0; lightIndex < LIGHT_COUNT; lightIndex++) {
+    isRoundRobin = isRoundRobin && (parser.getBrightness(lightIndex) == lights[lightIndex]->getPinBrightness());
+  }
+  HOST_CHECK(isRoundRobin);
+
+  //checksum: a corrupted packet is dropped, the next packet is decoded again
+  setBrightness(lights[5], 200);
+  board.timeMs += 1;
+  telemetry.execute();
+  bytes = stream.takeOutput();
+  HOST_CHECK(bytes.size() == getPacketLength(1));
+  bytes[3] ^= 0x10;
+  parser.addBytes(bytes);
+  HOST_CHECK(parser.getChecksumErrorCount() == 1);
+  HOST_CHECK(parser.getPacketCount() == 1 + LIGHT_COUNT);
+  HOST_CHECK(parser.getBrightness(5) == 0);
+
+  setBrightness(lights[5], 201);
+  board.timeMs += 1;
+  telemetry.execute();
+  parser.addBytes(stream.takeOutput());
+  HOST_CHECK(parser.getChecksumErrorCount() == 1);
+  HOST_CHECK(parser.getPacketCount() == 2 + LIGHT_COUNT);
+  HOST_CHECK(parser.getBrightness(5) == 201);
+
+  return hostTestResult("TelemetryTest");
+}
@@ -0,0 +1,113 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "HostTest.h"
+#include "HostBoard.h"
+#include <LEDLightingCycle.h>
+
+/*
+  Checks the shared timing ranges, the tick quantization and the switch timers of the triggered and chained cycles.
+*/
+
+//more lights with distinct ranges than the pool holds
+#define DISTINCT_LIGHT_COUNT 6
+
+static void runFor(HostBoard & board, LEDStaticLighting * const light, unsigned long const durationMs, unsigned long const stepMs = 10) {
+  const unsigned long endMs = board.timeMs + durationMs;
+  while (board.timeMs < endMs) {
+    light->execute();
+    board.timeMs += stepMs;
+  }
+}
+
+static bool isSwitchedOn(const LEDStaticLighting * const light) {
+  return light->getState() != LEDStaticLighting::CYCLE_OFF;
+}
+
+int main() {
+  HostBoard board;
+  initBoard(board, 1);
+  setCurrentBoard(&board);
+
+  //lights with equal ranges share them until one of them changes its ranges
+  LEDStaticLighting * const first = new LEDRandomLightingCycle(3, 255, 1000, 2000, 3000, 4000);
+  LEDStaticLighting * const second = new LEDRandomLightingCycle(5, 255, 1000, 2000, 3000, 4000);
+  LEDTimingRanges ranges;
+  HOST_CHECK(first->getTimingRanges(ranges));
+  HOST_CHECK(ranges.switchOnMinMs == 3000 && ranges.switchOffMaxMs == 2000);
+  const LEDTimingRanges changedRanges = {100, 200, 300, 400};
+  HOST_CHECK(first->setTimingRanges(changedRanges));
+  HOST_CHECK(first->getTimingRanges(ranges));
+  HOST_CHECK(ranges.switchOnMinMs == 100 && ranges.switchOffMaxMs == 400);
+  HOST_CHECK(second->getTimingRanges(ranges));
+  HOST_CHECK(ranges.switchOnMinMs == 3000 && ranges.switchOffMaxMs == 2000);
+
+  //ranges that do not fit into the pool any more are kept as well
+  LEDStaticLighting * distinctLights[DISTINCT_LIGHT_COUNT];
+  for (unsigned char lightIndex = 0; lightIndex < DISTINCT_LIGHT_COUNT; lightIndex++) {
+    distinctLights[lightIndex] = new LEDTriggeredCycle(LED_NO_PIN, 255, lightIndex, lightIndex + 10, lightIndex + 20, lightIndex + 30, board.pinValues[0]);
+  }
+  for (unsigned char lightIndex = 0; lightIndex < DISTINCT_LIGHT_COUNT; lightIndex++) {
+    HOST_CHECK(distinctLights[lightIndex]->getTimingRanges(ranges));
+    HOST_CHECK(ranges.switchOnMinMs == lightIndex && ranges.switchOnMaxMs == lightIndex + 10u);
+    HOST_CHECK(ranges.switchOffMinMs == lightIndex + 20u && ranges.switchOffMaxMs == lightIndex + 30u);
+  }
+  const LEDTimingRanges heapRanges = {1, 2, 3, 4};
+  HOST_CHECK(distinctLights[DISTINCT_LIGHT_COUNT - 1]->setTimingRanges(heapRanges));
+  HOST_CHECK(distinctLights[DISTINCT_LIGHT_COUNT - 1]->getTimingRanges(ranges));
+  HOST_CHECK(ranges.switchOnMinMs == 1 && ranges.switchOffMaxMs == 4);
+
+  //10 minute ranges use 64ms ticks, the switch is late by at most one tick
+  LEDStaticLighting * const office = new LEDRandomLightingCycle(6, 255, 600000, 600000, 600000, 600000);
+  office->execute();
+  HOST_CHECK(office->getState() == LEDStaticLighting::CYCLE_OFF_TO_ON);
+  const unsigned long switchOnMs = board.timeMs;
+  while (office->getState() != LEDStaticLighting::CYCLE_ON_TO_OFF) {
+    board.timeMs++;
+    office->execute();
+  }
+  HOST_CHECK(board.timeMs - switchOnMs >= 600000);
+  HOST_CHECK(board.timeMs - switchOnMs <= 600000 + 64);
+
+  //a trigger that drops before the delay has passed starts a fresh delay when it returns,
+  //even after the 16 bit tick counter has wrapped around
+  unsigned char trigger = 1;
+  LEDStaticLighting * const triggered = new LEDTriggeredCycle(9, 255, 1000, 1000, 1000, 1000, trigger);
+  runFor(board, triggered, 500);
+  HOST_CHECK(not isSwitchedOn(triggered));
+  trigger = 0;
+  runFor(board, triggered, 65536 - 20000);
+  trigger = 1;
+  runFor(board, triggered, 900);
+  HOST_CHECK(not isSwitchedOn(triggered));
+  runFor(board, triggered, 200);
+  HOST_CHECK(isSwitchedOn(triggered));
+
+  //the same for a chained cycle whose master switches off during the delay
+  LEDStaticLighting * const master = new LEDStaticLighting(10, 255, LEDStaticLighting::CYCLE_ON);
+  LEDStaticLighting * const chained = new LEDChainedCycle(11, 255, master, 1000, 1000, 60000, 60000);
+  runFor(board, chained, 500);
+  HOST_CHECK(not isSwitchedOn(chained));
+  master->setState(LEDStaticLighting::CYCLE_OFF);
+  runFor(board, chained, 65536 - 20000);
+  master->setState(LEDStaticLighting::CYCLE_ON);
+  runFor(board, chained, 900);
+  HOST_CHECK(not isSwitchedOn(chained));
+  runFor(board, chained, 200);
+  HOST_CHECK(isSwitchedOn(chained));
+
+  return hostTestResult("TimedCycleTest");
+}
@@ -0,0 +1,118 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "HostTest.h"
+#include "HostBoard.h"
+#include <LEDLightingScheduler.h>
+#include <vector>
+
+/*
+  Checks that lights run by a scheduler, which skips the time until the next update, show the same output
+  as lights executed every millisecond, and that chained cycles follow their master without polling.
+*/
+
+#define SIMULATED_MS 600000ul
+#define OUTPUT_PIN 3
+
+static LEDStaticLighting * createOfficeLight() {
+  return new LEDRandomLightingCycle(OUTPUT_PIN, 255, 2000, 8000, 2000, 8000, new LEDCyclicEffect(),
+                                    new FluorescentStartEffect(500, 4000), new FadeEffect(50, FadeEffect::FADE_OUT));
+}
+
+/**
+  @brief executes \p scheduler like the host simulator until \p endMs
+
+  @return number of passes
+*/
+static unsigned long runScheduler(HostBoard & board, LEDLightingScheduler & scheduler, unsigned long const endMs,
+                                  std::vector<unsigned char> * const pinTrace = 0) {
+  unsigned long passCount = 0;
+  while (board.timeMs < endMs) {
+    scheduler.execute();
+    passCount++;
+
+    unsigned long nextUpdateMs = scheduler.getNextUpdateMs();
+    if ((long)(nextUpdateMs - board.timeMs) <= 0) {
+      nextUpdateMs = board.timeMs + 1;
+    }
+    nextUpdateMs = (nextUpdateMs < endMs) ? nextUpdateMs : endMs;
+    if (pinTrace) {
+      pinTrace->insert(pinTrace->end(), nextUpdateMs - board.timeMs, board.pinValues[OUTPUT_PIN]);
+    }
+    board.timeMs = nextUpdateMs;
+  }
+  return passCount;
+}
+
+int main() {
+  //reference: the light executed every millisecond
+  HostBoard reference;
+  initBoard(reference, 7);
+  setCurrentBoard(&reference);
+  LEDStaticLighting * const referenceLight = createOfficeLight();
+  std::vector<unsigned char> referenceTrace;
+  unsigned long transitionMs = 0;
+  for (; reference.timeMs < SIMULATED_MS; reference.timeMs++) {
+    referenceLight->execute();
+    referenceTrace.push_back(reference.pinValues[OUTPUT_PIN]);
+    if (referenceLight->isInTransition()) {
+      transitionMs++;
+    }
+  }
+
+  //the same light with the same random numbers, executed by a scheduler
+  HostBoard scheduled;
+  initBoard(scheduled, 7);
+  setCurrentBoard(&scheduled);
+  LEDStaticLighting * scheduledLight = createOfficeLight();
+  LEDLightingScheduler officeScheduler(&scheduledLight, 1);
+  std::vector<unsigned char> scheduledTrace;
+  const unsigned long passCount = runScheduler(scheduled, officeScheduler, SIMULATED_MS, &scheduledTrace);
+
+  HOST_CHECK(scheduledTrace == referenceTrace);
+  HOST_CHECK(scheduled.pinChangeCount == reference.pinChangeCount);
+  //the fluorescent flashes and pauses are skipped
+  HOST_CHECK(transitionMs > 10000);
+  HOST_CHECK(passCount < transitionMs / 4);
+  printf("%lu ms in transitions, %lu scheduler passes\n", transitionMs, passCount);
+
+  //a chained cycle reacts to its master on the next pass
+  HostBoard board;
+  initBoard(board, 1);
+  setCurrentBoard(&board);
+  LEDStaticLighting * lights[2];
+  lights[0] = new LEDStaticLighting(5, 255, LEDStaticLighting::CYCLE_ON);
+  lights[1] = new LEDChainedCycle(6, 255, lights[0], 1000, 1000, 600000, 600000);
+  LEDLightingScheduler scheduler(lights, 2);
+  runScheduler(board, scheduler, 1100);
+  HOST_CHECK(lights[1]->isOutputActive());
+
+  //while both are steady the scheduler passes once per steady interval of each light
+  HOST_CHECK(runScheduler(board, scheduler, 61100) <= 2 * 60 + 2);
+
+  lights[0]->setState(LEDStaticLighting::CYCLE_OFF);
+  runScheduler(board, scheduler, 61103);
+  HOST_CHECK(not lights[1]->isOutputActive());
+
+  //the on delay starts again with the master, the 10 minute on time range uses 64ms ticks
+  lights[0]->setState(LEDStaticLighting::CYCLE_ON);
+  runScheduler(board, scheduler, 62100);
+  HOST_CHECK(not lights[1]->isOutputActive());
+  runScheduler(board, scheduler, 62103 + 64 + 2);
+  HOST_CHECK(lights[1]->isOutputActive());
+
+  return hostTestResult("UpdateIntervalTest");
+}
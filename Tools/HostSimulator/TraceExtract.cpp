@@ -0,0 +1,93 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "TraceReader.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+  Prints the timeline of one channel of a trace as CSV.
+
+  One row is printed for every change of the value, plus one row at the end of the range.
+*/
+
+static void printUsage(const char * const program) {
+  printf("usage: %s TRACE CHANNEL [FROM_MS [TO_MS]]\n", program);
+  printf("  CHANNEL is a channel number or CONTROLLER:LIGHT\n");
+}
+
+int main(int argc, char * argv[]) {
+  if (argc < 3) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  TraceReader reader;
+  if (not reader.open(argv[1])) {
+    fprintf(stderr, "%s is no valid trace\n", argv[1]);
+    return 1;
+  }
+  const TraceHeader & header = reader.getHeader();
+
+  uint32_t channel = strtoul(argv[2], 0, 10);
+  const char * const separator = strchr(argv[2], ':');
+  if (separator) {
+    channel = channel * header.channelsPerController + strtoul(separator + 1, 0, 10);
+  }
+  if (channel >= header.channelCount) {
+    fprintf(stderr, "channel %s is not in the trace, it has %u channels\n", argv[2], header.channelCount);
+    return 1;
+  }
+
+  const uint64_t traceEndMs = (uint64_t)header.frameCount * header.frameMs;
+  const uint64_t fromMs = (argc > 3) ? strtoull(argv[3], 0, 10) : 0;
+  uint64_t toMs = (argc > 4) ? strtoull(argv[4], 0, 10) : traceEndMs;
+  if (fromMs >= traceEndMs) {
+    fprintf(stderr, "the time range starts at %llu ms, after the end of the trace at %llu ms\n",
+            (unsigned long long)fromMs, (unsigned long long)traceEndMs);
+    return 1;
+  }
+  if (fromMs >= toMs) {
+    fprintf(stderr, "the time range from %llu ms to %llu ms is empty\n", (unsigned long long)fromMs, (unsigned long long)toMs);
+    return 1;
+  }
+  if (toMs > traceEndMs) {
+    toMs = traceEndMs;
+  }
+
+  printf("time_ms,brightness\n");
+  TraceCursor cursor(reader, channel, fromMs / header.frameMs);
+  TraceRun run;
+  int lastValue = -1;
+  while (cursor.next(run)) {
+    const uint64_t runStartMs = (uint64_t)run.firstFrame * header.frameMs;
+    if (runStartMs >= toMs) {
+      break;
+    }
+
+    //runs are split at block boundaries, only changes are printed
+    if (run.value != lastValue) {
+      printf("%llu,%u\n", (unsigned long long)((runStartMs > fromMs) ? runStartMs : fromMs), run.value);
+      lastValue = run.value;
+    }
+  }
+  if (lastValue >= 0) {
+    printf("%llu,%d\n", (unsigned long long)toMs, lastValue);
+  }
+
+  return 0;
+}
@@ -0,0 +1,136 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef TRACEFORMAT_H
+#define TRACEFORMAT_H
+
+#include <stdint.h>
+#include <string.h>
+
+/*
+  Columnar trace of the output brightness of simulated lights, one channel per light.
+
+  File layout, all numbers little endian:
+    TraceHeader
+    blocks, each covering TraceHeader::blockFrames frames of all channels:
+      uint32_t channelOffsets[channelCount + 1], relative to the end of the offset table
+      runs of channel 0, runs of channel 1, ...
+    TraceBlockEntry table with one entry per block, the sparse time index
+
+  The runs of a channel are stored as pairs of varints: the number of frames the value is held,
+  followed by the zigzag encoded change of the value. The value is 0 at the start of each block,
+  so every block can be decoded on its own.
+*/
+
+#define TRACE_MAGIC "LEDTRACE"
+#define TRACE_VERSION 1
+
+/**
+  @brief Header at the start of a trace file.
+*/
+struct TraceHeader {
+  ///TRACE_MAGIC without the terminating zero
+  char magic[8];
+  ///TRACE_VERSION
+  uint32_t version;
+  ///number of channels
+  uint32_t channelCount;
+  ///number of consecutive channels belonging to one controller
+  uint32_t channelsPerController;
+  ///simulated time between two frames in ms
+  uint32_t frameMs;
+  ///number of frames in the trace
+  uint32_t frameCount;
+  ///number of frames per block
+  uint32_t blockFrames;
+  ///number of blocks
+  uint32_t blockCount;
+  ///unused, 0
+  uint32_t reserved;
+  ///file offset of the TraceBlockEntry table
+  uint64_t blockTableOffset;
+};
+
+/**
+  @brief Entry of the block table.
+*/
+struct TraceBlockEntry {
+  ///file offset of the block
+  uint64_t offset;
+  ///first frame in the block
+  uint32_t firstFrame;
+  ///number of frames in the block
+  uint32_t frameCount;
+};
+
+/**
+  @brief One value of a channel held for a number of frames.
+*/
+struct TraceRun {
+  ///first frame of the run
+  uint32_t firstFrame;
+  ///number of frames of the run
+  uint32_t frameCount;
+  ///output brightness
+  unsigned char value;
+};
+
+/**
+  @brief appends \p value as varint
+
+  @param data buffer with at least 5 free bytes
+  @param value value to be encoded
+  @return pointer behind the encoded value
+*/
+inline unsigned char * writeTraceVarint(unsigned char * data, uint32_t value) {
+  while (value >= 0x80) {
+    *data++ = (value & 0x7F) | 0x80;
+    value >>= 7;
+  }
+  *data++ = value;
+  return data;
+}
+
+/**
+  @brief decodes a varint
+
+  @param data encoded value, advanced behind the value
+  @return decoded value
+*/
+inline uint32_t readTraceVarint(const unsigned char * & data) {
+  uint32_t value = 0;
+  unsigned char shift = 0;
+  while (*data & 0x80) {
+    value |= (uint32_t)(*data++ & 0x7F) << shift;
+    shift += 7;
+  }
+  value |= (uint32_t)(*data++) << shift;
+  return value;
+}
+
+/**
+  @brief reads a uint32_t from a possibly unaligned address
+
+  @param data address of the value
+  @return value
+*/
+inline uint32_t readTraceUint32(const unsigned char * const data) {
+  uint32_t value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+#endif
@@ -0,0 +1,178 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "TraceReader.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+TraceReader::TraceReader():
+  _file(-1),
+  _data(0),
+  _size(0)
+{
+  memset(&_header, 0, sizeof(_header));
+}
+
+TraceReader::~TraceReader() {
+  close();
+}
+
+bool TraceReader::open(const char * const path) {
+  close();
+
+  _file = ::open(path, O_RDONLY);
+  if (_file < 0) {
+    return false;
+  }
+
+  struct stat fileStatus;
+  if ((fstat(_file, &fileStatus) != 0) || ((uint64_t)fileStatus.st_size < sizeof(TraceHeader))) {
+    close();
+    return false;
+  }
+
+  void * const data = mmap(0, fileStatus.st_size, PROT_READ, MAP_SHARED, _file, 0);
+  if (data == MAP_FAILED) {
+    close();
+    return false;
+  }
+  _data = (const unsigned char *)data;
+  _size = fileStatus.st_size;
+
+  memcpy(&_header, _data, sizeof(_header));
+  const bool isValid = (memcmp(_header.magic, TRACE_MAGIC, sizeof(_header.magic)) == 0)
+                       && (_header.version == TRACE_VERSION)
+                       && (_header.blockTableOffset + (uint64_t)_header.blockCount * sizeof(TraceBlockEntry) <= _size);
+  if (not isValid) {
+    close();
+    return false;
+  }
+
+  return true;
+}
+
+void TraceReader::close() {
+  if (_data) {
+    munmap((void *)_data, _size);
+    _data = 0;
+    _size = 0;
+  }
+  if (_file >= 0) {
+    ::close(_file);
+    _file = -1;
+  }
+}
+
+const TraceHeader & TraceReader::getHeader() const {
+  return _header;
+}
+
+TraceBlockEntry TraceReader::getBlock(uint32_t const block) const {
+  TraceBlockEntry entry;
+  memcpy(&entry, _data + _header.blockTableOffset + (uint64_t)block * sizeof(TraceBlockEntry), sizeof(entry));
+  return entry;
+}
+
+uint32_t TraceReader::findBlock(uint32_t const frame) const {
+  //binary search for the last block starting at or before the frame
+  uint32_t first = 0;
+  uint32_t last = _header.blockCount;
+  while (first < last) {
+    const uint32_t middle = first + (last - first) / 2;
+    if (getBlock(middle).firstFrame <= frame) {
+      first = middle + 1;
+    }
+    else {
+      last = middle;
+    }
+  }
+
+  if (not first) {
+    return 0;
+  }
+
+  const TraceBlockEntry entry = getBlock(first - 1);
+  return (frame < entry.firstFrame + entry.frameCount) ? first - 1 : _header.blockCount;
+}
+
+const unsigned char * TraceReader::getChannelData(uint32_t const block, uint32_t const channel, const unsigned char * & end) const {
+  const unsigned char * const table = _data + getBlock(block).offset;
+  const unsigned char * const data = table + (uint64_t)(_header.channelCount + 1) * sizeof(uint32_t);
+
+  end = data + readTraceUint32(table + (channel + 1) * sizeof(uint32_t));
+  return data + readTraceUint32(table + channel * sizeof(uint32_t));
+}
+
+TraceCursor::TraceCursor(const TraceReader & reader, uint32_t const channel, uint32_t const frame):
+  _reader(reader),
+  _channel(channel),
+  _block(0),
+  _data(0),
+  _end(0),
+  _frame(0),
+  _value(0)
+{
+  enterBlock(_reader.findBlock(frame));
+
+  //skip the runs ending before the frame
+  while (_data < _end) {
+    const unsigned char * const runStart = _data;
+    const uint32_t frameCount = readTraceVarint(_data);
+    const uint32_t zigzag = readTraceVarint(_data);
+    const unsigned char value = _value + (unsigned char)((zigzag >> 1) ^ -(zigzag & 1));
+
+    if (_frame + frameCount > frame) {
+      _data = runStart;
+      break;
+    }
+    _frame += frameCount;
+    _value = value;
+  }
+}
+
+void TraceCursor::enterBlock(uint32_t const block) {
+  _block = block;
+  _value = 0;
+  if (_block >= _reader.getHeader().blockCount) {
+    _data = 0;
+    _end = 0;
+    return;
+  }
+
+  _frame = _reader.getBlock(_block).firstFrame;
+  _data = _reader.getChannelData(_block, _channel, _end);
+}
+
+bool TraceCursor::next(TraceRun & run) {
+  while (_data >= _end) {
+    if (_block >= _reader.getHeader().blockCount) {
+      return false;
+    }
+    enterBlock(_block + 1);
+  }
+
+  const uint32_t frameCount = readTraceVarint(_data);
+  const uint32_t zigzag = readTraceVarint(_data);
+  _value += (unsigned char)((zigzag >> 1) ^ -(zigzag & 1));
+
+  run.firstFrame = _frame;
+  run.frameCount = frameCount;
+  run.value = _value;
+  _frame += frameCount;
+  return true;
+}
@@ -0,0 +1,138 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef TRACEREADER_H
+#define TRACEREADER_H
+
+#include "TraceFormat.h"
+
+/**
+  @brief Reads a columnar trace by mapping the whole file.
+
+  The runs are decoded directly from the mapped file, nothing is copied. Use a TraceCursor to
+  read the runs of one channel from any frame on.
+*/
+class TraceReader {
+  private:
+    ///file descriptor or -1
+    int _file;
+    ///mapped file
+    const unsigned char * _data;
+    ///size of the file in bytes
+    uint64_t _size;
+    ///header of the file
+    TraceHeader _header;
+
+  public:
+    TraceReader();
+    ~TraceReader();
+
+    /**
+      @brief maps a trace file
+
+      @param path file name
+      @return false if the file could not be mapped or is no valid trace
+    */
+    bool open(const char * const path);
+
+    /**
+      @brief unmaps the file
+    */
+    void close();
+
+    /**
+      @brief returns the header of the file
+
+      @return header
+    */
+    const TraceHeader & getHeader() const;
+
+    /**
+      @brief returns the block containing \p frame
+
+      @param frame frame number
+      @return block index, the block count if the frame is after the end of the trace
+    */
+    uint32_t findBlock(uint32_t const frame) const;
+
+    /**
+      @brief returns the block table entry of a block
+
+      @param block block index
+      @return block table entry
+    */
+    TraceBlockEntry getBlock(uint32_t const block) const;
+
+    /**
+      @brief returns the encoded runs of a channel in a block
+
+      @param block block index
+      @param channel channel index
+      @param end receives the end of the runs
+      @return start of the runs
+    */
+    const unsigned char * getChannelData(uint32_t const block, uint32_t const channel, const unsigned char * & end) const;
+};
+
+/**
+  @brief Iterates over the runs of one channel.
+
+  Runs are not merged across blocks, so two consecutive runs can have the same value.
+*/
+class TraceCursor {
+  private:
+    ///trace being read
+    const TraceReader & _reader;
+    ///channel being read
+    const uint32_t _channel;
+    ///current block
+    uint32_t _block;
+    ///next run in the current block
+    const unsigned char * _data;
+    ///end of the runs in the current block
+    const unsigned char * _end;
+    ///first frame of the next run
+    uint32_t _frame;
+    ///value of the previous run
+    unsigned char _value;
+
+    /**
+      @brief moves to the start of a block
+
+      @param block block index
+    */
+    void enterBlock(uint32_t const block);
+
+  public:
+    /**
+      @brief creates a cursor positioned at the run containing \p frame
+
+      @param reader trace to be read
+      @param channel channel index
+      @param frame first frame of interest
+    */
+    TraceCursor(const TraceReader & reader, uint32_t const channel, uint32_t const frame = 0);
+
+    /**
+      @brief reads the next run
+
+      @param run receives the run
+      @return false at the end of the trace
+    */
+    bool next(TraceRun & run);
+};
+
+#endif
@@ -0,0 +1,217 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "TraceWriter.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+///the mapping is grown in steps of at least this size
+#define TRACE_GROW_BYTES (16ul << 20)
+///maximum size of one encoded run
+#define TRACE_MAX_RUN_BYTES 10
+
+TraceWriter::TraceWriter():
+  _file(-1),
+  _data(0),
+  _capacity(0),
+  _size(0),
+  _blockFrameCount(0)
+{
+  memset(&_header, 0, sizeof(_header));
+}
+
+TraceWriter::~TraceWriter() {
+  close();
+}
+
+bool TraceWriter::open(const char * const path, uint32_t const channelCount, uint32_t const channelsPerController, uint32_t const frameMs, uint32_t const blockFrames) {
+  close();
+
+  _file = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (_file < 0) {
+    return false;
+  }
+
+  memset(&_header, 0, sizeof(_header));
+  memcpy(_header.magic, TRACE_MAGIC, sizeof(_header.magic));
+  _header.version = TRACE_VERSION;
+  _header.channelCount = channelCount;
+  _header.channelsPerController = channelsPerController;
+  _header.frameMs = frameMs;
+  _header.blockFrames = blockFrames ? blockFrames : 1;
+
+  _blocks.clear();
+  _runValues.assign(channelCount, 0);
+  _runFrames.assign(channelCount, 0);
+  _encodedValues.assign(channelCount, 0);
+  _channelData.assign(channelCount, std::vector<unsigned char>());
+  _blockFrameCount = 0;
+  _size = 0;
+
+  //the header is written again on close
+  return append(&_header, sizeof(_header));
+}
+
+bool TraceWriter::reserve(uint64_t const size) {
+  if (_size + size <= _capacity) {
+    return true;
+  }
+
+  uint64_t capacity = _capacity + TRACE_GROW_BYTES;
+  if (capacity < _size + size) {
+    capacity = _size + size + TRACE_GROW_BYTES;
+  }
+
+  if (_data) {
+    munmap(_data, _capacity);
+    _data = 0;
+    _capacity = 0;
+  }
+  if (ftruncate(_file, capacity) != 0) {
+    return false;
+  }
+
+  void * const data = mmap(0, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, _file, 0);
+  if (data == MAP_FAILED) {
+    return false;
+  }
+
+  _data = (unsigned char *)data;
+  _capacity = capacity;
+  return true;
+}
+
+bool TraceWriter::append(const void * const data, uint64_t const size) {
+  if (not reserve(size)) {
+    return false;
+  }
+
+  memcpy(_data + _size, data, size);
+  _size += size;
+  return true;
+}
+
+void TraceWriter::encodeRun(uint32_t const channel) {
+  if (not _runFrames[channel]) {
+    return;
+  }
+
+  //zigzag encoding keeps small decreases small
+  const int32_t delta = (int32_t)_runValues[channel] - (int32_t)_encodedValues[channel];
+  const uint32_t zigzag = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+
+  unsigned char run[TRACE_MAX_RUN_BYTES];
+  unsigned char * end = writeTraceVarint(run, _runFrames[channel]);
+  end = writeTraceVarint(end, zigzag);
+  _channelData[channel].insert(_channelData[channel].end(), run, end);
+
+  _encodedValues[channel] = _runValues[channel];
+  _runFrames[channel] = 0;
+}
+
+bool TraceWriter::addFrame(const unsigned char * const values) {
+  for (uint32_t channel = 0; channel < _header.channelCount; channel++) {
+    if ((values[channel] != _runValues[channel]) && _runFrames[channel]) {
+      encodeRun(channel);
+    }
+    _runValues[channel] = values[channel];
+    _runFrames[channel]++;
+  }
+
+  _header.frameCount++;
+  if (++_blockFrameCount >= _header.blockFrames) {
+    return writeBlock();
+  }
+
+  return true;
+}
+
+bool TraceWriter::writeBlock() {
+  if (not _blockFrameCount) {
+    return true;
+  }
+
+  const uint32_t channelCount = _header.channelCount;
+  uint32_t dataSize = 0;
+  for (uint32_t channel = 0; channel < channelCount; channel++) {
+    encodeRun(channel);
+    dataSize += _channelData[channel].size();
+  }
+
+  const uint64_t tableSize = (uint64_t)(channelCount + 1) * sizeof(uint32_t);
+  if (not reserve(tableSize + dataSize)) {
+    return false;
+  }
+
+  TraceBlockEntry entry;
+  entry.offset = _size;
+  entry.firstFrame = _header.frameCount - _blockFrameCount;
+  entry.frameCount = _blockFrameCount;
+  _blocks.push_back(entry);
+
+  //offset table and channel data are copied straight into the mapping
+  unsigned char * const table = _data + _size;
+  unsigned char * data = table + tableSize;
+  uint32_t offset = 0;
+  for (uint32_t channel = 0; channel < channelCount; channel++) {
+    memcpy(table + channel * sizeof(uint32_t), &offset, sizeof(offset));
+    memcpy(data, _channelData[channel].data(), _channelData[channel].size());
+    data += _channelData[channel].size();
+    offset += _channelData[channel].size();
+
+    _channelData[channel].clear();
+    _encodedValues[channel] = 0;
+  }
+  memcpy(table + channelCount * sizeof(uint32_t), &offset, sizeof(offset));
+
+  _size += tableSize + dataSize;
+  _blockFrameCount = 0;
+  return true;
+}
+
+bool TraceWriter::close() {
+  if (_file < 0) {
+    return true;
+  }
+
+  bool isWritten = writeBlock();
+  if (isWritten) {
+    _header.blockCount = _blocks.size();
+    _header.blockTableOffset = _size;
+    isWritten = append(_blocks.data(), _blocks.size() * sizeof(TraceBlockEntry));
+  }
+  if (isWritten) {
+    memcpy(_data, &_header, sizeof(_header));
+  }
+
+  if (_data) {
+    munmap(_data, _capacity);
+    _data = 0;
+    _capacity = 0;
+  }
+  //drop the unused part of the last growth step
+  if (ftruncate(_file, _size) != 0) {
+    isWritten = false;
+  }
+  ::close(_file);
+  _file = -1;
+  return isWritten;
+}
+
+uint64_t TraceWriter::getSize() const {
+  return _size;
+}
@@ -0,0 +1,125 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef TRACEWRITER_H
+#define TRACEWRITER_H
+
+#include "TraceFormat.h"
+#include <vector>
+
+/**
+  @brief Writes a columnar trace through a memory mapped file.
+
+  The frames of a block are collected as runs per channel. When a block is complete, its runs are
+  encoded and copied into the mapped file, which is grown in large steps. Memory use only depends on
+  the number of channels and the block length, not on the length of the trace.
+*/
+class TraceWriter {
+  private:
+    ///file descriptor or -1
+    int _file;
+    ///mapped file
+    unsigned char * _data;
+    ///mapped size in bytes
+    uint64_t _capacity;
+    ///bytes written
+    uint64_t _size;
+    ///header written on close
+    TraceHeader _header;
+    ///block table written on close
+    std::vector<TraceBlockEntry> _blocks;
+    ///value of the current run of each channel
+    std::vector<unsigned char> _runValues;
+    ///length of the current run of each channel
+    std::vector<uint32_t> _runFrames;
+    ///last value written to the block for each channel
+    std::vector<unsigned char> _encodedValues;
+    ///encoded runs of the current block for each channel
+    std::vector<std::vector<unsigned char> > _channelData;
+    ///frames in the current block
+    uint32_t _blockFrameCount;
+
+    /**
+      @brief makes sure that \p size bytes can be written
+
+      @param size number of bytes to be written
+      @return false if the file could not be grown
+    */
+    bool reserve(uint64_t const size);
+
+    /**
+      @brief appends \p size bytes to the file
+
+      @param data bytes to be written
+      @param size number of bytes
+      @return false if the file could not be grown
+    */
+    bool append(const void * const data, uint64_t const size);
+
+    /**
+      @brief ends the current run of a channel
+
+      @param channel channel index
+    */
+    void encodeRun(uint32_t const channel);
+
+    /**
+      @brief writes the current block to the file
+
+      @return false if the file could not be grown
+    */
+    bool writeBlock();
+
+  public:
+    TraceWriter();
+    ~TraceWriter();
+
+    /**
+      @brief creates a trace file
+
+      @param path file name
+      @param channelCount number of channels
+      @param channelsPerController number of consecutive channels of one controller
+      @param frameMs simulated time between two frames in ms
+      @param blockFrames number of frames per block, the granularity of the time index
+      @return false if the file could not be created
+    */
+    bool open(const char * const path, uint32_t const channelCount, uint32_t const channelsPerController, uint32_t const frameMs, uint32_t const blockFrames = 3600);
+
+    /**
+      @brief adds one frame
+
+      @param values one value per channel
+      @return false if the file could not be grown
+    */
+    bool addFrame(const unsigned char * const values);
+
+    /**
+      @brief writes the last block, the block table and the header and closes the file
+
+      @return false if writing failed
+    */
+    bool close();
+
+    /**
+      @brief returns the number of bytes written so far
+
+      @return file size in bytes
+    */
+    uint64_t getSize() const;
+};
+
+#endif
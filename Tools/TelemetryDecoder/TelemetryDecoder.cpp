@@ -0,0 +1,160 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "TelemetryParser.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+/*
+  Decodes the packets of LEDTelemetry from a serial port, a pseudo terminal or a recorded file.
+
+  Every change is printed as CSV row, with --live a table of all lights is redrawn instead.
+*/
+
+/**
+  @brief prints the decoded values as CSV rows or as live table
+*/
+class TelemetryPrinter : public TelemetryParser {
+  private:
+    ///true to redraw a table of all lights after every packet instead of printing CSV rows
+    const bool _isLive;
+
+  protected:
+    void handleChange(uint64_t const timeMs, int const lightIndex, int const brightness) {
+      if (not _isLive) {
+        printf("%llu,%d,%d\n", (unsigned long long)timeMs, lightIndex, brightness);
+      }
+    }
+
+    void handlePacket() {
+      if (not _isLive) {
+        return;
+      }
+
+      printf("\r%10llu ms |", (unsigned long long)getTimeMs());
+      for (int lightIndex = 0; lightIndex <= getMaxLightIndex(); lightIndex++) {
+        if (getBrightness(lightIndex) < 0) {
+          printf("   ?");
+        }
+        else {
+          printf(" %3d", getBrightness(lightIndex));
+        }
+      }
+      fflush(stdout);
+    }
+
+  public:
+    TelemetryPrinter(bool const isLive):
+      _isLive(isLive)
+    {}
+};
+
+static void printUsage(const char * const program) {
+  printf("usage: %s [--baud N] [--live] INPUT\n", program);
+  printf("  INPUT is a serial port, a pseudo terminal or a recorded file\n");
+}
+
+static speed_t getSpeed(const unsigned long baudRate) {
+  switch (baudRate) {
+    case 9600: return B9600;
+    case 19200: return B19200;
+    case 38400: return B38400;
+    case 57600: return B57600;
+    case 230400: return B230400;
+    case 460800: return B460800;
+    case 500000: return B500000;
+    case 1000000: return B1000000;
+    default: return B115200;
+  }
+}
+
+int main(int argc, char * argv[]) {
+  unsigned long baudRate = 115200;
+  const char * inputName = 0;
+  bool isLive = false;
+
+  for (int argIndex = 1; argIndex < argc; argIndex++) {
+    if (not strcmp(argv[argIndex], "--baud") && ((argIndex + 1) < argc)) {
+      baudRate = strtoul(argv[++argIndex], 0, 10);
+    }
+    else if (not strcmp(argv[argIndex], "--live")) {
+      isLive = true;
+    }
+    else if (argv[argIndex][0] != '-') {
+      inputName = argv[argIndex];
+    }
+    else {
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+  if (not inputName) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  const int input = open(inputName, O_RDONLY | O_NOCTTY);
+  if (input < 0) {
+    fprintf(stderr, "can not open %s: %s\n", inputName, strerror(errno));
+    return 1;
+  }
+
+  if (isatty(input)) {
+    //serial ports and pseudo terminals need to pass the bytes unchanged
+    struct termios settings;
+    tcgetattr(input, &settings);
+    cfmakeraw(&settings);
+    cfsetispeed(&settings, getSpeed(baudRate));
+    cfsetospeed(&settings, getSpeed(baudRate));
+    settings.c_cc[VMIN] = 1;
+    settings.c_cc[VTIME] = 0;
+    tcsetattr(input, TCSANOW, &settings);
+  }
+
+  if (not isLive) {
+    printf("time_ms,light,brightness\n");
+  }
+
+  TelemetryPrinter printer(isLive);
+  uint8_t buffer[4096];
+  while (true) {
+    const ssize_t readCount = read(input, buffer, sizeof(buffer));
+    if (readCount < 0 && (errno == EINTR)) {
+      continue;
+    }
+    if (readCount <= 0) {
+      //end of file, or EIO when the other side of a pseudo terminal has been closed
+      break;
+    }
+    for (ssize_t index = 0; index < readCount; index++) {
+      printer.addByte(buffer[index]);
+    }
+  }
+  close(input);
+
+  if (isLive) {
+    printf("\n");
+  }
+  fprintf(stderr, "%llu packets, %llu checksum errors, %llu bytes skipped\n", (unsigned long long)printer.getPacketCount(),
+          (unsigned long long)printer.getChecksumErrorCount(), (unsigned long long)printer.getSkippedByteCount());
+  return 0;
+}
@@ -0,0 +1,140 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "TelemetryParser.h"
+#include <string.h>
+
+TelemetryParser::TelemetryParser():
+  _length(0),
+  _maxLightIndex(-1),
+  _timeMs(0),
+  _lastPacketTime(0),
+  _hasTime(false),
+  _packetCount(0),
+  _checksumErrorCount(0),
+  _skippedByteCount(0)
+{
+  for (int lightIndex = 0; lightIndex < TELEMETRY_MAX_LIGHTS; lightIndex++) {
+    _brightness[lightIndex] = -1;
+  }
+}
+
+TelemetryParser::~TelemetryParser() {}
+
+void TelemetryParser::handleChange(uint64_t const, int const, int const) {}
+
+void TelemetryParser::handlePacket() {}
+
+void TelemetryParser::decodePacket() {
+  const unsigned int changeCount = _packet[1];
+  const uint8_t * const trailer = &_packet[LED_TELEMETRY_HEADER_LENGTH + 2 * changeCount];
+  const uint16_t packetTime = trailer[0] | (trailer[1] << 8);
+
+  if (_hasTime) {
+    //the board sends 16 bits of millis(), packets are much less than 65 s apart
+    _timeMs += (uint16_t)(packetTime - _lastPacketTime);
+  }
+  else {
+    _timeMs = packetTime;
+    _hasTime = true;
+  }
+  _lastPacketTime = packetTime;
+  _packetCount++;
+
+  for (unsigned int change = 0; change < changeCount; change++) {
+    const int lightIndex = _packet[LED_TELEMETRY_HEADER_LENGTH + 2 * change];
+    const int brightness = _packet[LED_TELEMETRY_HEADER_LENGTH + 2 * change + 1];
+    if (lightIndex > _maxLightIndex) {
+      _maxLightIndex = lightIndex;
+    }
+    if (brightness != _brightness[lightIndex]) {
+      _brightness[lightIndex] = brightness;
+      handleChange(_timeMs, lightIndex, brightness);
+    }
+  }
+
+  handlePacket();
+}
+
+void TelemetryParser::resync() {
+  unsigned int start = 1;
+  while ((start < _length) && (_packet[start] != LED_TELEMETRY_SYNC)) {
+    start++;
+  }
+  _skippedByteCount += start;
+  _length -= start;
+  memmove(_packet, &_packet[start], _length);
+}
+
+void TelemetryParser::addByte(uint8_t const value) {
+  if (not _length && (value != LED_TELEMETRY_SYNC)) {
+    _skippedByteCount++;
+    return;
+  }
+  _packet[_length++] = value;
+
+  //the loop handles bytes left over after a resync
+  while (_length >= LED_TELEMETRY_HEADER_LENGTH) {
+    const unsigned int changeCount = _packet[1];
+    if (not changeCount || (changeCount > LED_TELEMETRY_MAX_CHANGES)) {
+      resync();
+      continue;
+    }
+
+    const unsigned int packetLength = LED_TELEMETRY_HEADER_LENGTH + 2 * changeCount + LED_TELEMETRY_TRAILER_LENGTH;
+    if (_length < packetLength) {
+      return;
+    }
+
+    uint8_t checksum = 0;
+    for (unsigned int index = 1; index < (packetLength - 1); index++) {
+      checksum += _packet[index];
+    }
+    if (checksum != _packet[packetLength - 1]) {
+      _checksumErrorCount++;
+      resync();
+      continue;
+    }
+
+    decodePacket();
+    _length -= packetLength;
+    memmove(_packet, &_packet[packetLength], _length);
+  }
+}
+
+int TelemetryParser::getBrightness(int const lightIndex) const {
+  return _brightness[lightIndex];
+}
+
+int TelemetryParser::getMaxLightIndex() const {
+  return _maxLightIndex;
+}
+
+uint64_t TelemetryParser::getTimeMs() const {
+  return _timeMs;
+}
+
+uint64_t TelemetryParser::getPacketCount() const {
+  return _packetCount;
+}
+
+uint64_t TelemetryParser::getChecksumErrorCount() const {
+  return _checksumErrorCount;
+}
+
+uint64_t TelemetryParser::getSkippedByteCount() const {
+  return _skippedByteCount;
+}
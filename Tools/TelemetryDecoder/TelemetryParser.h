@@ -0,0 +1,115 @@
+/*
+    This file is part of LEDModelLighting.
+
+    LEDModelLighting is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    LEDModelLighting is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef TELEMETRYPARSER_H
+#define TELEMETRYPARSER_H
+
+#include "LEDTelemetry.h"
+#include <stdint.h>
+
+///maximum number of lights of a sketch, the light index is one byte
+#define TELEMETRY_MAX_LIGHTS 256
+
+/**
+  @brief Splits the bytes sent by LEDTelemetry into packets and keeps the brightness of all lights.
+
+  Packets with a wrong checksum are dropped and the parser searches for the next sync byte.
+  Derived classes override #handleChange() and #handlePacket() to show the decoded values.
+*/
+class TelemetryParser {
+  private:
+    ///bytes of the current packet
+    uint8_t _packet[LED_TELEMETRY_MAX_PACKET_LENGTH];
+    ///number of bytes in #_packet
+    unsigned int _length;
+    ///last known brightness of each light, -1 until the first value has been received
+    int _brightness[TELEMETRY_MAX_LIGHTS];
+    ///highest light index seen so far, -1 before the first packet
+    int _maxLightIndex;
+    ///time of the last packet with the 16 bit time of the board unwrapped
+    uint64_t _timeMs;
+    ///16 bit time of the last packet
+    uint16_t _lastPacketTime;
+    ///true after the first packet
+    bool _hasTime;
+    ///number of decoded packets
+    uint64_t _packetCount;
+    ///number of packets dropped because of a wrong checksum
+    uint64_t _checksumErrorCount;
+    ///number of bytes skipped while searching for a sync byte
+    uint64_t _skippedByteCount;
+
+    /**
+      @brief decodes the complete packet at the start of #_packet, its checksum has been checked
+    */
+    void decodePacket();
+
+    /**
+      @brief drops the first byte of the current packet and searches the next sync byte in the rest
+    */
+    void resync();
+
+  protected:
+    /**
+      @brief called for each light whose brightness differs from the last known value
+
+      @param timeMs time of the packet in ms
+      @param lightIndex index of the light
+      @param brightness new pin brightness
+    */
+    virtual void handleChange(uint64_t const timeMs, int const lightIndex, int const brightness);
+
+    /**
+      @brief called after a packet has been decoded
+    */
+    virtual void handlePacket();
+
+  public:
+    TelemetryParser();
+    virtual ~TelemetryParser();
+
+    /**
+      @brief adds a received byte, complete packets are decoded right away
+
+      @param value received byte
+    */
+    void addByte(uint8_t const value);
+
+    /**
+      @brief returns the last known brightness of a light
+
+      @param lightIndex index of the light
+      @return brightness, -1 if no value has been received yet
+    */
+    int getBrightness(int const lightIndex) const;
+
+    ///@return highest light index seen so far, -1 before the first packet
+    int getMaxLightIndex() const;
+
+    ///@return time of the last packet in ms, counted from the first packet
+    uint64_t getTimeMs() const;
+
+    ///@return number of decoded packets
+    uint64_t getPacketCount() const;
+
+    ///@return number of packets dropped because of a wrong checksum
+    uint64_t getChecksumErrorCount() const;
+
+    ///@return number of bytes skipped while searching for a sync byte
+    uint64_t getSkippedByteCount() const;
+};
+
+#endif
@@ -0,0 +1,77 @@
+#!/bin/sh
+#
+#    This file is part of LEDModelLighting.
+#
+#    LEDModelLighting is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    LEDModelLighting is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with LEDModelLighting.  If not, see <https://www.gnu.org/licenses/>.
+#
+# Builds the AVR_Benchmark firmware and the Yard_Office example with arduino-cli,
+# runs the benchmark in simavr and prints a markdown table with the cycle counts
+# and the flash and SRAM use. Everything runs locally, no board is needed.
+#
+# Requirements: arduino-cli with the arduino:avr core, avr-size and simavr in PATH.
+#
+# Usage: Tools/avr_report.sh [output file]
+
+set -e
+
+FQBN=${FQBN:-arduino:avr:uno}
+MCU=${MCU:-atmega328p}
+F_CPU=${F_CPU:-16000000}
+SIM_TIMEOUT=${SIM_TIMEOUT:-120}
+
+REPO_DIR=$(cd "$(dirname "$0")/.." && pwd)
+BUILD_DIR=${BUILD_DIR:-$REPO_DIR/_avr_build}
+OUTPUT=${1:-/dev/stdout}
+
+build_sketch() {
+  arduino-cli compile --fqbn "$FQBN" --library "$REPO_DIR" \
+    --output-dir "$BUILD_DIR/$2" "$REPO_DIR/$1" > "$BUILD_DIR/$2.log"
+}
+
+section_size() {
+  #prints the size of the sections given as arguments 2 and following of the elf file $1
+  elf=$1
+  shift
+  avr-size -A "$elf" | awk -v sections="$*" '
+    BEGIN { split(sections, names, " ") }
+    { for (i in names) if ($1 == names[i]) total += $2 }
+    END { print total + 0 }'
+}
+
+mkdir -p "$BUILD_DIR"
+build_sketch Tools/AVR_Benchmark AVR_Benchmark
+build_sketch Examples/Yard_Office Yard_Office
+
+YARD_ELF="$BUILD_DIR/Yard_Office/Yard_Office.ino.elf"
+BENCH_ELF="$BUILD_DIR/AVR_Benchmark/AVR_Benchmark.ino.elf"
+
+#simavr prints the UART output with color codes
+BENCH_OUTPUT=$(timeout "$SIM_TIMEOUT" simavr -m "$MCU" -f "$F_CPU" "$BENCH_ELF" 2>&1 \
+  | sed 's/\x1b\[[0-9;]*m//g' || true)
+YARD_HEAP=$(echo "$BENCH_OUTPUT" | sed -n 's/^heap bytes: \([0-9]*\).*/\1/p')
+
+{
+  echo "## Cycles per call ($MCU @ $F_CPU Hz)"
+  echo
+  echo "$BENCH_OUTPUT" | grep '^|' || true
+  echo
+  echo "## Memory use"
+  echo
+  echo "Static SRAM is .data, .bss and .noinit, heap is the lights and effects allocated in setup() as measured by the benchmark."
+  echo
+  echo "| Sketch | Flash bytes | Static SRAM bytes | Heap bytes |"
+  echo "|---|---|---|---|"
+  echo "| Yard_Office | $(section_size "$YARD_ELF" .text .data) | $(section_size "$YARD_ELF" .data .bss .noinit) | ${YARD_HEAP:-?} |"
+  echo "| AVR_Benchmark | $(section_size "$BENCH_ELF" .text .data) | $(section_size "$BENCH_ELF" .data .bss .noinit) | |"
+} > "$OUTPUT"